@@ -0,0 +1,21 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeAnalyticHoleSubsystem.h"
+
+#include "IVSmokeRayMarchPipeline.h"
+
+bool UIVSmokeAnalyticHoleSubsystem::TryReserve(const int32 NumHoles)
+{
+	if (NumReservedHoles + NumHoles > static_cast<int32>(FIVSmokeOccupancyConfig::MaxAnalyticHoles))
+	{
+		return false;
+	}
+
+	NumReservedHoles += NumHoles;
+	return true;
+}
+
+void UIVSmokeAnalyticHoleSubsystem::Release(const int32 NumHoles)
+{
+	NumReservedHoles = FMath::Max(NumReservedHoles - NumHoles, 0);
+}
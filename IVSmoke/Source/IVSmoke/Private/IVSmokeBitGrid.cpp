@@ -0,0 +1,236 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeBitGrid.h"
+
+#include "Math/VectorRegister.h"
+#include "Misc/Crc.h"
+
+namespace IVSmokeBitGrid
+{
+	/** Applies Op to two rows at a time through a 128-bit register, then finishes the remainder per word. */
+	template <typename VectorOpType, typename ScalarOpType>
+	static FORCEINLINE void ApplyBinary(TArrayView<uint64> Dest, TConstArrayView<uint64> Other, VectorOpType&& VectorOp, ScalarOpType&& ScalarOp)
+	{
+		check(Dest.Num() == Other.Num());
+
+		const int32 Num = Dest.Num();
+		const int32 VectorNum = Num & ~1;
+
+		uint64* DestData = Dest.GetData();
+		const uint64* OtherData = Other.GetData();
+
+		for (int32 i = 0; i < VectorNum; i += 2)
+		{
+			const VectorRegister4Int A = VectorIntLoad(DestData + i);
+			const VectorRegister4Int B = VectorIntLoad(OtherData + i);
+			VectorIntStore(VectorOp(A, B), DestData + i);
+		}
+
+		for (int32 i = VectorNum; i < Num; ++i)
+		{
+			DestData[i] = ScalarOp(DestData[i], OtherData[i]);
+		}
+	}
+}
+
+//~==============================================================================
+// Rows
+#pragma region Rows
+
+bool FIVSmokeBitGrid::IsBoxFull(TConstArrayView<uint64> Bits, int32 ResolutionY, uint64 Mask, int32 Y, int32 Height, int32 Z, int32 Depth)
+{
+	for (int32 D = 0; D < Depth; ++D)
+	{
+		const uint64* Row = Bits.GetData() + Y + (Z + D) * ResolutionY;
+		for (int32 H = 0; H < Height; ++H)
+		{
+			if ((Row[H] & Mask) != Mask)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void FIVSmokeBitGrid::ClearBox(TArrayView<uint64> Bits, int32 ResolutionY, uint64 Mask, int32 Y, int32 Height, int32 Z, int32 Depth)
+{
+	const uint64 KeepMask = ~Mask;
+	for (int32 D = 0; D < Depth; ++D)
+	{
+		uint64* Row = Bits.GetData() + Y + (Z + D) * ResolutionY;
+		for (int32 H = 0; H < Height; ++H)
+		{
+			Row[H] &= KeepMask;
+		}
+	}
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Segments
+#pragma region Segments
+
+bool FIVSmokeBitGrid::FindSetSpan(TConstArrayView<uint64> Bits, const FIntVector& Resolution, const FVector& P0, const FVector& P1, float& OutEnterT, float& OutExitT)
+{
+	bool bFound = false;
+	TraverseSegment(Resolution, P0, P1, [&](const FIntVector& Voxel, float TEnter, float TExit)
+	{
+		if (IsBitSet(Bits, Voxel, Resolution.Y))
+		{
+			OutEnterT = bFound ? OutEnterT : TEnter;
+			OutExitT = TExit;
+			bFound = true;
+		}
+		return true;
+	});
+	return bFound;
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Whole Grid
+#pragma region WholeGrid
+
+int32 FIVSmokeBitGrid::CountSetBits(TConstArrayView<uint64> Bits)
+{
+	// The vector API has no popcount, so each row is counted with one hardware popcount of 64 voxels.
+	// Independent accumulators keep the counts from serializing on a single register
+	int32 Counts[4] = { 0, 0, 0, 0 };
+
+	const int32 Num = Bits.Num();
+	const int32 UnrolledNum = Num & ~3;
+	for (int32 i = 0; i < UnrolledNum; i += 4)
+	{
+		Counts[0] += static_cast<int32>(FPlatformMath::CountBits(Bits[i]));
+		Counts[1] += static_cast<int32>(FPlatformMath::CountBits(Bits[i + 1]));
+		Counts[2] += static_cast<int32>(FPlatformMath::CountBits(Bits[i + 2]));
+		Counts[3] += static_cast<int32>(FPlatformMath::CountBits(Bits[i + 3]));
+	}
+
+	for (int32 i = UnrolledNum; i < Num; ++i)
+	{
+		Counts[0] += static_cast<int32>(FPlatformMath::CountBits(Bits[i]));
+	}
+
+	return Counts[0] + Counts[1] + Counts[2] + Counts[3];
+}
+
+void FIVSmokeBitGrid::And(TArrayView<uint64> Dest, TConstArrayView<uint64> Other)
+{
+	IVSmokeBitGrid::ApplyBinary(Dest, Other,
+		[](const VectorRegister4Int& A, const VectorRegister4Int& B) { return VectorIntAnd(A, B); },
+		[](uint64 A, uint64 B) { return A & B; });
+}
+
+void FIVSmokeBitGrid::Or(TArrayView<uint64> Dest, TConstArrayView<uint64> Other)
+{
+	IVSmokeBitGrid::ApplyBinary(Dest, Other,
+		[](const VectorRegister4Int& A, const VectorRegister4Int& B) { return VectorIntOr(A, B); },
+		[](uint64 A, uint64 B) { return A | B; });
+}
+
+void FIVSmokeBitGrid::AndNot(TArrayView<uint64> Dest, TConstArrayView<uint64> Other)
+{
+	// VectorIntAndNot(A, B) = ~A & B
+	IVSmokeBitGrid::ApplyBinary(Dest, Other,
+		[](const VectorRegister4Int& A, const VectorRegister4Int& B) { return VectorIntAndNot(B, A); },
+		[](uint64 A, uint64 B) { return A & ~B; });
+}
+
+void FIVSmokeBitGrid::Erode(TConstArrayView<uint64> Source, TArrayView<uint64> Dest, const FIntVector& Resolution)
+{
+	check(Source.Num() == Dest.Num() && Source.GetData() != Dest.GetData());
+
+	const int32 Num = Source.Num();
+	const int32 ResolutionY = Resolution.Y;
+	const uint64 RowMask = GetRowMask(Resolution.X);
+
+	// 1. X neighbours. Shifting in zeros treats X = -1 and X = Resolution.X as empty
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const uint64 Row = Source[i] & RowMask;
+		Dest[i] = Row & (Row << 1) & (Row >> 1);
+	}
+
+	// 2. Z neighbours: the grid shifted by one slice is contiguous, so it is ANDed in two rows per register.
+	// The first and last slices border empty space
+	const int32 ShiftedNum = Num - ResolutionY;
+	if (ShiftedNum > 0)
+	{
+		And(Dest.Slice(ResolutionY, ShiftedNum), Source.Slice(0, ShiftedNum));
+		And(Dest.Slice(0, ShiftedNum), Source.Slice(ResolutionY, ShiftedNum));
+	}
+	FMemory::Memzero(Dest.GetData(), FMath::Min(ResolutionY, Num) * sizeof(uint64));
+	FMemory::Memzero(Dest.GetData() + FMath::Max(ShiftedNum, 0), FMath::Min(ResolutionY, Num) * sizeof(uint64));
+
+	// 3. Y neighbours: the same within each slice, whose first and last rows border empty space
+	for (int32 Z = 0; Z < Resolution.Z; ++Z)
+	{
+		const int32 Base = Z * ResolutionY;
+		if (ResolutionY > 1)
+		{
+			And(Dest.Slice(Base + 1, ResolutionY - 1), Source.Slice(Base, ResolutionY - 1));
+			And(Dest.Slice(Base, ResolutionY - 1), Source.Slice(Base + 1, ResolutionY - 1));
+		}
+		Dest[Base] = 0;
+		Dest[Base + ResolutionY - 1] = 0;
+	}
+}
+
+void FIVSmokeBitGrid::ExtractSurface(TConstArrayView<uint64> Source, TArrayView<uint64> Dest, const FIntVector& Resolution)
+{
+	Erode(Source, Dest, Resolution);
+
+	// Dest = Source & ~Dest. VectorIntAndNot(A, B) = ~A & B
+	IVSmokeBitGrid::ApplyBinary(Dest, Source,
+		[](const VectorRegister4Int& A, const VectorRegister4Int& B) { return VectorIntAndNot(A, B); },
+		[](uint64 A, uint64 B) { return ~A & B; });
+}
+
+bool FIVSmokeBitGrid::CalculateBounds(TConstArrayView<uint64> Bits, const FIntVector& Resolution, FIntVector& OutMin, FIntVector& OutMax)
+{
+	uint64 UnionRow = 0;
+	OutMin = FIntVector(MAX_int32);
+	OutMax = FIntVector(MIN_int32);
+
+	for (int32 Z = 0; Z < Resolution.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Resolution.Y; ++Y)
+		{
+			const uint64 Row = Bits[Y + Z * Resolution.Y];
+			if (Row == 0)
+			{
+				continue;
+			}
+
+			UnionRow |= Row;
+			OutMin.Y = FMath::Min(OutMin.Y, Y);
+			OutMax.Y = FMath::Max(OutMax.Y, Y);
+			OutMin.Z = FMath::Min(OutMin.Z, Z);
+			OutMax.Z = FMath::Max(OutMax.Z, Z);
+		}
+	}
+
+	if (UnionRow == 0)
+	{
+		return false;
+	}
+
+	OutMin.X = static_cast<int32>(FMath::CountTrailingZeros64(UnionRow));
+	OutMax.X = 63 - static_cast<int32>(FMath::CountLeadingZeros64(UnionRow));
+	return true;
+}
+
+uint32 FIVSmokeBitGrid::CalculateChecksum(TConstArrayView<uint64> Bits, uint32 Crc)
+{
+	if (Bits.IsEmpty())
+	{
+		return Crc;
+	}
+	return FCrc::MemCrc32(Bits.GetData(), Bits.Num() * sizeof(uint64), Crc);
+}
+
+#pragma endregion
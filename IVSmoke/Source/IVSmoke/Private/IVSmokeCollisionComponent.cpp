@@ -2,8 +2,12 @@
 
 #include "IVSmokeCollisionComponent.h"
 
+#include "EngineUtils.h"
 #include "IVSmoke.h"
 #include "IVSmokeGridLibrary.h"
+#include "IVSmokeHoleData.h"
+#include "IVSmokeHoleGeneratorComponent.h"
+#include "IVSmokeVoxelVolume.h"
 #include "PhysicsEngine/BodySetup.h"
 
 DECLARE_CYCLE_STAT(TEXT("Update Collision"), STAT_IVSmoke_UpdateCollision, STATGROUP_IVSmoke)
@@ -51,7 +55,7 @@ void UIVSmokeCollisionComponent::OnCreatePhysicsState()
 	Super::OnCreatePhysicsState();
 }
 
-void UIVSmokeCollisionComponent::TryUpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, int32 ActiveVoxelNum, float SyncTime, bool bForce)
+void UIVSmokeCollisionComponent::TryUpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, int32 ActiveVoxelNum, float SyncTime, bool bForce, const FIVSmokeHoleArray* ActiveHoles)
 {
 	if (GetCollisionEnabled() == ECollisionEnabled::NoCollision)
 	{
@@ -62,25 +66,48 @@ void UIVSmokeCollisionComponent::TryUpdateCollision(const TArray<uint64>& VoxelB
 		return;
 	}
 
-	if (!bForce)
+	if (!bSubtractHoles)
 	{
-		if (LastSyncTime > 0.0f && (SyncTime - LastSyncTime) < MinCollisionUpdateInterval)
-		{
-			return;
-		}
+		ActiveHoles = nullptr;
+	}
+
+	if (!bForce && LastSyncTime > 0.0f && (SyncTime - LastSyncTime) < MinCollisionUpdateInterval)
+	{
+		return;
+	}
 
+	// Hashing walks every hole, so it only runs once the interval allows an update
+	const uint32 HoleSignature = ActiveHoles ? CalculateHoleSignature(*ActiveHoles) : 0;
+
+	if (!bForce)
+	{
 		int32 Diff = FMath::Abs(ActiveVoxelNum - LastActiveVoxelNum);
 
-		if (Diff < MinCollisionUpdateVoxelNum)
+		if (Diff < MinCollisionUpdateVoxelNum && HoleSignature == LastHoleSignature)
 		{
 			return;
 		}
 	}
 
-	UpdateCollision(VoxelBitArray, GridResolution, VoxelSize);
+	UpdateCollision(VoxelBitArray, GridResolution, VoxelSize, ActiveHoles, SyncTime);
 
 	LastSyncTime = SyncTime;
 	LastActiveVoxelNum = ActiveVoxelNum;
+	LastHoleSignature = HoleSignature;
+}
+
+uint32 UIVSmokeCollisionComponent::CalculateHoleSignature(const FIVSmokeHoleArray& ActiveHoles)
+{
+	uint32 Signature = 0;
+	for (int32 i = 0; i < ActiveHoles.Num(); ++i)
+	{
+		const FIVSmokeHoleData& Hole = ActiveHoles[i];
+		Signature = HashCombineFast(Signature, GetTypeHash(Hole.Position));
+		Signature = HashCombineFast(Signature, GetTypeHash(Hole.EndPosition));
+		Signature = HashCombineFast(Signature, GetTypeHash(Hole.ExpirationServerTime));
+		Signature = HashCombineFast(Signature, Hole.PresetID);
+	}
+	return Signature;
 }
 
 #pragma endregion
@@ -89,116 +116,67 @@ void UIVSmokeCollisionComponent::TryUpdateCollision(const TArray<uint64>& VoxelB
 // Collision Management
 #pragma region Collision
 
-void UIVSmokeCollisionComponent::UpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize)
+void UIVSmokeCollisionComponent::UpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, const FIVSmokeHoleArray* ActiveHoles, float SyncTime)
 {
 	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_UpdateCollision);
 
 	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT("IVSmoke::UIVSmokeCollisionComponent::UpdateCollision");
 
-	UBodySetup* BodySetup = GetBodySetup();
-	if (!BodySetup)
+	if (!GetBodySetup())
 	{
 		return;
 	}
 
-	BodySetup->AggGeom.EmptyElements();
-
-	TArray<uint64> TempVoxelBitArray = VoxelBitArray;
-
-	const int32 ResolutionY = GridResolution.Y;
-	const int32 ResolutionZ = GridResolution.Z;
+	RebuildBoxElems(VoxelBitArray, GridResolution, VoxelSize, ActiveHoles, SyncTime);
 
-	const FIntVector CenterOffset = GridResolution / 2;
+	FinalizePhysicsUpdate();
+}
 
-	const float VoxelExtent = VoxelSize * 0.5f;
+void UIVSmokeCollisionComponent::RebuildBoxElems(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, const FIVSmokeHoleArray* ActiveHoles, float SyncTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT("IVSmoke::UIVSmokeCollisionComponent::RebuildBoxElems");
 
-	for (int32 Z = 0; Z < ResolutionZ; ++Z)
+	UBodySetup* BodySetup = GetBodySetup();
+	if (!BodySetup)
 	{
-		for (int32 Y = 0; Y < ResolutionY; ++Y)
-		{
-			const int32 Index = UIVSmokeGridLibrary::GridToVoxelBitIndex(Y, Z, ResolutionY);
-
-			uint64& CurrentRow = TempVoxelBitArray[Index];
-			while (CurrentRow)
-			{
-				const int32 BeginX = FMath::CountTrailingZeros64(CurrentRow);
-
-				const uint64 Shifted = CurrentRow >> BeginX;
+		return;
+	}
 
-				const int32 Width = (Shifted == MAX_uint64) ? (64 - BeginX) : FMath::CountTrailingZeros64(~Shifted);
+	// 1. Copy into persistent scratch storage (the mesher consumes its input)
+	ScratchVoxelBits.SetNumUninitialized(VoxelBitArray.Num(), EAllowShrinking::No);
+	FMemory::Memcpy(ScratchVoxelBits.GetData(), VoxelBitArray.GetData(), VoxelBitArray.Num() * sizeof(uint64));
 
-				const uint64 Mask = (Width == 64) ? MAX_uint64 : ((1ULL << Width) - 1ULL) << BeginX;
+	if (ActiveHoles && ActiveHoles->Num() > 0)
+	{
+		HoleOccupancy.Build(*ActiveHoles, SyncTime);
+		HoleOccupancy.MaskVoxelBits(ScratchVoxelBits, GridResolution, VoxelSize, GetComponentTransform());
+	}
 
-				int32 Height = 1;
-				for (int32 NextY = Y + 1; NextY < ResolutionY; ++NextY)
-				{
-					const int32 NextIndex = UIVSmokeGridLibrary::GridToVoxelBitIndex(NextY, Z, ResolutionY);
-
-					const uint64& NextRow = TempVoxelBitArray[NextIndex];
-					if ((NextRow & Mask) == Mask)
-					{
-						++Height;
-					}
-					else
-					{
-						break;
-					}
-				}
+	// 2. Mesh into the reused box list
+	ScratchVoxelBoxes.Reset();
+	FIVSmokeCollisionMesher::BuildBoxes(ScratchVoxelBits, GridResolution, MeshingStrategy, ScratchVoxelBoxes);
 
-				int32 Depth = 1;
-				for (int32 NextZ = Z + 1; NextZ < ResolutionZ; ++NextZ)
-				{
-					bool bCanExpand = true;
-					for (int32 H = 0; H < Height; ++H)
-					{
-						const int32 NextIndex = UIVSmokeGridLibrary::GridToVoxelBitIndex(Y + H, NextZ, ResolutionY);
-
-						const uint64& NextRow = TempVoxelBitArray[NextIndex];
-						if ((NextRow & Mask) != Mask)
-						{
-							bCanExpand = false;
-							break;
-						}
-					}
-
-					if (bCanExpand)
-					{
-						++Depth;
-					}
-					else
-					{
-						break;
-					}
-				}
+	// 3. Refill BoxElems in place. Reset keeps the capacity of the previous rebuild.
+	TArray<FKBoxElem>& BoxElems = BodySetup->AggGeom.BoxElems;
+	BoxElems.Reset(ScratchVoxelBoxes.Num());
 
-				for (int32 D = 0; D < Depth; ++D)
-				{
-					for (int32 H = 0; H < Height; ++H)
-					{
-						const int32 NextIndex = UIVSmokeGridLibrary::GridToVoxelBitIndex(Y + H, Z + D, ResolutionY);
-
-						TempVoxelBitArray[NextIndex] &= ~Mask;
-					}
-				}
+	const FIntVector CenterOffset = GridResolution / 2;
 
-				FKBoxElem Box;
+	const float VoxelExtent = VoxelSize * 0.5f;
 
-				FIntVector BeginGridPos(BeginX, Y, Z);
-				FVector BeginVoxelCenter = UIVSmokeGridLibrary::GridToLocal(BeginGridPos, VoxelSize, CenterOffset);
-				FVector CenterShift((Width - 1) * VoxelExtent, (Height - 1) * VoxelExtent, (Depth - 1) * VoxelExtent);
-				Box.Center = BeginVoxelCenter + CenterShift;
+	for (const FIVSmokeVoxelBox& VoxelBox : ScratchVoxelBoxes)
+	{
+		FKBoxElem& Box = BoxElems.AddDefaulted_GetRef();
 
-				Box.X = Width * VoxelSize;
-				Box.Y = Height * VoxelSize;
-				Box.Z = Depth * VoxelSize;
-				Box.Rotation = FRotator::ZeroRotator;
+		FVector BeginVoxelCenter = UIVSmokeGridLibrary::GridToLocal(VoxelBox.Min, VoxelSize, CenterOffset);
+		FVector CenterShift((VoxelBox.Size.X - 1) * VoxelExtent, (VoxelBox.Size.Y - 1) * VoxelExtent, (VoxelBox.Size.Z - 1) * VoxelExtent);
+		Box.Center = BeginVoxelCenter + CenterShift;
 
-				BodySetup->AggGeom.BoxElems.Add(Box);
-			}
-		}
+		Box.X = VoxelBox.Size.X * VoxelSize;
+		Box.Y = VoxelBox.Size.Y * VoxelSize;
+		Box.Z = VoxelBox.Size.Z * VoxelSize;
+		Box.Rotation = FRotator::ZeroRotator;
 	}
-
-	FinalizePhysicsUpdate();
 }
 
 void UIVSmokeCollisionComponent::ResetCollision()
@@ -280,3 +258,142 @@ void UIVSmokeCollisionComponent::DrawDebugVisualization() const
 }
 
 #pragma endregion
+
+//~==============================================================================
+// Allocation Check
+#pragma region AllocationCheck
+
+#if !UE_BUILD_SHIPPING
+namespace IVSmokeCollisionCVars
+{
+	/**
+	 * Forwarding allocator that counts allocations made by a single thread.
+	 * Installed over GMalloc only for the duration of the measurement. Never destroyed, so threads
+	 * that picked up the pointer before it was uninstalled can still forward safely.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		void Begin(uint32 InThreadId)
+		{
+			ThreadId = InThreadId;
+			AllocationNum = 0;
+		}
+
+		int32 GetAllocationNum() const { return AllocationNum; }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			RecordAllocation();
+			return Inner->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			RecordAllocation();
+			return Inner->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			RecordAllocation();
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			RecordAllocation();
+			return Inner->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void RecordAllocation()
+		{
+			if (FPlatformTLS::GetCurrentThreadId() == ThreadId)
+			{
+				++AllocationNum;
+			}
+		}
+
+		FMalloc* Inner;
+		uint32 ThreadId = 0;
+		int32 AllocationNum = 0;
+	};
+
+	static FAutoConsoleCommandWithWorldAndArgs Cmd_Collision_VerifyNoAlloc(
+		TEXT("IVSmoke.Collision.VerifyNoAlloc"),
+		TEXT("Rebuilds the collision boxes of every active smoke volume and reports heap allocations made by the rebuild after warm-up.\nUsage: IVSmoke.Collision.VerifyNoAlloc [Iterations]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (!World)
+			{
+				return;
+			}
+
+			const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+			static FCountingMalloc* CountingMalloc = nullptr;
+			if (!CountingMalloc)
+			{
+				CountingMalloc = new FCountingMalloc(GMalloc);
+			}
+
+			int32 VolumeNum = 0;
+			int32 FailedNum = 0;
+
+			for (TActorIterator<AIVSmokeVoxelVolume> Iter(World); Iter; ++Iter)
+			{
+				AIVSmokeVoxelVolume* Volume = *Iter;
+				UIVSmokeCollisionComponent* Collision = Volume ? Volume->GetCollisionComponent().Get() : nullptr;
+				if (!Collision || !Collision->GetBodySetup() || Volume->GetActiveVoxelNum() <= 0)
+				{
+					continue;
+				}
+
+				const UIVSmokeHoleGeneratorComponent* HoleGenerator = Volume->GetHoleGeneratorComponent();
+				const FIVSmokeHoleArray* ActiveHoles = (Collision->bSubtractHoles && HoleGenerator) ? &HoleGenerator->GetActiveHoles() : nullptr;
+				const float SyncTime = Volume->GetSyncWorldTimeSeconds();
+
+				// Keep the committed geometry so debug drawing stays in sync with the physics state
+				const TArray<FKBoxElem> SavedBoxElems = Collision->GetBodySetup()->AggGeom.BoxElems;
+
+				// Warm-up grows every scratch buffer to fit this grid
+				Collision->RebuildBoxElems(Volume->GetVoxelBits(), Volume->GetGridResolution(), Volume->GetVoxelSize(), ActiveHoles, SyncTime);
+
+				CountingMalloc->Begin(FPlatformTLS::GetCurrentThreadId());
+				FMalloc* PreviousMalloc = GMalloc;
+				GMalloc = CountingMalloc;
+
+				for (int32 i = 0; i < Iterations; ++i)
+				{
+					Collision->RebuildBoxElems(Volume->GetVoxelBits(), Volume->GetGridResolution(), Volume->GetVoxelSize(), ActiveHoles, SyncTime);
+				}
+
+				GMalloc = PreviousMalloc;
+				const int32 AllocationNum = CountingMalloc->GetAllocationNum();
+
+				Collision->GetBodySetup()->AggGeom.BoxElems = SavedBoxElems;
+
+				++VolumeNum;
+				FailedNum += AllocationNum > 0 ? 1 : 0;
+
+				UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Collision] %s: %d allocation(s) over %d rebuild(s) - %s"),
+					*Volume->GetName(), AllocationNum, Iterations, AllocationNum == 0 ? TEXT("PASS") : TEXT("FAIL"));
+			}
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Collision] VerifyNoAlloc: %d volume(s), %d failed"), VolumeNum, FailedNum);
+		})
+	);
+}
+#endif
+
+#pragma endregion
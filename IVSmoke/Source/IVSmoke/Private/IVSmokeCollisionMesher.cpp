@@ -0,0 +1,263 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeCollisionMesher.h"
+
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "IVSmoke.h"
+#include "IVSmokeBitGrid.h"
+#include "IVSmokeVoxelVolume.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace IVSmokeCollisionMesher
+{
+	/** Grows Height first (with Depth = 1), then Depth with the resulting Height. */
+	static void GrowYThenZ(const TArray<uint64>& Bits, uint64 Mask, int32 Y, int32 Z, const FIntVector& GridResolution, int32& OutHeight, int32& OutDepth)
+	{
+		OutHeight = 1;
+		while (Y + OutHeight < GridResolution.Y && FIVSmokeBitGrid::IsBoxFull(Bits, GridResolution.Y, Mask, Y + OutHeight, 1, Z, 1))
+		{
+			++OutHeight;
+		}
+
+		OutDepth = 1;
+		while (Z + OutDepth < GridResolution.Z && FIVSmokeBitGrid::IsBoxFull(Bits, GridResolution.Y, Mask, Y, OutHeight, Z + OutDepth, 1))
+		{
+			++OutDepth;
+		}
+	}
+
+	/** Grows Depth first (with Height = 1), then Height with the resulting Depth. */
+	static void GrowZThenY(const TArray<uint64>& Bits, uint64 Mask, int32 Y, int32 Z, const FIntVector& GridResolution, int32& OutHeight, int32& OutDepth)
+	{
+		OutDepth = 1;
+		while (Z + OutDepth < GridResolution.Z && FIVSmokeBitGrid::IsBoxFull(Bits, GridResolution.Y, Mask, Y, 1, Z + OutDepth, 1))
+		{
+			++OutDepth;
+		}
+
+		OutHeight = 1;
+		while (Y + OutHeight < GridResolution.Y && FIVSmokeBitGrid::IsBoxFull(Bits, GridResolution.Y, Mask, Y + OutHeight, 1, Z, OutDepth))
+		{
+			++OutHeight;
+		}
+	}
+}
+
+void FIVSmokeCollisionMesher::BuildBoxes(TArray<uint64>& ScratchBits, const FIntVector& GridResolution, EIVSmokeCollisionMeshingStrategy Strategy, TArray<FIVSmokeVoxelBox>& OutBoxes)
+{
+	using namespace IVSmokeCollisionMesher;
+
+	const int32 ResolutionY = GridResolution.Y;
+	const int32 ResolutionZ = GridResolution.Z;
+
+	if (ScratchBits.Num() < ResolutionY * ResolutionZ)
+	{
+		return;
+	}
+
+	// Rows are read as the iteration reaches them, so runs already covered by a box grown from an earlier row are skipped
+	FIVSmokeBitGrid::ForEachRowRun(ScratchBits, GridResolution, [&](int32 Y, int32 Z, int32 BeginX, int32 Width)
+	{
+		const uint64 Mask = FIVSmokeBitGrid::GetRunMask(BeginX, Width);
+
+		int32 Height = 1;
+		int32 Depth = 1;
+		GrowYThenZ(ScratchBits, Mask, Y, Z, GridResolution, Height, Depth);
+
+		if (Strategy == EIVSmokeCollisionMeshingStrategy::BestAxisOrder)
+		{
+			int32 AltHeight = 1;
+			int32 AltDepth = 1;
+			GrowZThenY(ScratchBits, Mask, Y, Z, GridResolution, AltHeight, AltDepth);
+
+			if (AltHeight * AltDepth > Height * Depth)
+			{
+				Height = AltHeight;
+				Depth = AltDepth;
+			}
+		}
+
+		FIVSmokeBitGrid::ClearBox(ScratchBits, ResolutionY, Mask, Y, Height, Z, Depth);
+
+		FIVSmokeVoxelBox& Box = OutBoxes.AddDefaulted_GetRef();
+		Box.Min = FIntVector(BeginX, Y, Z);
+		Box.Size = FIntVector(Width, Height, Depth);
+	});
+}
+
+//~==============================================================================
+// Offline Benchmark
+#pragma region Benchmark
+
+namespace IVSmokeCollisionMesherCVars
+{
+	/** File signature of a recorded VoxelBits snapshot ("IVSB"). */
+	static constexpr uint32 SnapshotMagic = 0x42535649;
+
+	static constexpr int32 SnapshotVersion = 1;
+
+	static FString GetSnapshotDir()
+	{
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("IVSmoke"), TEXT("CollisionSnapshots"));
+	}
+
+	struct FSnapshot
+	{
+		FString Name;
+		FIntVector GridResolution;
+		TArray<uint64> VoxelBits;
+	};
+
+	static bool LoadSnapshot(const FString& Path, FSnapshot& OutSnapshot)
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *Path))
+		{
+			return false;
+		}
+
+		FMemoryReader Reader(Bytes);
+
+		uint32 Magic = 0;
+		int32 Version = 0;
+		Reader << Magic << Version;
+
+		if (Magic != SnapshotMagic || Version != SnapshotVersion)
+		{
+			return false;
+		}
+
+		Reader << OutSnapshot.GridResolution << OutSnapshot.VoxelBits;
+
+		OutSnapshot.Name = FPaths::GetBaseFilename(Path);
+
+		return !Reader.IsError() && OutSnapshot.VoxelBits.Num() == OutSnapshot.GridResolution.Y * OutSnapshot.GridResolution.Z;
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs Cmd_Collision_RecordSnapshots(
+		TEXT("IVSmoke.Collision.RecordSnapshots"),
+		TEXT("Saves the current VoxelBits of every active smoke volume to Saved/IVSmoke/CollisionSnapshots.\nUsage: IVSmoke.Collision.RecordSnapshots"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+		{
+			if (!World)
+			{
+				return;
+			}
+
+			const FString Timestamp = FDateTime::Now().ToString(TEXT("%Y%m%d_%H%M%S"));
+			int32 SavedCount = 0;
+
+			for (TActorIterator<AIVSmokeVoxelVolume> Iter(World); Iter; ++Iter)
+			{
+				AIVSmokeVoxelVolume* Volume = *Iter;
+				if (!Volume || Volume->GetActiveVoxelNum() <= 0)
+				{
+					continue;
+				}
+
+				FIntVector GridResolution = Volume->GetGridResolution();
+				TArray<uint64> VoxelBits = Volume->GetVoxelBits();
+
+				TArray<uint8> Bytes;
+				FMemoryWriter Writer(Bytes);
+
+				uint32 Magic = SnapshotMagic;
+				int32 Version = SnapshotVersion;
+				Writer << Magic << Version << GridResolution << VoxelBits;
+
+				const FString Path = FPaths::Combine(GetSnapshotDir(), FString::Printf(TEXT("%s_%s.ivsbits"), *Volume->GetName(), *Timestamp));
+				if (FFileHelper::SaveArrayToFile(Bytes, *Path))
+				{
+					++SavedCount;
+				}
+			}
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Collision] Recorded %d snapshot(s) to %s"), SavedCount, *GetSnapshotDir());
+		})
+	);
+
+	static FAutoConsoleCommand Cmd_Collision_Benchmark(
+		TEXT("IVSmoke.Collision.Benchmark"),
+		TEXT("Runs every meshing strategy over the recorded VoxelBits snapshots and reports box count and build time.\nUsage: IVSmoke.Collision.Benchmark [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Iterations = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 20;
+
+			TArray<FString> Files;
+			IFileManager::Get().FindFiles(Files, *FPaths::Combine(GetSnapshotDir(), TEXT("*.ivsbits")), true, false);
+
+			TArray<FSnapshot> Snapshots;
+			for (const FString& File : Files)
+			{
+				FSnapshot Snapshot;
+				if (LoadSnapshot(FPaths::Combine(GetSnapshotDir(), File), Snapshot))
+				{
+					Snapshots.Add(MoveTemp(Snapshot));
+				}
+				else
+				{
+					UE_LOG(LogIVSmoke, Warning, TEXT("[IVSmoke.Collision] Skipping invalid snapshot: %s"), *File);
+				}
+			}
+
+			if (Snapshots.IsEmpty())
+			{
+				UE_LOG(LogIVSmoke, Warning, TEXT("[IVSmoke.Collision] No snapshots found in %s. Use IVSmoke.Collision.RecordSnapshots first."), *GetSnapshotDir());
+				return;
+			}
+
+			const EIVSmokeCollisionMeshingStrategy Strategies[] = {
+				EIVSmokeCollisionMeshingStrategy::GreedyXYZ,
+				EIVSmokeCollisionMeshingStrategy::BestAxisOrder
+			};
+
+			int64 TotalBoxes[UE_ARRAY_COUNT(Strategies)] = {};
+			double TotalSeconds[UE_ARRAY_COUNT(Strategies)] = {};
+
+			TArray<uint64> ScratchBits;
+			TArray<FIVSmokeVoxelBox> Boxes;
+
+			for (const FSnapshot& Snapshot : Snapshots)
+			{
+				FString Line = FString::Printf(TEXT("  %s:"), *Snapshot.Name);
+
+				for (int32 s = 0; s < UE_ARRAY_COUNT(Strategies); ++s)
+				{
+					double Seconds = 0.0;
+					for (int32 i = 0; i < Iterations; ++i)
+					{
+						ScratchBits = Snapshot.VoxelBits;
+						Boxes.Reset();
+
+						const double BeginTime = FPlatformTime::Seconds();
+						FIVSmokeCollisionMesher::BuildBoxes(ScratchBits, Snapshot.GridResolution, Strategies[s], Boxes);
+						Seconds += FPlatformTime::Seconds() - BeginTime;
+					}
+
+					TotalBoxes[s] += Boxes.Num();
+					TotalSeconds[s] += Seconds / Iterations;
+
+					Line += FString::Printf(TEXT(" %s=%d boxes / %.3f ms"),
+						*UEnum::GetValueAsString(Strategies[s]), Boxes.Num(), Seconds / Iterations * 1000.0);
+				}
+
+				UE_LOG(LogIVSmoke, Log, TEXT("%s"), *Line);
+			}
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Collision] Benchmark over %d snapshot(s), %d iteration(s):"), Snapshots.Num(), Iterations);
+			for (int32 s = 0; s < UE_ARRAY_COUNT(Strategies); ++s)
+			{
+				const double Reduction = TotalBoxes[0] > 0 ? (1.0 - static_cast<double>(TotalBoxes[s]) / TotalBoxes[0]) * 100.0 : 0.0;
+				UE_LOG(LogIVSmoke, Log, TEXT("  %s: %lld boxes (%.1f%% fewer than GreedyXYZ), %.3f ms total"),
+					*UEnum::GetValueAsString(Strategies[s]), TotalBoxes[s], Reduction, TotalSeconds[s] * 1000.0);
+			}
+		})
+	);
+}
+
+#pragma endregion
@@ -0,0 +1,155 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeCurveAtlas.h"
+
+#include "Curves/CurveFloat.h"
+#include "IVSmoke.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+#include "UObject/UObjectGlobals.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Curve Atlas Uploads"), STAT_IVSmoke_CurveAtlasUploads, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Curve Atlas Bakes"), STAT_IVSmoke_CurveAtlasBakes, STATGROUP_IVSmoke);
+
+namespace IVSmokeCurveAtlas
+{
+	/** Atlas buffer kept on the render thread between frames. */
+	class FAtlasBuffer : public FRenderResource
+	{
+	public:
+		TRefCountPtr<FRDGPooledBuffer> Buffer;
+
+		/** Atlas version of Buffer. 0 if nothing was uploaded. */
+		uint32 Version = 0;
+
+		virtual void ReleaseRHI() override
+		{
+			Buffer.SafeRelease();
+			Version = 0;
+		}
+	};
+
+	static TGlobalResource<FAtlasBuffer> GAtlasBuffer;
+}
+
+FIVSmokeCurveAtlas::FIVSmokeCurveAtlas()
+{
+	Samples.SetNumZeroed(NumBuiltInRows * SamplesPerRow);
+	BakeRow(LinearRow, [](const float X) { return X; });
+	BakeRow(InverseLinearRow, [](const float X) { return 1.0f - X; });
+	BakeRow(SquareRootRow, [](const float X) { return FMath::Sqrt(X); });
+	BakeRow(InverseSquareRootRow, [](const float X) { return 1.0f - FMath::Sqrt(X); });
+
+#if WITH_EDITOR
+	// Curve assets edited in the editor are baked again; the atlas lives as long as the process
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([this](UObject* Object, FPropertyChangedEvent&)
+	{
+		if (const UCurveFloat* Curve = Cast<UCurveFloat>(Object))
+		{
+			RebakeCurve(Curve);
+		}
+	});
+#endif
+}
+
+FIVSmokeCurveAtlas& FIVSmokeCurveAtlas::Get()
+{
+	static FIVSmokeCurveAtlas Atlas;
+	return Atlas;
+}
+
+int32 FIVSmokeCurveAtlas::FindOrAddCurve(const UCurveFloat* Curve, const int32 DefaultRow)
+{
+	check(IsInGameThread());
+
+	if (!Curve)
+	{
+		return DefaultRow;
+	}
+
+	if (const int32* Row = CurveRows.Find(FObjectKey(Curve)))
+	{
+		return *Row;
+	}
+
+	const int32 Row = Samples.Num() / SamplesPerRow;
+	Samples.AddUninitialized(SamplesPerRow);
+	CurveRows.Add(FObjectKey(Curve), Row);
+	BakeRow(Row, [Curve](const float X) { return Curve->GetFloatValue(X); });
+	return Row;
+}
+
+void FIVSmokeCurveAtlas::RebakeCurve(const UCurveFloat* Curve)
+{
+	check(IsInGameThread());
+
+	if (const int32* Row = CurveRows.Find(FObjectKey(Curve)))
+	{
+		BakeRow(*Row, [Curve](const float X) { return Curve->GetFloatValue(X); });
+	}
+}
+
+float FIVSmokeCurveAtlas::Evaluate(const int32 Row, const float X) const
+{
+	const int32 SafeRow = (Row >= 0 && (Row + 1) * SamplesPerRow <= Samples.Num()) ? Row : LinearRow;
+	const float* RowSamples = Samples.GetData() + SafeRow * SamplesPerRow;
+
+	// Same lerp as SampleCurveAtlas in IVSmokeCommon.ush
+	const float Position = FMath::Clamp(X, 0.0f, 1.0f) * (SamplesPerRow - 1);
+	const int32 Index = FMath::Min(FMath::FloorToInt32(Position), SamplesPerRow - 2);
+	return FMath::Lerp(RowSamples[Index], RowSamples[Index + 1], Position - Index);
+}
+
+void FIVSmokeCurveAtlas::BakeRow(const int32 Row, TFunctionRef<float(float)> Function)
+{
+	INC_DWORD_STAT(STAT_IVSmoke_CurveAtlasBakes);
+
+	float* RowSamples = Samples.GetData() + Row * SamplesPerRow;
+	for (int32 i = 0; i < SamplesPerRow; ++i)
+	{
+		RowSamples[i] = Function(static_cast<float>(i) / (SamplesPerRow - 1));
+	}
+	++Version;
+}
+
+FIVSmokeCurveAtlas::FSnapshotRef FIVSmokeCurveAtlas::GetSnapshot()
+{
+	check(IsInGameThread());
+
+	if (!Snapshot.IsValid() || Snapshot->Version != Version)
+	{
+		TSharedRef<FIVSmokeCurveAtlasSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FIVSmokeCurveAtlasSnapshot, ESPMode::ThreadSafe>();
+		NewSnapshot->Samples = Samples;
+		NewSnapshot->Version = Version;
+		Snapshot = NewSnapshot;
+	}
+
+	return Snapshot.ToSharedRef();
+}
+
+FRDGBufferRef FIVSmokeCurveAtlas::RegisterBuffer(FRDGBuilder& GraphBuilder, const FIVSmokeCurveAtlasSnapshot& InSnapshot)
+{
+	check(IsInRenderingThread());
+
+	IVSmokeCurveAtlas::FAtlasBuffer& AtlasBuffer = IVSmokeCurveAtlas::GAtlasBuffer;
+	if (AtlasBuffer.Buffer.IsValid() && AtlasBuffer.Version == InSnapshot.Version)
+	{
+		return GraphBuilder.RegisterExternalBuffer(AtlasBuffer.Buffer);
+	}
+
+	INC_DWORD_STAT(STAT_IVSmoke_CurveAtlasUploads);
+
+	const FRDGBufferRef Buffer = CreateStructuredBuffer(
+		GraphBuilder,
+		TEXT("IVSmokeCurveAtlas"),
+		sizeof(float),
+		InSnapshot.Samples.Num(),
+		InSnapshot.Samples.GetData(),
+		sizeof(float) * InSnapshot.Samples.Num()
+	);
+
+	AtlasBuffer.Buffer = GraphBuilder.ConvertToExternalBuffer(Buffer);
+	AtlasBuffer.Version = InSnapshot.Version;
+	return Buffer;
+}
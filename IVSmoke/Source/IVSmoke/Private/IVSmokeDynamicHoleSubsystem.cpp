@@ -0,0 +1,242 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeDynamicHoleSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+#include "IVSmoke.h"
+#include "IVSmokeHoleGeneratorComponent.h"
+#include "IVSmokeHolePreset.h"
+
+DECLARE_CYCLE_STAT(TEXT("Update Dynamic Hole Subjects"), STAT_IVSmoke_UpdateDynamicHoleSubjects, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Dynamic Hole Bindings"), STAT_IVSmoke_ActiveDynamicHoleBindings, STATGROUP_IVSmoke);
+
+//~==============================================================================
+// Tick
+#pragma region Tick
+
+void UIVSmokeDynamicHoleSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_UpdateDynamicHoleSubjects);
+
+	for (int32 i = Subjects.Num() - 1; i >= 0; --i)
+	{
+		FIVSmokeHoleDynamicSubject& Subject = Subjects[i];
+
+		// 0. Delete if object is not alive
+		const AActor* Actor = Subject.TargetActor.Get();
+		if (!Actor || Subject.Bindings.IsEmpty())
+		{
+			RemoveSubjectAt(i);
+			continue;
+		}
+
+		// 1. Outside every smoke costs nothing but the check above
+		if (Subject.NumActiveBindings == 0)
+		{
+			continue;
+		}
+
+		INC_DWORD_STAT_BY(STAT_IVSmoke_ActiveDynamicHoleBindings, Subject.NumActiveBindings);
+
+		const FVector3f CurrentPos = FVector3f(Actor->GetActorLocation());
+
+		for (int32 b = Subject.NumActiveBindings - 1; b >= 0; --b)
+		{
+			FIVSmokeHoleDynamicBinding& Binding = Subject.Bindings[b];
+
+			UIVSmokeHoleGeneratorComponent* Generator = Binding.Generator.Get();
+			if (!Generator || !Binding.Preset)
+			{
+				RemoveBinding(Subject, b);
+				continue;
+			}
+
+			if (!FBox3f(Generator->Bounds.GetBox()).IsInside(CurrentPos))
+			{
+				continue;
+			}
+
+			// 2. Ignore if object moves a little bit
+			if (Binding.Preset->DistanceThreshold > FVector3f::Dist(CurrentPos, Binding.LastWorldPosition))
+			{
+				continue;
+			}
+
+			// 3. Create Hole
+			Generator->CreateDynamicHole(Binding.LastWorldPosition, CurrentPos, *Binding.Preset);
+			Binding.LastWorldPosition = CurrentPos;
+		}
+	}
+}
+
+TStatId UIVSmokeDynamicHoleSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UIVSmokeDynamicHoleSubsystem, STATGROUP_IVSmoke);
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Registration
+#pragma region Registration
+
+bool UIVSmokeDynamicHoleSubsystem::RegisterSubject(AActor* TargetActor, UIVSmokeHoleGeneratorComponent* Generator, UIVSmokeHolePreset* Preset)
+{
+	if (!TargetActor || !Generator || !Preset)
+	{
+		return false;
+	}
+
+	// 1. Find or add the subject, tracked once per actor
+	int32& SubjectIndex = SubjectIndices.FindOrAdd(TargetActor, INDEX_NONE);
+	if (SubjectIndex == INDEX_NONE)
+	{
+		SubjectIndex = Subjects.AddDefaulted();
+		Subjects[SubjectIndex].TargetActor = TargetActor;
+	}
+
+	FIVSmokeHoleDynamicSubject& Subject = Subjects[SubjectIndex];
+	for (const FIVSmokeHoleDynamicBinding& Binding : Subject.Bindings)
+	{
+		if (Binding.Generator == Generator)
+		{
+			return false;
+		}
+	}
+
+	// 2. Bind the generator
+	FIVSmokeHoleDynamicBinding& Binding = Subject.Bindings.AddDefaulted_GetRef();
+	Binding.Generator = Generator;
+	Binding.Preset = Preset;
+	Binding.LastWorldPosition = FVector3f(TargetActor->GetActorLocation());
+
+	// 3. Already inside, or unable to report overlaps at all
+	const bool bCanActivateByOverlap = CanActivateByOverlap(TargetActor, Generator);
+	if (!bCanActivateByOverlap)
+	{
+		UE_LOG(LogIVSmoke, Verbose, TEXT("[UIVSmokeDynamicHoleSubsystem::RegisterSubject] %s generates no overlap events with %s, its binding is polled every tick"), *TargetActor->GetName(), *Generator->GetName());
+	}
+
+	if (!bCanActivateByOverlap || Generator->IsOverlappingActor(TargetActor))
+	{
+		SetBindingActive(Subject, Subject.Bindings.Num() - 1, true);
+	}
+
+	return true;
+}
+
+void UIVSmokeDynamicHoleSubsystem::UnregisterGenerator(const UIVSmokeHoleGeneratorComponent* Generator)
+{
+	for (int32 i = Subjects.Num() - 1; i >= 0; --i)
+	{
+		FIVSmokeHoleDynamicSubject& Subject = Subjects[i];
+		for (int32 b = Subject.Bindings.Num() - 1; b >= 0; --b)
+		{
+			if (Subject.Bindings[b].Generator == Generator)
+			{
+				RemoveBinding(Subject, b);
+			}
+		}
+
+		if (Subject.Bindings.IsEmpty())
+		{
+			RemoveSubjectAt(i);
+		}
+	}
+}
+
+void UIVSmokeDynamicHoleSubsystem::SetSubjectOverlapping(AActor* TargetActor, const UIVSmokeHoleGeneratorComponent* Generator, bool bOverlapping)
+{
+	const int32* SubjectIndex = SubjectIndices.Find(TargetActor);
+	if (!SubjectIndex)
+	{
+		return;
+	}
+
+	FIVSmokeHoleDynamicSubject& Subject = Subjects[*SubjectIndex];
+	const int32 BindingIndex = Subject.Bindings.IndexOfByPredicate([Generator](const FIVSmokeHoleDynamicBinding& Binding)
+	{
+		return Binding.Generator == Generator;
+	});
+
+	if (BindingIndex == INDEX_NONE || (BindingIndex < Subject.NumActiveBindings) == bOverlapping)
+	{
+		return;
+	}
+
+	// The trail restarts where the actor entered instead of connecting to where it left
+	if (bOverlapping)
+	{
+		Subject.Bindings[BindingIndex].LastWorldPosition = FVector3f(TargetActor->GetActorLocation());
+	}
+
+	SetBindingActive(Subject, BindingIndex, bOverlapping);
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Helpers
+#pragma region Helpers
+
+void UIVSmokeDynamicHoleSubsystem::SetBindingActive(FIVSmokeHoleDynamicSubject& Subject, int32 BindingIndex, bool bActive)
+{
+	if (bActive)
+	{
+		check(BindingIndex >= Subject.NumActiveBindings);
+		Subject.Bindings.Swap(BindingIndex, Subject.NumActiveBindings);
+		++Subject.NumActiveBindings;
+	}
+	else
+	{
+		check(BindingIndex < Subject.NumActiveBindings);
+		--Subject.NumActiveBindings;
+		Subject.Bindings.Swap(BindingIndex, Subject.NumActiveBindings);
+	}
+}
+
+void UIVSmokeDynamicHoleSubsystem::RemoveBinding(FIVSmokeHoleDynamicSubject& Subject, int32 BindingIndex)
+{
+	if (BindingIndex < Subject.NumActiveBindings)
+	{
+		SetBindingActive(Subject, BindingIndex, false);
+		BindingIndex = Subject.NumActiveBindings;
+	}
+	Subject.Bindings.RemoveAtSwap(BindingIndex);
+}
+
+void UIVSmokeDynamicHoleSubsystem::RemoveSubjectAt(int32 SubjectIndex)
+{
+	SubjectIndices.Remove(Subjects[SubjectIndex].TargetActor);
+
+	const int32 LastIndex = Subjects.Num() - 1;
+	if (SubjectIndex != LastIndex)
+	{
+		SubjectIndices.FindChecked(Subjects[LastIndex].TargetActor) = SubjectIndex;
+	}
+	Subjects.RemoveAtSwap(SubjectIndex);
+}
+
+bool UIVSmokeDynamicHoleSubsystem::CanActivateByOverlap(const AActor* Actor, const UPrimitiveComponent* GeneratorBox)
+{
+	if (!GeneratorBox->GetGenerateOverlapEvents() || !GeneratorBox->IsCollisionEnabled())
+	{
+		return false;
+	}
+
+	// Only an overlap response on both sides is trusted to report the begin and end overlaps the binding waits for
+	const ECollisionChannel GeneratorChannel = GeneratorBox->GetCollisionObjectType();
+	bool bGeneratesOverlaps = false;
+	Actor->ForEachComponent<UPrimitiveComponent>(false, [&bGeneratesOverlaps, GeneratorBox, GeneratorChannel](const UPrimitiveComponent* Primitive)
+	{
+		bGeneratesOverlaps |= Primitive->GetGenerateOverlapEvents()
+			&& Primitive->IsCollisionEnabled()
+			&& Primitive->GetCollisionResponseToChannel(GeneratorChannel) == ECR_Overlap
+			&& GeneratorBox->GetCollisionResponseToChannel(Primitive->GetCollisionObjectType()) == ECR_Overlap;
+	});
+	return bGeneratesOverlaps;
+}
+
+#pragma endregion
@@ -0,0 +1,254 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeHoleAtlas.h"
+
+#include "IVSmoke.h"
+#include "IVSmokeHoleGeneratorComponent.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+#include "RenderUtils.h"
+#include "SystemTextures.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Atlas Reallocations"), STAT_IVSmoke_HoleAtlasReallocations, STATGROUP_IVSmoke);
+
+namespace IVSmokeHoleAtlas
+{
+	/** Atlas textures kept on the render thread between frames. */
+	class FAtlasTextures : public FRenderResource
+	{
+	public:
+		TRefCountPtr<IPooledRenderTarget> Textures[NumFormats];
+
+		/** Layout generation of each texture. 0 if nothing was allocated. */
+		uint32 Generations[NumFormats] = {};
+
+		virtual void ReleaseRHI() override
+		{
+			for (int32 i = 0; i < NumFormats; ++i)
+			{
+				Textures[i].SafeRelease();
+				Generations[i] = 0;
+			}
+		}
+	};
+
+	static TGlobalResource<FAtlasTextures> GAtlasTextures;
+}
+
+FIntVector FIVSmokeHoleAtlasLayout::GetSlotMin(const int32 SlotIndex) const
+{
+	const FIntVector SlotCoord(
+		SlotIndex % SlotCount.X,
+		(SlotIndex / SlotCount.X) % SlotCount.Y,
+		SlotIndex / (SlotCount.X * SlotCount.Y)
+	);
+	return FIntVector(FIVSmokeHoleAtlas::SlotPadding) + SlotCoord * (SlotResolution + FIntVector(FIVSmokeHoleAtlas::SlotPadding));
+}
+
+FIVSmokeHoleAtlas& FIVSmokeHoleAtlas::Get()
+{
+	static FIVSmokeHoleAtlas Atlas;
+	return Atlas;
+}
+
+int32 FIVSmokeHoleAtlas::AllocateSlot(const EIVSmokeHoleTextureFormat Format, const FIntVector& Resolution)
+{
+	check(IsInGameThread());
+
+	FAtlas& Atlas = Atlases[static_cast<int32>(Format)];
+	FIVSmokeHoleAtlasLayout& Layout = Atlas.Layout;
+
+	int32 SlotIndex = Atlas.UsedSlots.Find(false);
+	if (SlotIndex == INDEX_NONE)
+	{
+		SlotIndex = Atlas.UsedSlots.Num();
+	}
+
+	// 1. Grow the grid if the slot does not fit. Capacity grows by a quarter, and rounding the grid towards a cube
+	//    adds more, so a burst of new volumes moves the slots only a few times without keeping a mostly empty atlas resident
+	const int32 Capacity = Layout.SlotCount.X * Layout.SlotCount.Y * Layout.SlotCount.Z;
+	const FIntVector SlotResolution = Layout.SlotResolution.ComponentMax(Resolution);
+	if (SlotIndex >= Capacity || SlotResolution != Layout.SlotResolution)
+	{
+		const int32 MinSlots = SlotIndex >= Capacity ? FMath::Max(SlotIndex + 1, Capacity + Capacity / 4) : Capacity;
+		if (!Relayout(Atlas, SlotResolution, MinSlots) && !Relayout(Atlas, SlotResolution, SlotIndex + 1))
+		{
+			UE_LOG(LogIVSmoke, Warning, TEXT("[FIVSmokeHoleAtlas::AllocateSlot] No room for a %dx%dx%d hole texture (%d slots in use)"),
+				Resolution.X, Resolution.Y, Resolution.Z, Atlas.UsedSlots.CountSetBits());
+			return INDEX_NONE;
+		}
+	}
+
+	// 2. Mark the slot used
+	if (SlotIndex == Atlas.UsedSlots.Num())
+	{
+		Atlas.UsedSlots.Add(true);
+	}
+	else
+	{
+		Atlas.UsedSlots[SlotIndex] = true;
+	}
+
+	return SlotIndex;
+}
+
+void FIVSmokeHoleAtlas::FreeSlot(const EIVSmokeHoleTextureFormat Format, const int32 SlotIndex)
+{
+	check(IsInGameThread());
+
+	FAtlas& Atlas = Atlases[static_cast<int32>(Format)];
+	if (!Atlas.UsedSlots.IsValidIndex(SlotIndex) || !Atlas.UsedSlots[SlotIndex])
+	{
+		return;
+	}
+
+	Atlas.UsedSlots[SlotIndex] = false;
+
+	// The last slot releases the texture, and the next allocation starts over at its own resolution
+	if (Atlas.UsedSlots.Find(true) == INDEX_NONE)
+	{
+		Atlas = FAtlas();
+		++Version;
+	}
+}
+
+const FIVSmokeHoleAtlasLayout& FIVSmokeHoleAtlas::GetLayout(const EIVSmokeHoleTextureFormat Format) const
+{
+	return Atlases[static_cast<int32>(Format)].Layout;
+}
+
+bool FIVSmokeHoleAtlas::Relayout(FAtlas& Atlas, const FIntVector& SlotResolution, const int32 MinSlots)
+{
+	const FIntVector Stride = SlotResolution + FIntVector(SlotPadding);
+	const FIntVector MaxSlotCount(
+		(MaxResolution - SlotPadding) / Stride.X,
+		(MaxResolution - SlotPadding) / Stride.Y,
+		(MaxResolution - SlotPadding) / Stride.Z
+	);
+	if (MaxSlotCount.X <= 0 || MaxSlotCount.Y <= 0 || MaxSlotCount.Z <= 0)
+	{
+		return false;
+	}
+
+	// Pick the grid closest to a cube that holds MinSlots: the fewest slots along its longest axis, then the fewest texels.
+	// Z follows from X and Y
+	FIntVector SlotCount = FIntVector::ZeroValue;
+	int32 BestMaxSlots = MAX_int32;
+	int64 BestTexels = MAX_int64;
+	for (int32 X = 1; X <= FMath::Min(MinSlots, MaxSlotCount.X); ++X)
+	{
+		const int32 MaxY = FMath::Min(FMath::DivideAndRoundUp(MinSlots, X), MaxSlotCount.Y);
+		for (int32 Y = 1; Y <= MaxY; ++Y)
+		{
+			const int32 Z = FMath::DivideAndRoundUp(MinSlots, X * Y);
+			if (Z > MaxSlotCount.Z)
+			{
+				continue;
+			}
+
+			const FIntVector Resolution = FIntVector(SlotPadding) + FIntVector(X, Y, Z) * Stride;
+			const int64 Texels = static_cast<int64>(Resolution.X) * Resolution.Y * Resolution.Z;
+			const int32 MaxSlots = FMath::Max3(X, Y, Z);
+			if (MaxSlots < BestMaxSlots || (MaxSlots == BestMaxSlots && Texels < BestTexels))
+			{
+				SlotCount = FIntVector(X, Y, Z);
+				BestMaxSlots = MaxSlots;
+				BestTexels = Texels;
+			}
+		}
+	}
+
+	if (SlotCount.X * SlotCount.Y * SlotCount.Z < MinSlots)
+	{
+		return false;
+	}
+
+	FIVSmokeHoleAtlasLayout& Layout = Atlas.Layout;
+	Layout.SlotResolution = SlotResolution;
+	Layout.SlotCount = SlotCount;
+	Layout.Resolution = FIntVector(SlotPadding) + SlotCount * Stride;
+	Layout.Generation = ++LastGeneration;
+	++Version;
+	return true;
+}
+
+FIVSmokeHoleAtlas::FSnapshotRef FIVSmokeHoleAtlas::GetSnapshot()
+{
+	check(IsInGameThread());
+
+	if (!Snapshot.IsValid() || Snapshot->Version != Version)
+	{
+		TSharedRef<FIVSmokeHoleAtlasSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FIVSmokeHoleAtlasSnapshot, ESPMode::ThreadSafe>();
+		for (int32 i = 0; i < IVSmokeHoleAtlas::NumFormats; ++i)
+		{
+			const FIVSmokeHoleAtlasLayout& Layout = Atlases[i].Layout;
+			NewSnapshot->Layouts[i] = Layout;
+			NewSnapshot->AllocatedBytes += CalculateImageBytes(Layout.Resolution.X, Layout.Resolution.Y, Layout.Resolution.Z,
+				GetPixelFormat(static_cast<EIVSmokeHoleTextureFormat>(i)));
+		}
+		NewSnapshot->Version = Version;
+		Snapshot = NewSnapshot;
+	}
+
+	return Snapshot.ToSharedRef();
+}
+
+FRDGTextureRef FIVSmokeHoleAtlas::RegisterTexture(FRDGBuilder& GraphBuilder, const EIVSmokeHoleTextureFormat Format, const FIVSmokeHoleAtlasLayout& Layout)
+{
+	check(IsInRenderingThread());
+
+	const int32 FormatIndex = static_cast<int32>(Format);
+	IVSmokeHoleAtlas::FAtlasTextures& AtlasTextures = IVSmokeHoleAtlas::GAtlasTextures;
+	TRefCountPtr<IPooledRenderTarget>& Texture = AtlasTextures.Textures[FormatIndex];
+	uint32& Generation = AtlasTextures.Generations[FormatIndex];
+
+	if (Layout.IsEmpty())
+	{
+		Texture.SafeRelease();
+		Generation = 0;
+		return GSystemTextures.GetVolumetricBlackDummy(GraphBuilder);
+	}
+
+	if (Texture.IsValid() && Generation == Layout.Generation)
+	{
+		return GraphBuilder.RegisterExternalTexture(Texture);
+	}
+
+	// A layout older than the texture must not recreate it; its slots no longer exist
+	if (Texture.IsValid() && Layout.Generation < Generation)
+	{
+		return GSystemTextures.GetVolumetricBlackDummy(GraphBuilder);
+	}
+
+	// Slots moved, so the previous content is stale; every generator carves its slot again
+	INC_DWORD_STAT(STAT_IVSmoke_HoleAtlasReallocations);
+
+	const FRDGTextureRef NewTexture = GraphBuilder.CreateTexture(
+		FRDGTextureDesc::Create3D(Layout.Resolution, GetPixelFormat(Format), FClearValueBinding::None, TexCreate_ShaderResource | TexCreate_UAV),
+		TEXT("IVSmokeHoleAtlas"));
+	AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(NewTexture), GetClearValue(Format));
+
+	Texture = GraphBuilder.ConvertToExternalTexture(NewTexture);
+	Generation = Layout.Generation;
+	return NewTexture;
+}
+
+EPixelFormat FIVSmokeHoleAtlas::GetPixelFormat(const EIVSmokeHoleTextureFormat Format)
+{
+	switch (Format)
+	{
+	case EIVSmokeHoleTextureFormat::RGBA8:
+		return PF_R8G8B8A8_SNORM;
+	case EIVSmokeHoleTextureFormat::R8:
+		return PF_R8;
+	default:
+		return PF_FloatRGBA;
+	}
+}
+
+FVector4f FIVSmokeHoleAtlas::GetClearValue(const EIVSmokeHoleTextureFormat Format)
+{
+	// Full density without distortion. Also zero strength in the lifetime layout of the half float atlas
+	return Format == EIVSmokeHoleTextureFormat::R8 ? FVector4f(1.0f, 0.0f, 0.0f, 0.0f) : FVector4f(0.0f, 0.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,831 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeHoleCarve.h"
+
+#include "HAL/IConsoleManager.h"
+#include "IVSmoke.h"
+#include "IVSmokeHoleGPUList.h"
+#include "IVSmokeHoleOccupancy.h"
+#include "Math/RandomStream.h"
+
+namespace IVSmokeHoleCarve
+{
+	/** Region sizes are rounded up to the carve thread group size to keep transient textures poolable. */
+	static constexpr int32 RegionAlignment = 8;
+
+	/** Normalized Gaussian weights per blur step. Must match IVSmokeHoleBlurCS.usf. */
+	static const float BlurWeights[4][5] = {
+		{ 0.5f, 0.25f },
+		{ 0.375f, 0.25f, 0.0625f },
+		{ 0.28125f, 0.21875f, 0.109375f, 0.03125f },
+		{ 0.2265625f, 0.1875f, 0.1171875f, 0.0546875f, 0.015625f },
+	};
+
+	static FORCEINLINE int32 ToIndex(const FIntVector& Coord, const FIntVector& Size)
+	{
+		return Coord.X + (Coord.Y + Coord.Z * Size.Y) * Size.X;
+	}
+
+	static FORCEINLINE float Saturate(const float Value)
+	{
+		return FMath::Clamp(Value, 0.0f, 1.0f);
+	}
+
+	/**
+	 * Converts world bounds into the inclusive range of voxels whose centers may lie inside.
+	 * Returns false if the range misses the texture. The range is not clamped.
+	 */
+	static bool CalculateVoxelRange(const FBox3f& Bounds, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+		const FIntVector& Resolution, FIntVector& OutMin, FIntVector& OutMax)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			const float CellSize = (VolumeMax[Axis] - VolumeMin[Axis]) / Resolution[Axis];
+			if (!(CellSize > 0.0f) || !FMath::IsFinite(CellSize))
+			{
+				return false;
+			}
+
+			// Voxel centers lie at VolumeMin + (Coord + 0.5) * CellSize
+			OutMin[Axis] = FMath::FloorToInt((Bounds.Min[Axis] - VolumeMin[Axis]) / CellSize - 0.5f);
+			OutMax[Axis] = FMath::CeilToInt((Bounds.Max[Axis] - VolumeMin[Axis]) / CellSize - 0.5f);
+
+			if (OutMax[Axis] < 0 || OutMin[Axis] >= Resolution[Axis])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static FIVSmokeHoleShape MakeShape(const FIVSmokeHoleGPU& Hole, const FIVSmokeHolePresetGPU& Preset)
+	{
+		FIVSmokeHoleShape Shape;
+		Shape.HoleType = static_cast<EIVSmokeHoleType>(Preset.HoleType);
+		Shape.Position = Hole.Position;
+		Shape.EndPosition = Hole.EndPosition;
+		Shape.Radius = Preset.Radius;
+		Shape.EndRadius = Preset.EndRadius;
+		Shape.Extent = Preset.Extent;
+		return Shape;
+	}
+
+	/** Returns the preset of a hole, or a zeroed preset if its index is out of range. */
+	static FORCEINLINE const FIVSmokeHolePresetGPU& GetPreset(TConstArrayView<FIVSmokeHolePresetGPU> Presets, const FIVSmokeHoleGPU& Hole)
+	{
+		static const FIVSmokeHolePresetGPU EmptyPreset;
+		const int32 Index = static_cast<int32>(Hole.PresetIndex);
+		return Presets.IsValidIndex(Index) ? Presets[Index] : EmptyPreset;
+	}
+
+	/** Mirrors the carve strength of `Penetration()` in IVSmokeHoleCarveCS.usf without noise. */
+	static float EvaluatePenetration(const FIVSmokeHoleGPU& Hole, const FIVSmokeHolePresetGPU& Preset, const FVector3f& WorldPos)
+	{
+		const FVector3f StartToEnd = Hole.EndPosition - Hole.Position;
+		const FVector3f StartToCur = WorldPos - Hole.Position;
+		const float LengthStartToEnd = StartToEnd.Size();
+
+		FVector3f DirStartToEnd = FVector3f::ZeroVector;
+		float T = 0.0f;
+		float TClamped = 0.0f;
+		if (LengthStartToEnd >= 0.0001f)
+		{
+			DirStartToEnd = StartToEnd / LengthStartToEnd;
+			T = FVector3f::DotProduct(StartToCur, DirStartToEnd);
+			TClamped = T / LengthStartToEnd;
+		}
+
+		if (TClamped < 0.0f || TClamped > 1.0f)
+		{
+			return 0.0f;
+		}
+
+		const float RadiusAtT = FMath::Lerp(Preset.Radius, Preset.EndRadius, TClamped);
+		const FVector3f ClosestPoint = Hole.Position + DirStartToEnd * T;
+		const float DistToAxis = (WorldPos - ClosestPoint).Size();
+
+		const float EdgeWidth = RadiusAtT * Saturate(Preset.Softness + 0.1f);
+		const float Dist = DistToAxis - RadiusAtT;
+
+		return Dist < 0.0f ? Saturate(-Dist / FMath::Max(EdgeWidth, 0.01f)) : 0.0f;
+	}
+
+	/** Mirrors the carve strength of the dynamic branch in IVSmokeHoleCarveCS.usf without noise. */
+	static float EvaluateDynamic(const FIVSmokeHoleGPU& Hole, const FIVSmokeHolePresetGPU& Preset, const FVector3f& WorldPos)
+	{
+		const FVector3f Diff = Hole.EndPosition - Hole.Position;
+		const float MoveLength = Diff.Size();
+		const FVector3f Forward = MoveLength > 0.1f ? Diff / MoveLength : FVector3f(0.0f, 0.0f, 1.0f);
+		const FVector3f UpHint = FMath::Abs(Forward.Z) < 0.999f ? FVector3f(0.0f, 0.0f, 1.0f) : FVector3f(1.0f, 0.0f, 0.0f);
+		const FVector3f Right = FVector3f::CrossProduct(UpHint, Forward).GetSafeNormal();
+		const FVector3f Up = FVector3f::CrossProduct(Forward, Right);
+
+		const FVector3f LocalPos = WorldPos - (Hole.Position + Hole.EndPosition) * 0.5f;
+		const FVector3f P(FVector3f::DotProduct(LocalPos, Right), FVector3f::DotProduct(LocalPos, Forward), FVector3f::DotProduct(LocalPos, Up));
+
+		const float HalfX = Preset.Extent.X * 0.5f;
+		const float HalfY = Preset.Extent.Y * 0.5f + MoveLength * 0.5f;
+		const float CapRadius = HalfX;
+		const float BodyHalfHeight = Preset.Extent.Z * 0.5f * 0.8f;
+
+		// Box SDF
+		const FVector3f Q = P.GetAbs() - FVector3f(HalfX, HalfY, BodyHalfHeight);
+		const float DistOutside = FVector3f::Max(Q, FVector3f::ZeroVector).Size();
+		const float DistInside = FMath::Min(FMath::Max(Q.X, FMath::Max(Q.Y, Q.Z)), 0.0f);
+		const float DBox = DistOutside + DistInside;
+
+		const float DSphereTop = (P - FVector3f(0.0f, 0.0f, BodyHalfHeight)).Size() - CapRadius;
+		const float DSphereBot = (P - FVector3f(0.0f, 0.0f, -BodyHalfHeight)).Size() - CapRadius;
+		const float Dist = FMath::Min(DBox, FMath::Min(DSphereTop, DSphereBot));
+
+		const float FalloffWidth = FMath::Max(1.0f, Preset.Softness * CapRadius);
+		return Saturate(-Dist / FalloffWidth);
+	}
+
+	/** Mirrors IVSmokeHoleBlurCS.usf along one axis, clamping to the buffer bounds. */
+	static void BlurAxis(TConstArrayView<FVector4f> Input, TArrayView<FVector4f> Output, const FIntVector& Size, const FIntVector& Direction, const int32 BlurStep)
+	{
+		const float* Weights = BlurWeights[BlurStep - 1];
+
+		for (int32 Z = 0; Z < Size.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < Size.Y; ++Y)
+			{
+				for (int32 X = 0; X < Size.X; ++X)
+				{
+					const FIntVector Coord(X, Y, Z);
+					FVector4f Result(0.0f, 0.0f, 0.0f, 0.0f);
+
+					for (int32 i = -BlurStep; i <= BlurStep; ++i)
+					{
+						const FIntVector Sample = Coord + Direction * i;
+						const FIntVector Clamped(
+							FMath::Clamp(Sample.X, 0, Size.X - 1),
+							FMath::Clamp(Sample.Y, 0, Size.Y - 1),
+							FMath::Clamp(Sample.Z, 0, Size.Z - 1));
+
+						Result += Input[ToIndex(Clamped, Size)] * Weights[FMath::Abs(i)];
+					}
+
+					Output[ToIndex(Coord, Size)] = Result;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Mirrors BlurApronAxis in IVSmokeHoleCarveCS.usf: blurs BlurredSize voxels from BlurredMin of a cubic apron tile
+	 * along one axis and writes them back in place. Scratch stands in for the registers held across the barrier.
+	 */
+	static void BlurApronAxis(TArrayView<FVector4f> Apron, TArray<FVector4f>& Scratch, const int32 ApronSize, const FIntVector& BlurredMin, const FIntVector& BlurredSize,
+		const FIntVector& Direction, const int32 BlurStep)
+	{
+		const float* Weights = BlurWeights[BlurStep - 1];
+		const FIntVector ApronExtent(ApronSize);
+
+		// 1. Read every sample first, since the results overwrite samples of other voxels
+		Scratch.SetNumUninitialized(BlurredSize.X * BlurredSize.Y * BlurredSize.Z, EAllowShrinking::No);
+		for (int32 Z = 0; Z < BlurredSize.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < BlurredSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < BlurredSize.X; ++X)
+				{
+					const FIntVector Coord = BlurredMin + FIntVector(X, Y, Z);
+					FVector4f Result(0.0f, 0.0f, 0.0f, 0.0f);
+
+					for (int32 i = -BlurStep; i <= BlurStep; ++i)
+					{
+						Result += Apron[ToIndex(Coord + Direction * i, ApronExtent)] * Weights[FMath::Abs(i)];
+					}
+
+					Scratch[ToIndex(FIntVector(X, Y, Z), BlurredSize)] = Result;
+				}
+			}
+		}
+
+		// 2. Write the results in place
+		for (int32 Z = 0; Z < BlurredSize.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < BlurredSize.Y; ++Y)
+			{
+				for (int32 X = 0; X < BlurredSize.X; ++X)
+				{
+					Apron[ToIndex(BlurredMin + FIntVector(X, Y, Z), ApronExtent)] = Scratch[ToIndex(FIntVector(X, Y, Z), BlurredSize)];
+				}
+			}
+		}
+	}
+}
+
+//~==============================================================================
+// Region
+#pragma region Region
+
+bool FIVSmokeHoleCarve::CalculateHoleBounds(const FIVSmokeHoleGPU& Hole, const FIVSmokeHolePresetGPU& Preset, const float NoiseStrength, FBox3f& OutBounds)
+{
+	using namespace IVSmokeHoleCarve;
+
+	const FIVSmokeHoleShape Shape = MakeShape(Hole, Preset);
+
+	switch (Shape.HoleType)
+	{
+	case EIVSmokeHoleType::Penetration:
+	{
+		// Noise pushes the edge outward by at most Strength * EdgeWidth
+		const float EdgeWidthRatio = Saturate(Preset.Softness + 0.1f);
+		const float MaxRadius = FMath::Max(Preset.Radius, Preset.EndRadius);
+		OutBounds = FIVSmokeHoleOccupancy::CalculateShapeBounds(Shape).ExpandBy(MaxRadius * EdgeWidthRatio * NoiseStrength);
+		return true;
+	}
+	case EIVSmokeHoleType::Dynamic:
+	{
+		const float FalloffWidth = FMath::Max(1.0f, Preset.Softness * Preset.Extent.X * 0.5f);
+		OutBounds = FIVSmokeHoleOccupancy::CalculateShapeBounds(Shape).ExpandBy(FalloffWidth * NoiseStrength);
+		return true;
+	}
+	case EIVSmokeHoleType::Explosion:
+	default:
+		// Height fade and distortion reach the whole volume
+		return false;
+	}
+}
+
+bool FIVSmokeHoleCarve::CalculateRegion(const FBox3f& DirtyBounds, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+	const FIntVector& Resolution, const int32 BlurStep, FIVSmokeHoleCarveRegion& OutRegion)
+{
+	using namespace IVSmokeHoleCarve;
+
+	if (!DirtyBounds.IsValid)
+	{
+		return false;
+	}
+
+	FIntVector DirtyMin, DirtyMax;
+	if (!CalculateVoxelRange(DirtyBounds, VolumeMin, VolumeMax, Resolution, DirtyMin, DirtyMax))
+	{
+		return false;
+	}
+
+	const int32 Blur = FMath::Max(BlurStep, 0);
+
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+	{
+		const int32 Last = Resolution[Axis] - 1;
+		const int32 WriteMin = FMath::Max(DirtyMin[Axis] - Blur, 0);
+		const int32 WriteMax = FMath::Min(DirtyMax[Axis] + Blur, Last);
+		const int32 CarveMin = FMath::Max(WriteMin - Blur, 0);
+		const int32 CarveMax = FMath::Min(WriteMax + Blur, Last);
+
+		OutRegion.WriteMin[Axis] = WriteMin;
+		OutRegion.WriteSize[Axis] = WriteMax - WriteMin + 1;
+
+		// Growing the carve region never changes the written result
+		OutRegion.CarveSize[Axis] = FMath::Min(Align(CarveMax - CarveMin + 1, RegionAlignment), Resolution[Axis]);
+		OutRegion.CarveMin[Axis] = FMath::Min(CarveMin, Resolution[Axis] - OutRegion.CarveSize[Axis]);
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Brick Bins
+#pragma region BrickBins
+
+void FIVSmokeHoleBrickBins::Build(TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, TConstArrayView<float> NoiseStrengths, const float CullTime,
+	const FVector3f& VolumeMin, const FVector3f& VolumeMax, const FIntVector& Resolution, const FIVSmokeHoleCarveRegion& Region)
+{
+	using namespace IVSmokeHoleCarve;
+
+	BrickCount = FIntVector(
+		FMath::DivideAndRoundUp(Resolution.X, BrickSize),
+		FMath::DivideAndRoundUp(Resolution.Y, BrickSize),
+		FMath::DivideAndRoundUp(Resolution.Z, BrickSize));
+
+	BrickRanges.Reset();
+	BrickRanges.SetNumZeroed(BrickCount.X * BrickCount.Y * BrickCount.Z);
+	HoleIndices.Reset();
+
+	const FIntVector RegionBrickMin = Region.CarveMin / BrickSize;
+	const FIntVector RegionBrickMax = (Region.CarveMin + Region.CarveSize - FIntVector(1)) / BrickSize;
+
+	// 1. Brick range per hole (Min > Max marks a hole that touches no brick)
+	TArray<TPair<FIntVector, FIntVector>, TInlineAllocator<64>> HoleBricks;
+	HoleBricks.SetNumUninitialized(Holes.Num());
+	TBitArray<> Explosions(false, Holes.Num());
+
+	for (int32 HoleIndex = 0; HoleIndex < Holes.Num(); ++HoleIndex)
+	{
+		const FIVSmokeHoleGPU& Hole = Holes[HoleIndex];
+		const FIVSmokeHolePresetGPU& Preset = GetPreset(Presets, Hole);
+		TPair<FIntVector, FIntVector>& Bricks = HoleBricks[HoleIndex];
+		Bricks.Key = FIntVector(1);
+		Bricks.Value = FIntVector::ZeroValue;
+
+		// Fully faded holes are skipped by the shader anyway. Also drops removed hole list entries
+		if (Preset.Duration < Hole.GetLifeTime(Preset, CullTime))
+		{
+			continue;
+		}
+		Explosions[HoleIndex] = Preset.HoleType == static_cast<int32>(EIVSmokeHoleType::Explosion);
+
+		const float NoiseStrength = NoiseStrengths.IsValidIndex(Preset.HoleType) ? NoiseStrengths[Preset.HoleType] : 0.0f;
+
+		FBox3f Bounds;
+		FIntVector VoxelMin, VoxelMax;
+		if (!FIVSmokeHoleCarve::CalculateHoleBounds(Hole, Preset, NoiseStrength, Bounds))
+		{
+			Bricks.Key = RegionBrickMin;
+			Bricks.Value = RegionBrickMax;
+		}
+		else if (CalculateVoxelRange(Bounds, VolumeMin, VolumeMax, Resolution, VoxelMin, VoxelMax))
+		{
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				Bricks.Key[Axis] = FMath::Max(FMath::Max(VoxelMin[Axis], 0) / BrickSize, RegionBrickMin[Axis]);
+				Bricks.Value[Axis] = FMath::Min(FMath::Min(VoxelMax[Axis], Resolution[Axis] - 1) / BrickSize, RegionBrickMax[Axis]);
+			}
+		}
+	}
+
+	auto ForEachBrick = [this](const TPair<FIntVector, FIntVector>& Bricks, auto&& Func)
+	{
+		for (int32 Z = Bricks.Key.Z; Z <= Bricks.Value.Z; ++Z)
+		{
+			for (int32 Y = Bricks.Key.Y; Y <= Bricks.Value.Y; ++Y)
+			{
+				for (int32 X = Bricks.Key.X; X <= Bricks.Value.X; ++X)
+				{
+					Func(BrickRanges[X + (Y + Z * BrickCount.Y) * BrickCount.X]);
+				}
+			}
+		}
+	};
+
+	// 2. Count holes per brick
+	for (const TPair<FIntVector, FIntVector>& Bricks : HoleBricks)
+	{
+		ForEachBrick(Bricks, [](FUintVector2& Range) { ++Range.Y; });
+	}
+
+	// 3. Prefix sum into first entries
+	uint32 Total = 0;
+	for (FUintVector2& Range : BrickRanges)
+	{
+		Range.X = Total;
+		Total += Range.Y;
+		Range.Y = 0;
+	}
+
+	// 4. Fill explosions first, since penetrations read their fade state, then the rest in hole buffer order
+	HoleIndices.SetNumUninitialized(FMath::Max<int32>(Total, 1));
+	for (const bool bExplosionPass : { true, false })
+	{
+		for (int32 HoleIndex = 0; HoleIndex < HoleBricks.Num(); ++HoleIndex)
+		{
+			if (Explosions[HoleIndex] != bExplosionPass)
+			{
+				continue;
+			}
+
+			ForEachBrick(HoleBricks[HoleIndex], [this, HoleIndex](FUintVector2& Range)
+			{
+				HoleIndices[Range.X + Range.Y++] = HoleIndex;
+			});
+		}
+	}
+}
+
+#pragma endregion
+
+//~==============================================================================
+// CPU Reference
+#pragma region Reference
+
+FVector4f FIVSmokeHoleCarve::EvaluateVoxel(TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+	const FIntVector& Resolution, const FIntVector& VoxelCoord, const FIVSmokeHoleBrickBins* Bins)
+{
+	using namespace IVSmokeHoleCarve;
+
+	const FVector3f NormalizedPos = (FVector3f(VoxelCoord) + FVector3f(0.5f)) / FVector3f(Resolution);
+	const FVector3f WorldPos = VolumeMin + NormalizedPos * (VolumeMax - VolumeMin);
+
+	FVector4f Result(0.0f, 0.0f, 0.0f, 0.0f);
+	float BestScore = 0.0f;
+
+	const TConstArrayView<uint32> BrickHoles = Bins ? Bins->GetBrickHoles(VoxelCoord) : TConstArrayView<uint32>();
+	const int32 NumEntries = Bins ? BrickHoles.Num() : Holes.Num();
+
+	for (int32 Entry = 0; Entry < NumEntries; ++Entry)
+	{
+		const FIVSmokeHoleGPU& Hole = Holes[Bins ? BrickHoles[Entry] : Entry];
+		const FIVSmokeHolePresetGPU& Preset = GetPreset(Presets, Hole);
+		const float LifeTime = Hole.GetLifeTime(Preset, HoleTime);
+		if (Preset.Duration < LifeTime)
+		{
+			continue;
+		}
+
+		float Strength;
+		float FadeExponent;
+		switch (static_cast<EIVSmokeHoleType>(Preset.HoleType))
+		{
+		case EIVSmokeHoleType::Penetration:
+			Strength = EvaluatePenetration(Hole, Preset, WorldPos);
+			FadeExponent = 3.5f;
+			break;
+		case EIVSmokeHoleType::Dynamic:
+			Strength = EvaluateDynamic(Hole, Preset, WorldPos);
+			FadeExponent = 2.0f;
+			break;
+		default:
+			continue;
+		}
+
+		const float RemainingTime = Preset.Duration - LifeTime;
+		if (Strength * RemainingTime > BestScore)
+		{
+			BestScore = Strength * RemainingTime;
+			Result = FVector4f(1.0f, RemainingTime, Preset.Duration, FadeExponent) * Strength;
+		}
+	}
+
+	return Result;
+}
+
+void FIVSmokeHoleCarve::UpdateRegion(TArray<FVector4f>& Texture, TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+	const FIntVector& Resolution, const int32 BlurStep, const FIVSmokeHoleCarveRegion& Region, const FIVSmokeHoleBrickBins* Bins)
+{
+	using namespace IVSmokeHoleCarve;
+
+	check(Texture.Num() == Resolution.X * Resolution.Y * Resolution.Z);
+
+	const FIntVector& Size = Region.CarveSize;
+	const int32 RegionNum = Size.X * Size.Y * Size.Z;
+
+	// 1. Carve
+	TArray<FVector4f> Buffers[2];
+	Buffers[0].SetNumUninitialized(RegionNum);
+	for (int32 Z = 0; Z < Size.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Size.Y; ++Y)
+		{
+			for (int32 X = 0; X < Size.X; ++X)
+			{
+				const FIntVector Local(X, Y, Z);
+				Buffers[0][ToIndex(Local, Size)] = EvaluateVoxel(Holes, Presets, HoleTime, VolumeMin, VolumeMax, Resolution, Region.CarveMin + Local, Bins);
+			}
+		}
+	}
+
+	// 2. Separable blur inside the region
+	int32 Current = 0;
+	if (BlurStep > 0)
+	{
+		Buffers[1].SetNumUninitialized(RegionNum);
+
+		const FIntVector Directions[3] = { FIntVector(1, 0, 0), FIntVector(0, 1, 0), FIntVector(0, 0, 1) };
+		for (const FIntVector& Direction : Directions)
+		{
+			BlurAxis(Buffers[Current], Buffers[1 - Current], Size, Direction, FMath::Min(BlurStep, 4));
+			Current = 1 - Current;
+		}
+	}
+
+	// 3. Write back
+	const FIntVector Offset = Region.WriteMin - Region.CarveMin;
+	for (int32 Z = 0; Z < Region.WriteSize.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < Region.WriteSize.Y; ++Y)
+		{
+			for (int32 X = 0; X < Region.WriteSize.X; ++X)
+			{
+				const FIntVector Local(X, Y, Z);
+				Texture[ToIndex(Region.WriteMin + Local, Resolution)] = Buffers[Current][ToIndex(Offset + Local, Size)];
+			}
+		}
+	}
+}
+
+void FIVSmokeHoleCarve::UpdateRegionFused(TArray<FVector4f>& Texture, TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+	const FIntVector& Resolution, const int32 BlurStep, const FIVSmokeHoleCarveRegion& Region, const FIVSmokeHoleBrickBins* Bins)
+{
+	using namespace IVSmokeHoleCarve;
+
+	check(Texture.Num() == Resolution.X * Resolution.Y * Resolution.Z);
+
+	const int32 Step = FMath::Clamp(BlurStep, 0, 4);
+	const int32 TileSize = FIVSmokeHoleFusedCarveCS::ThreadGroupSizeX;
+	const int32 ApronSize = TileSize + 2 * Step;
+	const FIntVector ApronExtent(ApronSize);
+	const FIntVector Offset = Region.WriteMin - Region.CarveMin;
+	const FIntVector TileCount(
+		FMath::DivideAndRoundUp(Region.WriteSize.X, TileSize),
+		FMath::DivideAndRoundUp(Region.WriteSize.Y, TileSize),
+		FMath::DivideAndRoundUp(Region.WriteSize.Z, TileSize));
+
+	TArray<FVector4f> Apron;
+	Apron.SetNumUninitialized(ApronSize * ApronSize * ApronSize);
+	TArray<FVector4f> Scratch;
+
+	for (int32 TileZ = 0; TileZ < TileCount.Z; ++TileZ)
+	{
+		for (int32 TileY = 0; TileY < TileCount.Y; ++TileY)
+		{
+			for (int32 TileX = 0; TileX < TileCount.X; ++TileX)
+			{
+				const FIntVector TileMin = FIntVector(TileX, TileY, TileZ) * TileSize;
+
+				// 1. Carve the tile and its apron, clamped to the carved region like the samples of the separable blur
+				for (int32 Z = 0; Z < ApronSize; ++Z)
+				{
+					for (int32 Y = 0; Y < ApronSize; ++Y)
+					{
+						for (int32 X = 0; X < ApronSize; ++X)
+						{
+							const FIntVector Unclamped = Offset + TileMin - FIntVector(Step) + FIntVector(X, Y, Z);
+							const FIntVector RegionCoord(
+								FMath::Clamp(Unclamped.X, 0, Region.CarveSize.X - 1),
+								FMath::Clamp(Unclamped.Y, 0, Region.CarveSize.Y - 1),
+								FMath::Clamp(Unclamped.Z, 0, Region.CarveSize.Z - 1));
+
+							Apron[ToIndex(FIntVector(X, Y, Z), ApronExtent)] =
+								EvaluateVoxel(Holes, Presets, HoleTime, VolumeMin, VolumeMax, Resolution, Region.CarveMin + RegionCoord, Bins);
+						}
+					}
+				}
+
+				// 2. X over the whole apron height and depth, Y over the apron depth, then Z over the tile
+				if (Step > 0)
+				{
+					BlurApronAxis(Apron, Scratch, ApronSize, FIntVector(Step, 0, 0), FIntVector(TileSize, ApronSize, ApronSize), FIntVector(1, 0, 0), Step);
+					BlurApronAxis(Apron, Scratch, ApronSize, FIntVector(Step, Step, 0), FIntVector(TileSize, TileSize, ApronSize), FIntVector(0, 1, 0), Step);
+					BlurApronAxis(Apron, Scratch, ApronSize, FIntVector(Step), FIntVector(TileSize), FIntVector(0, 0, 1), Step);
+				}
+
+				// 3. Write back the part of the tile inside the write region
+				for (int32 Z = 0; Z < TileSize; ++Z)
+				{
+					for (int32 Y = 0; Y < TileSize; ++Y)
+					{
+						for (int32 X = 0; X < TileSize; ++X)
+						{
+							const FIntVector Local = TileMin + FIntVector(X, Y, Z);
+							if (Local.X < Region.WriteSize.X && Local.Y < Region.WriteSize.Y && Local.Z < Region.WriteSize.Z)
+							{
+								Texture[ToIndex(Region.WriteMin + Local, Resolution)] = Apron[ToIndex(FIntVector(X, Y, Z) + FIntVector(Step), ApronExtent)];
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+int64 FIVSmokeHoleCarve::CalculateFusedCarveVoxels(const FIVSmokeHoleCarveRegion& Region, const int32 BlurStep)
+{
+	const int32 TileSize = FIVSmokeHoleFusedCarveCS::ThreadGroupSizeX;
+	const int64 ApronSize = TileSize + 2 * FMath::Max(BlurStep, 0);
+	const int64 NumTiles = static_cast<int64>(FMath::DivideAndRoundUp(Region.WriteSize.X, TileSize))
+		* FMath::DivideAndRoundUp(Region.WriteSize.Y, TileSize)
+		* FMath::DivideAndRoundUp(Region.WriteSize.Z, TileSize);
+	return NumTiles * ApronSize * ApronSize * ApronSize;
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Verification
+#pragma region Verification
+
+namespace IVSmokeHoleCarveCVars
+{
+	/** Random hole with its own random preset appended to Presets, alive at time 0. */
+	static FIVSmokeHoleGPU MakeRandomHole(FRandomStream& Stream, const FVector3f& VolumeMin, const FVector3f& VolumeMax, TArray<FIVSmokeHolePresetGPU>& Presets)
+	{
+		FIVSmokeHolePresetGPU& Preset = Presets.AddDefaulted_GetRef();
+		const bool bPenetration = Stream.FRand() < 0.75f;
+		Preset.HoleType = static_cast<int32>(bPenetration ? EIVSmokeHoleType::Penetration : EIVSmokeHoleType::Dynamic);
+		Preset.Radius = Stream.FRandRange(10.0f, 80.0f);
+		Preset.EndRadius = Stream.FRandRange(5.0f, 40.0f);
+		Preset.Extent = FVector3f(Stream.FRandRange(40.0f, 150.0f), Stream.FRandRange(40.0f, 150.0f), Stream.FRandRange(40.0f, 200.0f));
+		Preset.Softness = Stream.FRand();
+		Preset.Duration = Stream.FRandRange(1.0f, 10.0f);
+
+		FIVSmokeHoleGPU Hole;
+		FMemory::Memzero(&Hole, sizeof(Hole));
+		Hole.PresetIndex = Presets.Num() - 1;
+		Hole.Position = FVector3f(
+			Stream.FRandRange(VolumeMin.X, VolumeMax.X),
+			Stream.FRandRange(VolumeMin.Y, VolumeMax.Y),
+			Stream.FRandRange(VolumeMin.Z, VolumeMax.Z));
+		Hole.EndPosition = Hole.Position + FVector3f(Stream.VRand()) * Stream.FRandRange(0.0f, bPenetration ? 1500.0f : 200.0f);
+		Hole.ExpirationTime = Stream.FRandRange(0.0f, Preset.Duration);
+		return Hole;
+	}
+
+	static FAutoConsoleCommand Cmd_Holes_VerifyRegionCarve(
+		TEXT("IVSmoke.Holes.VerifyRegionCarve"),
+		TEXT("Applies random hole additions and removals through a hole GPU list and binned region updates of the CPU carve reference, and compares the result with unbinned full rebuilds.\nUsage: IVSmoke.Holes.VerifyRegionCarve [Steps] [BlurStep]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Steps = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 32;
+			const int32 BlurStep = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 0, 4) : 2;
+
+			const FIntVector Resolution(64, 64, 64);
+			const FVector3f VolumeMin(-1000.0f, -1000.0f, 0.0f);
+			const FVector3f VolumeMax(1000.0f, 1000.0f, 800.0f);
+			const int32 VoxelNum = Resolution.X * Resolution.Y * Resolution.Z;
+			const FIVSmokeHoleCarveRegion FullRegion = FIVSmokeHoleCarveRegion::MakeFull(Resolution);
+
+			FRandomStream Stream(0x5A17C0);
+			FIVSmokeHoleGPUList HoleList;
+			TArray<int32> LiveIndices;
+			FIVSmokeHoleGPUListUpdate ListUpdate;
+			TArray<int32> Remap;
+			TArray<FIVSmokeHolePresetGPU> Presets;
+			FIVSmokeHoleBrickBins Bins;
+			const float NoiseStrengths[3] = { 0.0f, 0.0f, 0.0f };
+
+			TArray<FVector4f> RegionTexture;
+			RegionTexture.SetNumZeroed(VoxelNum);
+			TArray<FVector4f> FullTexture;
+			FullTexture.SetNumZeroed(VoxelNum);
+
+			int64 RegionVoxels = 0;
+			int64 BinnedEntries = 0;
+			int64 UnbinnedEntries = 0;
+			int32 Failures = 0;
+
+			for (int32 Step = 0; Step < Steps; ++Step)
+			{
+				// 1. Change the hole set. Removed holes stay in the list until a compaction drops them
+				FIVSmokeHoleGPU Changed;
+				if (LiveIndices.Num() > 0 && Stream.FRand() < 0.25f)
+				{
+					const int32 Live = Stream.RandHelper(LiveIndices.Num());
+					Changed = HoleList.GetEntries()[LiveIndices[Live]];
+					HoleList.Remove(LiveIndices[Live]);
+					LiveIndices.RemoveAtSwap(Live);
+				}
+				else
+				{
+					Changed = MakeRandomHole(Stream, VolumeMin, VolumeMax, Presets);
+					LiveIndices.Add(HoleList.Add(Changed));
+				}
+
+				if (HoleList.ConsumeUpdate(0.0f, ListUpdate, Remap))
+				{
+					for (int32& Index : LiveIndices)
+					{
+						Index = Remap[Index];
+					}
+				}
+				const TConstArrayView<FIVSmokeHoleGPU> Holes = HoleList.GetEntries();
+
+				// 2. Region update
+				FBox3f Bounds;
+				FIVSmokeHoleCarveRegion Region;
+				if (FIVSmokeHoleCarve::CalculateHoleBounds(Changed, Presets[Changed.PresetIndex], 0.0f, Bounds) &&
+					FIVSmokeHoleCarve::CalculateRegion(Bounds, VolumeMin, VolumeMax, Resolution, BlurStep, Region))
+				{
+					Bins.Build(Holes, Presets, NoiseStrengths, 0.0f, VolumeMin, VolumeMax, Resolution, Region);
+					FIVSmokeHoleCarve::UpdateRegion(RegionTexture, Holes, Presets, 0.0f, VolumeMin, VolumeMax, Resolution, BlurStep, Region, &Bins);
+
+					const int32 CarvedVoxels = Region.CarveSize.X * Region.CarveSize.Y * Region.CarveSize.Z;
+					RegionVoxels += CarvedVoxels;
+					UnbinnedEntries += static_cast<int64>(CarvedVoxels) * Holes.Num();
+					for (int32 Z = 0; Z < Region.CarveSize.Z; ++Z)
+					{
+						for (int32 Y = 0; Y < Region.CarveSize.Y; ++Y)
+						{
+							for (int32 X = 0; X < Region.CarveSize.X; ++X)
+							{
+								BinnedEntries += Bins.GetBrickHoles(Region.CarveMin + FIntVector(X, Y, Z)).Num();
+							}
+						}
+					}
+				}
+
+				// 3. Full update
+				FIVSmokeHoleCarve::UpdateRegion(FullTexture, Holes, Presets, 0.0f, VolumeMin, VolumeMax, Resolution, BlurStep, FullRegion);
+
+				int32 Mismatches = 0;
+				for (int32 i = 0; i < VoxelNum; ++i)
+				{
+					if (RegionTexture[i] != FullTexture[i])
+					{
+						++Mismatches;
+					}
+				}
+
+				if (Mismatches > 0)
+				{
+					UE_LOG(LogIVSmoke, Error, TEXT("[IVSmoke.Holes] Step %d (%d holes): %d voxels differ between region and full update"),
+						Step, Holes.Num(), Mismatches);
+					++Failures;
+
+					// Resync so later steps are checked independently
+					RegionTexture = FullTexture;
+				}
+			}
+
+			const double AverageRatio = static_cast<double>(RegionVoxels) / (static_cast<double>(Steps) * VoxelNum);
+			const double BinnedRatio = UnbinnedEntries > 0 ? static_cast<double>(BinnedEntries) / UnbinnedEntries : 0.0;
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] VerifyRegionCarve %s: %d steps, BlurStep %d, %d failed, region carves averaged %.1f%% of a full carve, brick bins evaluated %.1f%% of the holes"),
+				Failures == 0 ? TEXT("PASS") : TEXT("FAIL"), Steps, BlurStep, Failures, AverageRatio * 100.0, BinnedRatio * 100.0);
+		})
+	);
+
+	static FAutoConsoleCommand Cmd_Holes_VerifyFusedCarve(
+		TEXT("IVSmoke.Holes.VerifyFusedCarve"),
+		TEXT("Applies random holes through full and region updates of the CPU carve reference, once with the carve and three blur passes and once tiled like the fused carve-and-blur pass, and compares the results.\nUsage: IVSmoke.Holes.VerifyFusedCarve [Steps] [BlurStep]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Steps = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 16;
+			const int32 BlurStep = Args.Num() > 1 ? FMath::Clamp(FCString::Atoi(*Args[1]), 0, 4) : 2;
+
+			const FIntVector Resolution(64, 64, 64);
+			const FVector3f VolumeMin(-1000.0f, -1000.0f, 0.0f);
+			const FVector3f VolumeMax(1000.0f, 1000.0f, 800.0f);
+			const int32 VoxelNum = Resolution.X * Resolution.Y * Resolution.Z;
+			const FIVSmokeHoleCarveRegion FullRegion = FIVSmokeHoleCarveRegion::MakeFull(Resolution);
+
+			FRandomStream Stream(0xF05ED);
+			TArray<FIVSmokeHoleGPU> Holes;
+			TArray<FIVSmokeHolePresetGPU> Presets;
+			FIVSmokeHoleBrickBins Bins;
+			const float NoiseStrengths[3] = { 0.0f, 0.0f, 0.0f };
+
+			TArray<FVector4f> Texture;
+			Texture.SetNumZeroed(VoxelNum);
+			TArray<FVector4f> FusedTexture;
+
+			int64 ThreePassCarves = 0;
+			int64 FusedCarves = 0;
+			int64 ThreePassTexels = 0;
+			int64 FusedTexels = 0;
+			float MaxDifference = 0.0f;
+			int32 Failures = 0;
+
+			for (int32 Step = 0; Step < Steps; ++Step)
+			{
+				// 1. Add a hole, then alternate full rebuilds and region updates around it
+				const FIVSmokeHoleGPU& Added = Holes.Add_GetRef(MakeRandomHole(Stream, VolumeMin, VolumeMax, Presets));
+
+				FIVSmokeHoleCarveRegion Region = FullRegion;
+				FBox3f Bounds;
+				if (Step % 2 == 1 && !(FIVSmokeHoleCarve::CalculateHoleBounds(Added, Presets[Added.PresetIndex], 0.0f, Bounds) &&
+					FIVSmokeHoleCarve::CalculateRegion(Bounds, VolumeMin, VolumeMax, Resolution, BlurStep, Region)))
+				{
+					continue;
+				}
+
+				// 2. Both updates start from the same texture
+				Bins.Build(Holes, Presets, NoiseStrengths, 0.0f, VolumeMin, VolumeMax, Resolution, Region);
+				FusedTexture = Texture;
+				FIVSmokeHoleCarve::UpdateRegion(Texture, Holes, Presets, 0.0f, VolumeMin, VolumeMax, Resolution, BlurStep, Region, &Bins);
+				FIVSmokeHoleCarve::UpdateRegionFused(FusedTexture, Holes, Presets, 0.0f, VolumeMin, VolumeMax, Resolution, BlurStep, Region, &Bins);
+
+				// Texel reads and writes of the GPU passes: carve writes, then a read and a write per blur axis
+				const int64 CarvedVoxels = static_cast<int64>(Region.CarveSize.X) * Region.CarveSize.Y * Region.CarveSize.Z;
+				const int64 WrittenVoxels = static_cast<int64>(Region.WriteSize.X) * Region.WriteSize.Y * Region.WriteSize.Z;
+				ThreePassCarves += CarvedVoxels;
+				FusedCarves += FIVSmokeHoleCarve::CalculateFusedCarveVoxels(Region, BlurStep);
+				ThreePassTexels += BlurStep > 0 ? CarvedVoxels * 5 + WrittenVoxels * 2 : CarvedVoxels;
+				FusedTexels += WrittenVoxels;
+
+				// 3. Compare
+				int32 Mismatches = 0;
+				for (int32 i = 0; i < VoxelNum; ++i)
+				{
+					for (int32 Channel = 0; Channel < 4; ++Channel)
+					{
+						MaxDifference = FMath::Max(MaxDifference, FMath::Abs(FusedTexture[i][Channel] - Texture[i][Channel]));
+					}
+					if (FusedTexture[i] != Texture[i])
+					{
+						++Mismatches;
+					}
+				}
+
+				if (Mismatches > 0)
+				{
+					UE_LOG(LogIVSmoke, Error, TEXT("[IVSmoke.Holes] Step %d (%d holes, %s): %d voxels differ between the fused and three pass updates"),
+						Step, Holes.Num(), Region.IsFull(Resolution) ? TEXT("full") : TEXT("region"), Mismatches);
+					++Failures;
+				}
+			}
+
+			const double CarveRatio = ThreePassCarves > 0 ? static_cast<double>(FusedCarves) / ThreePassCarves : 0.0;
+			const double TexelRatio = ThreePassTexels > 0 ? static_cast<double>(FusedTexels) / ThreePassTexels : 0.0;
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] VerifyFusedCarve %s: %d steps, BlurStep %d, %d failed, max difference %g, fused pass carved %.2fx the voxels and accessed %.1f%% of the texels of the three pass update"),
+				Failures == 0 ? TEXT("PASS") : TEXT("FAIL"), Steps, BlurStep, Failures, MaxDifference, CarveRatio, TexelRatio * 100.0);
+		})
+	);
+}
+
+#pragma endregion
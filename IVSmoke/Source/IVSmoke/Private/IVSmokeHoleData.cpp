@@ -1,125 +1,552 @@
 ﻿// Copyright (c) 2026, Team SDB. All rights reserved.
 
 #include "IVSmokeHoleData.h"
+#include "IVSmoke.h"
 #include "IVSmokeHolePreset.h"
 #include "IVSmokeHoleGeneratorComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/BitReader.h"
+#include "Serialization/BitWriter.h"
+
+namespace IVSmokeHoleNet
+{
+	/** Context of the NetDeltaSerialize running on this thread. */
+	static thread_local const FIVSmokeHoleNetContext* CurrentContext = nullptr;
+
+	static constexpr float PositionSteps = 65535.0f;
+
+	/** Expirations are sent as remaining centiseconds. */
+	static constexpr float TimeStepsPerSecond = 100.0f;
+
+	static FORCEINLINE bool IsInFrame(const FVector3f& Position, const FIVSmokeHoleNetFrame& Frame)
+	{
+		const FVector3f Offset = (Position - Frame.Origin).GetAbs();
+		return Offset.GetMax() <= Frame.HalfExtent;
+	}
+
+	static void SerializeQuantizedPosition(FArchive& Ar, FVector3f& Position, const FIVSmokeHoleNetFrame& Frame)
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			uint16 Quantized = 0;
+			if (Ar.IsSaving())
+			{
+				const float Normalized = (Position[Axis] - Frame.Origin[Axis]) / Frame.HalfExtent * 0.5f + 0.5f;
+				Quantized = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt(Normalized * PositionSteps), 0, 65535));
+			}
+
+			Ar << Quantized;
+
+			if (Ar.IsLoading())
+			{
+				Position[Axis] = Frame.Origin[Axis] + (Quantized / PositionSteps * 2.0f - 1.0f) * Frame.HalfExtent;
+			}
+		}
+	}
+}
+
+FIVSmokeHoleNetContextScope::FIVSmokeHoleNetContextScope(const FIVSmokeHoleNetContext& Context)
+	: PreviousContext(IVSmokeHoleNet::CurrentContext)
+{
+	IVSmokeHoleNet::CurrentContext = &Context;
+}
+
+FIVSmokeHoleNetContextScope::~FIVSmokeHoleNetContextScope()
+{
+	IVSmokeHoleNet::CurrentContext = PreviousContext;
+}
+
+bool FIVSmokeHoleData::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	using namespace IVSmokeHoleNet;
+
+	const FIVSmokeHoleNetContext* Context = CurrentContext;
+
+	// 1. Positions: 16-bit offsets inside the frame, explosions send a single position
+	uint8 bQuantized = Ar.IsSaving() && Context && Context->Frame.IsValid() &&
+		IsInFrame(Position, Context->Frame) && IsInFrame(EndPosition, Context->Frame);
+	uint8 bHasEndPosition = EndPosition != Position;
+	Ar.SerializeBits(&bQuantized, 1);
+	Ar.SerializeBits(&bHasEndPosition, 1);
+
+	if (bQuantized && !Context)
+	{
+		// A quantized item cannot be decoded without the frame
+		bOutSuccess = false;
+		return true;
+	}
+
+	if (bQuantized)
+	{
+		SerializeQuantizedPosition(Ar, Position, Context->Frame);
+		if (bHasEndPosition)
+		{
+			SerializeQuantizedPosition(Ar, EndPosition, Context->Frame);
+		}
+	}
+	else
+	{
+		Ar << Position;
+		if (bHasEndPosition)
+		{
+			Ar << EndPosition;
+		}
+	}
+
+	if (Ar.IsLoading() && !bHasEndPosition)
+	{
+		EndPosition = Position;
+	}
+
+	// 2. Expiration: remaining lifetime relative to the synced time of each side
+	uint8 bRelativeTime = Ar.IsSaving() && Context;
+	Ar.SerializeBits(&bRelativeTime, 1);
+
+	if (bRelativeTime && Context)
+	{
+		uint32 RemainingSteps = 0;
+		if (Ar.IsSaving())
+		{
+			RemainingSteps = static_cast<uint32>(FMath::Max(0, FMath::CeilToInt((ExpirationServerTime - Context->ServerTime) * TimeStepsPerSecond)));
+		}
+
+		Ar.SerializeIntPacked(RemainingSteps);
+
+		if (Ar.IsLoading())
+		{
+			ExpirationServerTime = Context->ServerTime + RemainingSteps / TimeStepsPerSecond;
+		}
+	}
+	else if (bRelativeTime)
+	{
+		bOutSuccess = false;
+		return true;
+	}
+	else
+	{
+		Ar << ExpirationServerTime;
+	}
+
+	// 3. Preset
+	Ar << PresetID;
+
+	// 4. Prediction key and its shooter, only for predicted holes
+	uint8 bPredicted = PredictionKey != 0;
+	Ar.SerializeBits(&bPredicted, 1);
+	if (bPredicted)
+	{
+		Ar << PredictionKey;
+		Ar << PredictionOwnerID;
+	}
+	else if (Ar.IsLoading())
+	{
+		PredictionKey = 0;
+		PredictionOwnerID = INDEX_NONE;
+	}
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
 
 void FIVSmokeHoleData::PostReplicatedAdd(const FIVSmokeHoleArray& InArray)
 {
+	InArray.AddGPUEntry(*this);
 	if (InArray.OwnerComponent)
 	{
-		InArray.OwnerComponent->MarkHoleTextureDirty();
+		InArray.OwnerComponent->MarkHoleRegionDirty(*this);
+		InArray.OwnerComponent->ReconcilePredictedHole(*this);
 	}
 }
 
 void FIVSmokeHoleData::PostReplicatedChange(const FIVSmokeHoleArray& InArray)
 {
+	// Only the new data reaches the client, so the entry is rebuilt from it
+	InArray.RemoveGPUEntry(*this);
+	InArray.AddGPUEntry(*this);
 	if (InArray.OwnerComponent)
 	{
+		// Evicted holes are overwritten in place, so a change can also confirm a prediction
 		InArray.OwnerComponent->MarkHoleTextureDirty();
+		InArray.OwnerComponent->ReconcilePredictedHole(*this);
 	}
 }
 
 void FIVSmokeHoleData::PreReplicatedRemove(const FIVSmokeHoleArray& InArray)
 {
+	InArray.RemoveGPUEntry(*this);
 	if (InArray.OwnerComponent)
 	{
-		InArray.OwnerComponent->MarkHoleTextureDirty();
+		InArray.OwnerComponent->MarkHoleRegionDirty(*this);
 	}
 }
 
-void FIVSmokeHoleArray::Empty()
+bool FIVSmokeHoleArray::IsRelevantToCurrentConnection(const FIVSmokeHoleData& Item)
 {
-	Items.Empty();
-	MarkArrayDirty();
+	const FIVSmokeHoleNetContext* Context = IVSmokeHoleNet::CurrentContext;
+	if (!Context || !Context->bCullByDistance)
+	{
+		return true;
+	}
+
+	// Distance to the closest point of the hole segment, so long penetrations count from their nearest end
+	const FVector3f Segment = Item.EndPosition - Item.Position;
+	const float SegmentLengthSquared = Segment.SizeSquared();
+	const float T = SegmentLengthSquared > UE_SMALL_NUMBER
+		? FMath::Clamp(((Context->ViewerLocation - Item.Position) | Segment) / SegmentLengthSquared, 0.0f, 1.0f)
+		: 0.0f;
+	const FVector3f ClosestPoint = Item.Position + Segment * T;
+	return FVector3f::DistSquared(ClosestPoint, Context->ViewerLocation) <= Context->CullDistanceSquared;
 }
 
-TArray<FIVSmokeHoleGPU> FIVSmokeHoleArray::GetHoleGPUData(const float CurrentServerTime) const
+bool FIVSmokeHoleArray::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
 {
-	TArray<FIVSmokeHoleGPU> GPUBuffer;
-	TArray<FIVSmokeHoleGPU> BulletBuffer;
-	TArray<FIVSmokeHoleGPU> GrenadeBuffer;
-	TArray<FIVSmokeHoleGPU> DynamicObjectBuffer;
+	if (!OwnerComponent)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FIVSmokeHoleData, FIVSmokeHoleArray>(
+			Items, DeltaParms, *this
+		);
+	}
 
-	BulletBuffer.Reserve(FMath::Max(Num(), 1));
-	GrenadeBuffer.Reserve(FMath::Max(Num(), 1));
-	DynamicObjectBuffer.Reserve(FMath::Max(Num(), 1));
-	GPUBuffer.Reserve(FMath::Max(Num(), 1));
+	FIVSmokeHoleNetContext Context;
+	Context.Frame = OwnerComponent->GetHoleNetFrame();
+	Context.ServerTime = OwnerComponent->GetSyncedTime();
 
-	for (const FIVSmokeHoleData& Hole : Items)
+	// Per connection distance culling, only when writing on the server
+	const float CullDistance = OwnerComponent->HoleNetCullDistance;
+	if (DeltaParms.Writer && CullDistance > 0.0f)
 	{
-		TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID);
-		if (!Preset)
+		const UPackageMapClient* PackageMap = Cast<UPackageMapClient>(DeltaParms.Map);
+		const UNetConnection* Connection = PackageMap ? PackageMap->GetConnection() : nullptr;
+		if (Connection && Connection->ViewTarget)
 		{
-			continue;
+			Context.ViewerLocation = FVector3f(Connection->ViewTarget->GetActorLocation());
+			Context.CullDistanceSquared = FMath::Square(CullDistance);
+			Context.bCullByDistance = true;
 		}
+	}
+
+	const FIVSmokeHoleNetContextScope ContextScope(Context);
+	return FFastArraySerializer::FastArrayDeltaSerialize<FIVSmokeHoleData, FIVSmokeHoleArray>(
+		Items, DeltaParms, *this
+	);
+}
+
+void FIVSmokeHoleArray::AddHole(const FIVSmokeHoleData& NewHole)
+{
+	const int32 Index = Items.Add(NewHole);
+	MarkItemDirty(Items.Last());
+
+	ExpiryHeapPositions.Add(ExpiryHeap.Add(Index));
+	FixHeapEntry(ExpiryHeapPositions[Index]);
+
+	Items[Index].GPUListIndex = INDEX_NONE;
+	AddGPUEntry(Items[Index]);
+}
+
+void FIVSmokeHoleArray::ReplaceHole(const int32 Index, const FIVSmokeHoleData& NewHole)
+{
+	if (!Items.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	FIVSmokeHoleData& Target = Items[Index];
+	Target.Position = NewHole.Position;
+	Target.EndPosition = NewHole.EndPosition;
+	Target.ExpirationServerTime = NewHole.ExpirationServerTime;
+	Target.PresetID = NewHole.PresetID;
+	Target.PredictionKey = NewHole.PredictionKey;
+	Target.PredictionOwnerID = NewHole.PredictionOwnerID;
+	MarkItemDirty(Target);
+
+	FixHeapEntry(ExpiryHeapPositions[Index]);
+
+	RemoveGPUEntry(Target);
+	AddGPUEntry(Target);
+}
 
-		FIVSmokeHoleGPU GPUHole = FIVSmokeHoleGPU(Hole, *Preset.Get(), CurrentServerTime);
+void FIVSmokeHoleArray::RemoveAtSwap(const int32 Index)
+{
+	if (!Items.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	// 1. Remove the heap entry by moving the last entry into its place
+	const int32 HeapIndex = ExpiryHeapPositions[Index];
+	const int32 LastHeapIndex = ExpiryHeap.Num() - 1;
+	if (HeapIndex != LastHeapIndex)
+	{
+		SwapHeapEntries(HeapIndex, LastHeapIndex);
+	}
+	ExpiryHeap.Pop(EAllowShrinking::No);
+	if (HeapIndex < ExpiryHeap.Num())
+	{
+		FixHeapEntry(HeapIndex);
+	}
+
+	// 2. The last item moves into Index, so its heap entry must point there
+	const int32 LastIndex = Items.Num() - 1;
+	if (Index != LastIndex)
+	{
+		ExpiryHeapPositions[Index] = ExpiryHeapPositions[LastIndex];
+		ExpiryHeap[ExpiryHeapPositions[Index]] = Index;
+	}
+	ExpiryHeapPositions.Pop(EAllowShrinking::No);
 
-		if (Preset->HoleType == EIVSmokeHoleType::Penetration)
+	// 3. The GPU list entry index travels with the moved item, so only the removed one changes the list
+	RemoveGPUEntry(Items[Index]);
+
+	Items.RemoveAtSwap(Index);
+	MarkArrayDirty();
+}
+
+void FIVSmokeHoleArray::Empty()
+{
+	Items.Empty();
+	ExpiryHeap.Empty();
+	ExpiryHeapPositions.Empty();
+	GPUList.Reset();
+	NumUnlistedItems = 0;
+	MarkArrayDirty();
+}
+
+void FIVSmokeHoleArray::SwapHeapEntries(const int32 HeapA, const int32 HeapB)
+{
+	ExpiryHeap.Swap(HeapA, HeapB);
+	ExpiryHeapPositions[ExpiryHeap[HeapA]] = HeapA;
+	ExpiryHeapPositions[ExpiryHeap[HeapB]] = HeapB;
+}
+
+void FIVSmokeHoleArray::FixHeapEntry(int32 HeapIndex)
+{
+	// 1. Sift up
+	while (HeapIndex > 0)
+	{
+		const int32 Parent = (HeapIndex - 1) / 2;
+		if (!ExpiresBefore(HeapIndex, Parent))
 		{
-			BulletBuffer.Add(GPUHole);
+			break;
 		}
-		else if (Preset->HoleType == EIVSmokeHoleType::Explosion)
+		SwapHeapEntries(HeapIndex, Parent);
+		HeapIndex = Parent;
+	}
+
+	// 2. Sift down
+	const int32 HeapNum = ExpiryHeap.Num();
+	while (true)
+	{
+		const int32 Left = HeapIndex * 2 + 1;
+		if (Left >= HeapNum)
 		{
-			GrenadeBuffer.Add(GPUHole);
+			break;
 		}
-		else if (Preset->HoleType == EIVSmokeHoleType::Dynamic)
+
+		const int32 Right = Left + 1;
+		const int32 Child = (Right < HeapNum && ExpiresBefore(Right, Left)) ? Right : Left;
+		if (!ExpiresBefore(Child, HeapIndex))
 		{
-			DynamicObjectBuffer.Add(GPUHole);
+			break;
 		}
+		SwapHeapEntries(HeapIndex, Child);
+		HeapIndex = Child;
+	}
+}
+
+bool FIVSmokeHoleArray::ShouldMaintainGPUList() const
+{
+#if !UE_SERVER
+	return !OwnerComponent || !OwnerComponent->IsNetMode(NM_DedicatedServer);
+#else
+	return false;
+#endif
+}
+
+void FIVSmokeHoleArray::AddGPUEntry(const FIVSmokeHoleData& Item) const
+{
+	if (!ShouldMaintainGPUList())
+	{
+		return;
 	}
 
-	GPUBuffer.Append(GrenadeBuffer);
-	GPUBuffer.Append(BulletBuffer);
-	GPUBuffer.Append(DynamicObjectBuffer);
+	const UIVSmokeHolePreset* Preset = UIVSmokeHolePreset::FindByID(Item.PresetID);
+	if (!Preset)
+	{
+		// Retried on every ConsumeGPUListUpdate until the preset is registered
+		Item.GPUListIndex = INDEX_NONE;
+		++NumUnlistedItems;
+		return;
+	}
 
-	if (GPUBuffer.Num() == 0)
+	// A list full of removed entries drops them before the next compaction would
+	if (GPUList.IsFull())
 	{
-		GPUBuffer.AddDefaulted(1);
+		TArray<int32> Remap;
+		if (GPUList.CompactRemoved(Remap))
+		{
+			RemapGPUListIndices(Remap);
+		}
 	}
 
-	return GPUBuffer;
+	Item.GPUListIndex = GPUList.Add(FIVSmokeHoleGPU(Item, *Preset));
+	if (Item.GPUListIndex == INDEX_NONE)
+	{
+		++NumUnlistedItems;
+	}
 }
 
-FIVSmokeHoleGPU::FIVSmokeHoleGPU(const FIVSmokeHoleData& DynamicHoleData, const UIVSmokeHolePreset& Preset, const float CurrentServerTime)
+void FIVSmokeHoleArray::RemoveGPUEntry(const FIVSmokeHoleData& Item) const
 {
-	Position = FVector3f(DynamicHoleData.Position);
-	EndPosition = FVector3f(DynamicHoleData.EndPosition);
-
-	HoleType = static_cast<int32>(Preset.HoleType);
-	Radius = Preset.Radius;
-	Duration = Preset.Duration;
-	if (Duration == 0)
+	if (!ShouldMaintainGPUList())
 	{
 		return;
 	}
-	Softness = Preset.Softness;
-	ExpansionDuration = Preset.ExpansionDuration;
-
-	//SetTime
-	float RemainingTime = DynamicHoleData.ExpirationServerTime - CurrentServerTime;
-	CurLifeTime = Duration - RemainingTime;
-	float NormalizedTime = FMath::Clamp(CurLifeTime / Duration, 0.0f, 1.0f);
 
-	switch (Preset.HoleType)
+	if (Item.GPUListIndex == INDEX_NONE)
 	{
-	case EIVSmokeHoleType::Explosion:
+		--NumUnlistedItems;
+	}
+	else
+	{
+		GPUList.Remove(Item.GPUListIndex);
+	}
+	Item.GPUListIndex = FIVSmokeHoleGPUList::DroppedIndex;
+}
+
+void FIVSmokeHoleArray::RemapGPUListIndices(TConstArrayView<int32> Remap) const
+{
+	for (const FIVSmokeHoleData& Item : Items)
 	{
-		float ExpansionNormalizedTime = FMath::Clamp(CurLifeTime / Preset.ExpansionDuration, 0.0f, 1.0f);
-		float ShrinkNormalizedTime = FMath::Clamp((CurLifeTime - Preset.ExpansionDuration) / (Preset.Duration - Preset.ExpansionDuration), 0.0f, 1.0f);
+		if (Remap.IsValidIndex(Item.GPUListIndex))
+		{
+			Item.GPUListIndex = Remap[Item.GPUListIndex];
+		}
+	}
+}
 
-		CurExpansionFadeRangeOverTime = Preset.ExpansionFadeRangeCurveOverTime ? UIVSmokeHolePreset::GetFloatValue(Preset.ExpansionFadeRangeCurveOverTime, ExpansionNormalizedTime) : ExpansionNormalizedTime;
-		CurShrinkFadeRangeOverTime = Preset.ShrinkFadeRangeCurveOverTime ? UIVSmokeHolePreset::GetFloatValue(Preset.ShrinkFadeRangeCurveOverTime, ShrinkNormalizedTime) : 1 - ShrinkNormalizedTime;
-		DistortionExpOverTime = Preset.DistortionExpOverTime;
-		DistortionDistance = Preset.DistortionDistance;
-		break;
+void FIVSmokeHoleArray::ConsumeGPUListUpdate(const float CurrentServerTime, FIVSmokeHoleGPUListUpdate& OutUpdate)
+{
+	// 1. List the items whose preset was missing
+	if (NumUnlistedItems > 0)
+	{
+		NumUnlistedItems = 0;
+		for (const FIVSmokeHoleData& Item : Items)
+		{
+			if (Item.GPUListIndex == INDEX_NONE)
+			{
+				AddGPUEntry(Item);
+			}
+		}
 	}
-	case EIVSmokeHoleType::Penetration:
-		EndRadius = Preset.EndRadius;
-		break;
-	case EIVSmokeHoleType::Dynamic:
-		Extent = Preset.Extent;
-		break;
+
+	// 2. Entries move when the list is compacted, and holes expired by then lose theirs
+	TArray<int32> Remap;
+	if (GPUList.ConsumeUpdate(CurrentServerTime, OutUpdate, Remap))
+	{
+		RemapGPUListIndices(Remap);
 	}
 }
+
+FIVSmokeHoleGPU::FIVSmokeHoleGPU(const FIVSmokeHoleData& DynamicHoleData, const UIVSmokeHolePreset& Preset)
+{
+	Position = FVector3f(DynamicHoleData.Position);
+	EndPosition = FVector3f(DynamicHoleData.EndPosition);
+	PresetIndex = static_cast<uint32>(FMath::Max(Preset.GetGPUIndex(), 0));
+	ExpirationTime = DynamicHoleData.ExpirationServerTime;
+}
+
+//~============================================================================
+// Console Commands
+#pragma region ConsoleCommands
+namespace IVSmokeHoleDataCVars
+{
+	static FAutoConsoleCommand Cmd_Holes_VerifyNetQuantization(
+		TEXT("IVSmoke.Holes.VerifyNetQuantization"),
+		TEXT("Round-trips random holes through FIVSmokeHoleData::NetSerialize and reports the precision and size against unquantized replication.\nUsage: IVSmoke.Holes.VerifyNetQuantization [Samples]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Samples = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10000;
+
+			// Two raw FVector3f, a float and a byte per hole
+			constexpr int32 RawBits = (sizeof(FVector3f) * 2 + sizeof(float) + sizeof(uint8)) * 8;
+
+			FRandomStream Stream(0x4E7);
+
+			FIVSmokeHoleNetContext Context;
+			Context.Frame.Origin = FVector3f(12345.0f, -6789.0f, 250.0f);
+			Context.Frame.HalfExtent = 4000.0f;
+			Context.ServerTime = 1234.5f;
+			const FIVSmokeHoleNetContextScope ContextScope(Context);
+
+			const float PositionTolerance = Context.Frame.HalfExtent / IVSmokeHoleNet::PositionSteps + 0.01f;
+			const float TimeTolerance = 1.0f / IVSmokeHoleNet::TimeStepsPerSecond + 0.001f;
+
+			int64 TotalBits = 0;
+			int32 Quantized = 0;
+			int32 Failures = 0;
+			float MaxPositionError = 0.0f;
+			float MaxTimeError = 0.0f;
+
+			for (int32 i = 0; i < Samples; ++i)
+			{
+				// 1. Random hole, mostly inside the frame, a quarter of them explosions with a single position
+				FIVSmokeHoleData Source;
+				const float Reach = Stream.FRand() < 0.9f ? 1.0f : 1.5f;
+				auto RandomPosition = [&]()
+				{
+					return Context.Frame.Origin + FVector3f(
+						Stream.FRandRange(-Reach, Reach),
+						Stream.FRandRange(-Reach, Reach),
+						Stream.FRandRange(-Reach, Reach)) * Context.Frame.HalfExtent;
+				};
+				Source.Position = RandomPosition();
+				Source.EndPosition = Stream.FRand() < 0.25f ? Source.Position : RandomPosition();
+				Source.ExpirationServerTime = Context.ServerTime + Stream.FRandRange(0.0f, 60.0f);
+				Source.PresetID = static_cast<uint8>(Stream.RandHelper(256));
+
+				// 2. Round trip
+				FBitWriter Writer(0, true);
+				bool bSuccess = true;
+				Source.NetSerialize(Writer, nullptr, bSuccess);
+				TotalBits += Writer.GetNumBits();
+
+				FBitReader Reader(Writer.GetData(), Writer.GetNumBits());
+				FIVSmokeHoleData Result;
+				bool bReadSuccess = true;
+				Result.NetSerialize(Reader, nullptr, bReadSuccess);
+
+				// 3. Compare
+				const bool bInFrame = IVSmokeHoleNet::IsInFrame(Source.Position, Context.Frame) && IVSmokeHoleNet::IsInFrame(Source.EndPosition, Context.Frame);
+				Quantized += bInFrame ? 1 : 0;
+
+				const float PositionError = FMath::Max(
+					(Result.Position - Source.Position).GetAbsMax(),
+					(Result.EndPosition - Source.EndPosition).GetAbsMax());
+				const float TimeError = Result.ExpirationServerTime - Source.ExpirationServerTime;
+				MaxPositionError = FMath::Max(MaxPositionError, PositionError);
+				MaxTimeError = FMath::Max(MaxTimeError, FMath::Abs(TimeError));
+
+				// Expirations round up so a hole never disappears on a client before the server
+				const bool bPass = bSuccess && bReadSuccess &&
+					PositionError <= (bInFrame ? PositionTolerance : 0.0f) &&
+					TimeError >= -0.001f && TimeError <= TimeTolerance &&
+					Result.PresetID == Source.PresetID &&
+					(Source.EndPosition == Source.Position) == (Result.EndPosition == Result.Position);
+
+				if (!bPass && Failures++ < 8)
+				{
+					UE_LOG(LogIVSmoke, Error, TEXT("[IVSmoke.Holes] Sample %d: position error %.4f, time error %.4f, preset %d -> %d"),
+						i, PositionError, TimeError, Source.PresetID, Result.PresetID);
+				}
+			}
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] VerifyNetQuantization %s: %d samples (%d quantized), %d failed, max position error %.4f (step %.4f), max time error %.4f s"),
+				Failures == 0 ? TEXT("PASS") : TEXT("FAIL"), Samples, Quantized, Failures, MaxPositionError, PositionTolerance, MaxTimeError);
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes]   %.1f bits per hole on average, %d bits unquantized (%.0f%%)"),
+				static_cast<double>(TotalBits) / Samples, RawBits, 100.0 * TotalBits / (static_cast<double>(Samples) * RawBits));
+		})
+	);
+}
+#pragma endregion
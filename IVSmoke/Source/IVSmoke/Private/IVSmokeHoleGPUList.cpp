@@ -0,0 +1,263 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeHoleGPUList.h"
+
+#include "IVSmoke.h"
+#include "IVSmokePostProcessPass.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole GPU List Full Uploads"), STAT_IVSmoke_HoleGPUListFullUploads, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole GPU List Compactions"), STAT_IVSmoke_HoleGPUListCompactions, STATGROUP_IVSmoke);
+
+namespace IVSmokeHoleGPUList
+{
+	/** Smallest capacity of a list buffer. Capacities grow in powers of two from here. */
+	static constexpr int32 MinCapacity = 64;
+}
+
+//~============================================================================
+// FIVSmokeHoleGPUList
+#pragma region GPUList
+
+int32 FIVSmokeHoleGPUList::Add(const FIVSmokeHoleGPU& Hole)
+{
+	if (IsFull())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Index = Entries.Add(Hole);
+	DirtyEntries.Add(true);
+	DirtyIndices.Add(Index);
+	return Index;
+}
+
+void FIVSmokeHoleGPUList::Remove(const int32 Index)
+{
+	if (!Entries.IsValidIndex(Index) || Entries[Index].ExpirationTime == RemovedExpirationTime)
+	{
+		return;
+	}
+
+	Entries[Index].ExpirationTime = RemovedExpirationTime;
+	++NumRemovedEntries;
+
+	if (!DirtyEntries[Index])
+	{
+		DirtyEntries[Index] = true;
+		DirtyIndices.Add(Index);
+	}
+}
+
+void FIVSmokeHoleGPUList::Reset()
+{
+	Entries.Reset();
+	DirtyIndices.Reset();
+	DirtyEntries.Reset();
+	NumRemovedEntries = 0;
+	bFullUpload = true;
+}
+
+bool FIVSmokeHoleGPUList::ConsumeUpdate(const float CompactTime, FIVSmokeHoleGPUListUpdate& OutUpdate, TArray<int32>& OutRemap)
+{
+	OutUpdate = FIVSmokeHoleGPUListUpdate();
+	OutRemap.Reset();
+
+	const bool bShouldCompact = NumRemovedEntries > 0
+		&& NumRemovedEntries >= FMath::Max(MinCompactEntries, Entries.Num() / CompactRatio);
+
+	if (bFullUpload)
+	{
+		// 1. Everything is uploaded anyway, so the compaction runs on the game thread only
+		if (bShouldCompact)
+		{
+			Compact(CompactTime, OutRemap);
+		}
+
+		OutUpdate.bFullUpload = true;
+		OutUpdate.Writes = Entries;
+		OutUpdate.NumWrittenEntries = Entries.Num();
+	}
+	else
+	{
+		// 2. Scatter the written entries, then let the GPU drop the same entries as the mirror
+		OutUpdate.Writes.Reserve(DirtyIndices.Num());
+		OutUpdate.WriteIndices.Reserve(DirtyIndices.Num());
+		for (const int32 Index : DirtyIndices)
+		{
+			OutUpdate.Writes.Add(Entries[Index]);
+			OutUpdate.WriteIndices.Add(static_cast<uint32>(Index));
+		}
+		OutUpdate.NumWrittenEntries = Entries.Num();
+
+		if (bShouldCompact)
+		{
+			Compact(CompactTime, OutRemap);
+			OutUpdate.bCompact = true;
+			OutUpdate.CompactTime = CompactTime;
+		}
+	}
+
+	OutUpdate.NumEntries = Entries.Num();
+
+	DirtyIndices.Reset();
+	DirtyEntries.Init(false, Entries.Num());
+	bFullUpload = false;
+	return bShouldCompact;
+}
+
+bool FIVSmokeHoleGPUList::CompactRemoved(TArray<int32>& OutRemap)
+{
+	OutRemap.Reset();
+	if (NumRemovedEntries == 0)
+	{
+		return false;
+	}
+
+	// Live entries always expire after RemovedExpirationTime, so only removed ones are dropped
+	Compact(RemovedExpirationTime, OutRemap);
+	DirtyIndices.Reset();
+	DirtyEntries.Init(false, Entries.Num());
+	bFullUpload = true;
+	return true;
+}
+
+void FIVSmokeHoleGPUList::Compact(const float CompactTime, TArray<int32>& OutRemap)
+{
+	OutRemap.SetNumUninitialized(Entries.Num());
+
+	int32 NumKept = 0;
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		if (Entries[i].ExpirationTime > CompactTime)
+		{
+			Entries[NumKept] = Entries[i];
+			OutRemap[i] = NumKept++;
+		}
+		else
+		{
+			OutRemap[i] = DroppedIndex;
+		}
+	}
+
+	Entries.SetNum(NumKept, EAllowShrinking::No);
+	NumRemovedEntries = 0;
+}
+
+#pragma endregion
+
+//~============================================================================
+// FIVSmokeHoleGPUListBuffer
+#pragma region GPUListBuffer
+
+FRDGBufferRef FIVSmokeHoleGPUListBuffer::CreateListBuffer(FRDGBuilder& GraphBuilder, const int32 Capacity)
+{
+	return GraphBuilder.CreateBuffer(
+		FRDGBufferDesc::CreateStructuredDesc(sizeof(FIVSmokeHoleGPU), Capacity),
+		TEXT("IVSmokeHoleGPUList"));
+}
+
+FRDGBufferRef FIVSmokeHoleGPUListBuffer::Update(FRDGBuilder& GraphBuilder, const FIVSmokeHoleGPUListUpdate& Update)
+{
+	check(IsInRenderingThread());
+	check(Update.bFullUpload || Buffer.IsValid());
+
+	const int32 RequiredCapacity = FMath::Max3(Update.NumWrittenEntries, 1, IVSmokeHoleGPUList::MinCapacity);
+	FRDGBufferRef ListBuffer;
+
+	// 1. Upload the whole list, or register the persistent buffer and grow it to fit the new entries
+	if (Update.bFullUpload)
+	{
+		INC_DWORD_STAT(STAT_IVSmoke_HoleGPUListFullUploads);
+
+		Capacity = FMath::RoundUpToPowerOfTwo(RequiredCapacity);
+		ListBuffer = CreateListBuffer(GraphBuilder, Capacity);
+		if (Update.Writes.Num() > 0)
+		{
+			GraphBuilder.QueueBufferUpload(ListBuffer, Update.Writes.GetData(), Update.Writes.Num() * sizeof(FIVSmokeHoleGPU));
+		}
+		else
+		{
+			AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(ListBuffer), 0u);
+		}
+	}
+	else
+	{
+		ListBuffer = GraphBuilder.RegisterExternalBuffer(Buffer);
+		if (RequiredCapacity > Capacity)
+		{
+			Capacity = FMath::RoundUpToPowerOfTwo(RequiredCapacity);
+			const FRDGBufferRef GrownBuffer = CreateListBuffer(GraphBuilder, Capacity);
+			if (NumEntries > 0)
+			{
+				AddCopyBufferPass(GraphBuilder, GrownBuffer, 0, ListBuffer, 0, NumEntries * sizeof(FIVSmokeHoleGPU));
+			}
+			else
+			{
+				AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(GrownBuffer), 0u);
+			}
+			ListBuffer = GrownBuffer;
+		}
+	}
+
+	FGlobalShaderMap* ShaderMap = GetGlobalShaderMap(GMaxRHIFeatureLevel);
+
+	// 2. Scatter added and removed entries
+	if (!Update.bFullUpload && Update.Writes.Num() > 0)
+	{
+		const FRDGBufferRef WriteBuffer = CreateStructuredBuffer(
+			GraphBuilder,
+			TEXT("IVSmokeHoleGPUListWrites"),
+			sizeof(FIVSmokeHoleGPU),
+			Update.Writes.Num(),
+			Update.Writes.GetData(),
+			sizeof(FIVSmokeHoleGPU) * Update.Writes.Num()
+		);
+
+		const FRDGBufferRef WriteIndexBuffer = CreateStructuredBuffer(
+			GraphBuilder,
+			TEXT("IVSmokeHoleGPUListWriteIndices"),
+			sizeof(uint32),
+			Update.WriteIndices.Num(),
+			Update.WriteIndices.GetData(),
+			sizeof(uint32) * Update.WriteIndices.Num()
+		);
+
+		FIVSmokeHoleListScatterCS::FParameters* ScatterParameters = GraphBuilder.AllocParameters<FIVSmokeHoleListScatterCS::FParameters>();
+		ScatterParameters->HoleList = GraphBuilder.CreateUAV(ListBuffer);
+		ScatterParameters->Writes = GraphBuilder.CreateSRV(WriteBuffer);
+		ScatterParameters->WriteIndices = GraphBuilder.CreateSRV(WriteIndexBuffer);
+		ScatterParameters->NumWrites = Update.Writes.Num();
+
+		const TShaderMapRef<FIVSmokeHoleListScatterCS> ScatterShader(ShaderMap);
+		FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleListScatterCS>(GraphBuilder, ShaderMap, ScatterShader, ScatterParameters,
+			FIntVector(Update.Writes.Num(), 1, 1));
+	}
+
+	// 3. Drop removed and expired entries into a new buffer, in the order FIVSmokeHoleGPUList::Compact keeps
+	if (Update.bCompact)
+	{
+		INC_DWORD_STAT(STAT_IVSmoke_HoleGPUListCompactions);
+
+		const FRDGBufferRef CompactedBuffer = CreateListBuffer(GraphBuilder, Capacity);
+
+		FIVSmokeHoleListCompactCS::FParameters* CompactParameters = GraphBuilder.AllocParameters<FIVSmokeHoleListCompactCS::FParameters>();
+		CompactParameters->HoleList = GraphBuilder.CreateSRV(ListBuffer);
+		CompactParameters->CompactedHoleList = GraphBuilder.CreateUAV(CompactedBuffer);
+		CompactParameters->NumEntries = Update.NumWrittenEntries;
+		CompactParameters->CompactTime = Update.CompactTime;
+
+		const TShaderMapRef<FIVSmokeHoleListCompactCS> CompactShader(ShaderMap);
+		FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleListCompactCS>(GraphBuilder, ShaderMap, CompactShader, CompactParameters,
+			FIntVector(FIVSmokeHoleListCompactCS::ThreadGroupSizeX, 1, 1));
+
+		ListBuffer = CompactedBuffer;
+	}
+
+	Buffer = GraphBuilder.ConvertToExternalBuffer(ListBuffer);
+	NumEntries = Update.NumEntries;
+	return ListBuffer;
+}
+
+#pragma endregion
@@ -2,26 +2,49 @@
 
 #include "IVSmokeHoleGeneratorComponent.h"
 
-#include "Engine/TextureRenderTargetVolume.h"
+#include "Algo/ForEach.h"
 #include "Engine/Texture2D.h"
 #include "Engine/World.h"
 #include "GameFramework/GameStateBase.h"
 #include "GlobalShader.h"
 #include "IVSmoke.h"
+#include "IVSmokeAnalyticHoleSubsystem.h"
+#include "IVSmokeBitGrid.h"
+#include "IVSmokeCurveAtlas.h"
+#include "IVSmokeDynamicHoleSubsystem.h"
+#include "IVSmokeHoleAtlas.h"
+#include "IVSmokeHoleCarve.h"
 #include "IVSmokeHoleShaders.h"
 #include "IVSmokeHolePreset.h"
+#include "IVSmokeHolePresetTable.h"
 #include "IVSmokePostProcessPass.h"
+#include "IVSmokeRayMarchPipeline.h"
 #include "IVSmokeVoxelVolume.h"
 #include "Net/UnrealNetwork.h"
 #include "RHICommandList.h"
 #include "RHIStaticStates.h"
 #include "RenderGraphBuilder.h"
 #include "RenderGraphUtils.h"
+#include "RenderUtils.h"
 #include "RenderingThread.h"
 #include "TextureResource.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Texture Carves (Per Frame)"), STAT_IVSmoke_HoleTextureCarves, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Texture Carved Voxels (Per Frame)"), STAT_IVSmoke_HoleTextureCarvedVoxels, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Buffer Upload Bytes (Per Frame)"), STAT_IVSmoke_HoleBufferUploadBytes, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Box Updates Applied (Per Frame)"), STAT_IVSmoke_HoleBoxUpdatesApplied, STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Box Updates Skipped (Per Frame)"), STAT_IVSmoke_HoleBoxUpdatesSkipped, STATGROUP_IVSmoke);
+
+namespace IVSmokeHoleGenerator
+{
+	/** Region updates older than this rebuild fully, keeping lifetime times small enough for the half float texture. */
+	static constexpr float MaxHoleTimeBaseAge = 16.0f;
+}
+
 UIVSmokeHoleGeneratorComponent::UIVSmokeHoleGeneratorComponent()
 	: bHoleTextureDirty(false)
+	, bHoleTextureFullRebuild(false)
+	, bAnalyticHoleMode(false)
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	SetIsReplicatedByDefault(true);
@@ -35,6 +58,9 @@ void UIVSmokeHoleGeneratorComponent::PostInitProperties()
 	// Prevent projectiles from being blocked by this box
 	SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	SetCollisionResponseToAllChannels(ECR_Overlap);
+
+	// Initial replication can arrive before BeginPlay, and items need the owner's frame to decode
+	ActiveHoles.OwnerComponent = this;
 }
 
 void UIVSmokeHoleGeneratorComponent::BeginPlay()
@@ -45,6 +71,15 @@ void UIVSmokeHoleGeneratorComponent::BeginPlay()
 	ActiveHoles.OwnerComponent = this;
 	ActiveHoles.Reserve(MaxHoles);
 
+	if (GetOwner()->HasAuthority())
+	{
+		Authority_InitializeHoleNetFrame();
+
+		// Dynamic subjects are only evaluated while they overlap this box
+		OnComponentBeginOverlap.AddDynamic(this, &UIVSmokeHoleGeneratorComponent::Authority_OnSubjectBeginOverlap);
+		OnComponentEndOverlap.AddDynamic(this, &UIVSmokeHoleGeneratorComponent::Authority_OnSubjectEndOverlap);
+	}
+
 	// Join process
 	if (ActiveHoles.Num() > 0)
 	{
@@ -60,41 +95,97 @@ void UIVSmokeHoleGeneratorComponent::TickComponent(const float DeltaTime, const
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	// 1. Server cleans up expired holes and updates dynamic objects
+	// 1. Server cleans up expired holes (dynamic objects are updated by UIVSmokeDynamicHoleSubsystem)
 	if (GetOwner()->HasAuthority())
 	{
 		Authority_CleanupExpiredHoles();
-		Authority_UpdateDynamicSubjectList();
+		Authority_RefreshHoleRelevancy();
 	}
 
 	// 2. All host update voxel volume area
 	SetBoxToVoxelAABB();
 
-	// 3. If any holes exist, then must be updated
-	if (ActiveHoles.Num() > 0)
+	// 3. Client & Standalone rebuild texture
+	//    Adding or removing a hole marks only its region dirty. Lifetime fades are evaluated in the ray march,
+	//    so only animated (baked) holes and a changed voxel AABB (texture mapping) require a full carve.
+	//    Compact formats hold the holes as of their last carve and are re-carved on hole changes, while holes
+	//    are animated, and once a carved hole expires.
+	//    A few holes skip the texture entirely and are evaluated per ray march sample (see AnalyticHoleThreshold).
+#if !UE_SERVER
+	Local_ExpirePredictedHoles();
+
+	const bool bHasHoles = ActiveHoles.Num() > 0 || PredictedHoles.Num() > 0;
+	Local_UpdateAnalyticHoleMode(bHasHoles);
+
+	const bool bCarveHoles = bHasHoles && !bAnalyticHoleMode;
+	if (bCarveHoles)
+	{
+		if (!bHoleTextureDirty || !bHoleTextureFullRebuild)
+		{
+			const TObjectPtr<AIVSmokeVoxelVolume> VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
+			const bool bVolumeChanged = VoxelVolume &&
+				(CarvedVolumeMin != FVector3f(VoxelVolume->GetVoxelWorldAABBMin()) ||
+				 CarvedVolumeMax != FVector3f(VoxelVolume->GetVoxelWorldAABBMax()));
+
+			// A relayout of the atlas moved the slot and discarded its content
+			const bool bSlotMoved = HoleAtlasSlot != INDEX_NONE &&
+				FIVSmokeHoleAtlas::Get().GetLayout(HoleAtlasFormat).Generation != CarvedAtlasGeneration;
+
+			// Half float only bakes while holes are animated, and switches back to the lifetime layout with the next carve
+			const bool bCompactFormat = HoleTextureFormat != EIVSmokeHoleTextureFormat::HalfFloat;
+			const bool bBakedStale = bCompactFormat
+				? GetSyncedTime() >= BakedHolesExpirationTime
+				: HoleTextureEncoding == EIVSmokeHoleTextureEncoding::Baked;
+
+			if (bVolumeChanged || bSlotMoved || bBakedStale || Local_HasAnimatedHoles())
+			{
+				MarkHoleTextureDirty();
+			}
+		}
+	}
+	else if (HoleTextureEncoding == EIVSmokeHoleTextureEncoding::Baked)
 	{
+		// Expired holes are removed without marking, and only the lifetime layout fades them out by itself
 		MarkHoleTextureDirty();
 	}
 
-	// 4. Client & Standalone rebuild texture
-#if !UE_SERVER
 	if (bHoleTextureDirty)
 	{
-		if (ActiveHoles.Num() > 0)
+		if (bCarveHoles)
 		{
-			Local_RebuildHoleTexture();
+			MarkHoleTextureDirty(!Local_RebuildHoleTexture());
 		}
 		else
 		{
 			Local_ClearHoleTexture();
+			MarkHoleTextureDirty(false);
 		}
-		MarkHoleTextureDirty(false);
 	}
 #endif
 }
 
 void UIVSmokeHoleGeneratorComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	if (UIVSmokeDynamicHoleSubsystem* DynamicHoleSubsystem = UWorld::GetSubsystem<UIVSmokeDynamicHoleSubsystem>(GetWorld()))
+	{
+		DynamicHoleSubsystem->UnregisterGenerator(this);
+	}
+
+#if !UE_SERVER
+	Local_ReleaseHoleTexture();
+	Local_ReleaseAnalyticHoleBudget();
+
+	// Only carves on the render thread use the hole list buffer
+	if (HoleListBuffer.IsValid())
+	{
+		ENQUEUE_RENDER_COMMAND(IVSmokeReleaseHoleList)(
+			[ListBuffer = MoveTemp(HoleListBuffer)](FRHICommandListImmediate& RHICmdList) mutable
+			{
+				ListBuffer.Reset();
+			});
+	}
+#endif
+
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -102,6 +193,7 @@ void UIVSmokeHoleGeneratorComponent::GetLifetimeReplicatedProps(TArray<FLifetime
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 	DOREPLIFETIME(UIVSmokeHoleGeneratorComponent, ActiveHoles);
+	DOREPLIFETIME_CONDITION(UIVSmokeHoleGeneratorComponent, HoleNetFrame, COND_InitialOnly);
 }
 
 //~============================================================================
@@ -113,10 +205,15 @@ void UIVSmokeHoleGeneratorComponent::Reset()
 	ActiveHoles.Empty();
 
 	// 2. Clear all dynamic subjects
-	DynamicSubjectList.Empty();
+	if (UIVSmokeDynamicHoleSubsystem* DynamicHoleSubsystem = UWorld::GetSubsystem<UIVSmokeDynamicHoleSubsystem>(GetWorld()))
+	{
+		DynamicHoleSubsystem->UnregisterGenerator(this);
+	}
 
-	// 3. Clear hole texture
+	// 3. Clear predicted holes and hole texture
 #if !UE_SERVER
+	PredictedHoles.Empty();
+	PredictedHoleDeadlines.Empty();
 	Local_ClearHoleTexture();
 #endif
 
@@ -129,39 +226,69 @@ void UIVSmokeHoleGeneratorComponent::Reset()
 #pragma region API
 void UIVSmokeHoleGeneratorComponent::CreatePenetrationHole(const FVector3f& InOrigin, const FVector3f& InDirection, const uint8 PresetID)
 {
+	const FIVSmokeHoleShot Shot(InOrigin, InDirection);
+	CreatePenetrationHoles(MakeArrayView(&Shot, 1), PresetID);
+}
+
+void UIVSmokeHoleGeneratorComponent::CreatePenetrationHoles(TConstArrayView<FIVSmokeHoleShot> Shots, const uint8 PresetID, const int32 PredictionOwnerID, TArray<uint16>* OutRejectedKeys)
+{
+	// Predicting clients drop the holes of rejected shots instead of waiting for the timeout
+	auto RejectShot = [OutRejectedKeys](const FIVSmokeHoleShot& Shot)
+	{
+		if (OutRejectedKeys && Shot.PredictionKey != 0)
+		{
+			OutRejectedKeys->Add(Shot.PredictionKey);
+		}
+	};
+
 	const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(PresetID);
 	if (!Preset)
 	{
 		UE_LOG(LogIVSmoke, Warning, TEXT("[CreatePenetrationHole] Invalid PresetID: %d"), PresetID);
+		Algo::ForEach(Shots, RejectShot);
 		return;
 	}
 
 	if (Preset->Duration <= 0.0f)
 	{
 		UE_LOG(LogIVSmoke, Warning, TEXT("[CreatePenetrationHole] Invalid Lifetime: %f"), Preset->Duration);
+		Algo::ForEach(Shots, RejectShot);
 		return;
 	}
 
 	if (Preset->HoleType != EIVSmokeHoleType::Penetration)
 	{
 		UE_LOG(LogIVSmoke, Warning, TEXT("[CreatePenetrationHole] Preset is not Penetration type"));
+		Algo::ForEach(Shots, RejectShot);
 		return;
 	}
 
-	// 1. Check whether it passes through the smoke volume
-	FVector3f EntryPoint, ExitPoint;
-	if (!Authority_CalculatePenetrationPoints(InOrigin, InDirection, Preset->BulletThickness, EntryPoint, ExitPoint))
+	const float ExpirationServerTime = GetSyncedTime() + Preset->Duration;
+
+	for (const FIVSmokeHoleShot& Shot : Shots)
 	{
-		return;
-	}
+		// 1. Check whether it passes through the smoke volume
+		FVector3f EntryPoint, ExitPoint;
+		if (!CalculatePenetrationPoints(FVector3f(Shot.Origin), FVector3f(Shot.Direction), Preset->BulletThickness, EntryPoint, ExitPoint))
+		{
+			RejectShot(Shot);
+			continue;
+		}
 
-	// 2. Create Hole
-	FIVSmokeHoleData HoleData;
-	HoleData.Position = EntryPoint;
-	HoleData.EndPosition = ExitPoint;
-	HoleData.PresetID = PresetID;
-	HoleData.ExpirationServerTime = GetSyncedTime() + Preset->Duration;
-	Authority_CreateHole(HoleData);
+		// 2. Create Hole
+		FIVSmokeHoleData HoleData;
+		HoleData.Position = EntryPoint;
+		HoleData.EndPosition = ExitPoint;
+		HoleData.PresetID = PresetID;
+		if (PredictionOwnerID != INDEX_NONE)
+		{
+			// Keys are only unique per shooter, so they are never replicated without one
+			HoleData.PredictionKey = Shot.PredictionKey;
+			HoleData.PredictionOwnerID = PredictionOwnerID;
+		}
+		HoleData.ExpirationServerTime = ExpirationServerTime;
+		Authority_CreateHole(HoleData);
+	}
 }
 
 void UIVSmokeHoleGeneratorComponent::CreateExplosionHole(const FVector3f& Origin, const uint8 PresetID)
@@ -224,23 +351,94 @@ void UIVSmokeHoleGeneratorComponent::RegisterTrackDynamicHole(AActor* TargetActo
 		return;
 	}
 
-	// 1. Check if already registered
-	for (const FIVSmokeHoleDynamicSubject& Tracker : DynamicSubjectList)
+	UIVSmokeDynamicHoleSubsystem* DynamicHoleSubsystem = UWorld::GetSubsystem<UIVSmokeDynamicHoleSubsystem>(GetWorld());
+	if (!TargetActor || !DynamicHoleSubsystem)
+	{
+		return;
+	}
+
+	// Tracked once per actor in the world registry, shared with every other generator it is registered with
+	if (!DynamicHoleSubsystem->RegisterSubject(TargetActor, this, Preset))
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[RegisterTrackDynamicHole] Actor already registered"));
+	}
+}
+
+void UIVSmokeHoleGeneratorComponent::CreateDynamicHole(const FVector3f& LastPosition, const FVector3f& CurrentPosition, const UIVSmokeHolePreset& Preset)
+{
+	FIVSmokeHoleData HoleData;
+	HoleData.Position = LastPosition;
+	HoleData.EndPosition = CurrentPosition;
+	HoleData.PresetID = Preset.GetPresetID();
+	HoleData.ExpirationServerTime = GetSyncedTime() + Preset.Duration;
+	Authority_CreateHole(HoleData);
+}
+
+bool UIVSmokeHoleGeneratorComponent::PredictPenetrationHole(const FIVSmokeHoleShot& Shot, const uint8 PresetID, const int32 PredictionOwnerID)
+{
+#if !UE_SERVER
+	const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(PresetID);
+	if (!Preset || Preset->HoleType != EIVSmokeHoleType::Penetration || Preset->Duration <= 0.0f || Shot.PredictionKey == 0 || PredictionOwnerID == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// 1. Run the same traces as the server
+	FVector3f EntryPoint, ExitPoint;
+	if (!CalculatePenetrationPoints(FVector3f(Shot.Origin), FVector3f(Shot.Direction), Preset->BulletThickness, EntryPoint, ExitPoint))
 	{
-		if (Tracker.TargetActor == TargetActor)
+		return false;
+	}
+
+	// 2. Keep it until the replicated hole with the same key and shooter arrives, the server rejects it or it times out
+	FIVSmokeHoleData& HoleData = PredictedHoles.AddDefaulted_GetRef();
+	HoleData.Position = EntryPoint;
+	HoleData.EndPosition = ExitPoint;
+	HoleData.PresetID = PresetID;
+	HoleData.PredictionKey = Shot.PredictionKey;
+	HoleData.PredictionOwnerID = PredictionOwnerID;
+	HoleData.ExpirationServerTime = GetSyncedTime() + Preset->Duration;
+	PredictedHoleDeadlines.Add(GetWorld()->GetTimeSeconds() + PredictedHoleTimeout);
+
+	MarkHoleRegionDirty(HoleData);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void UIVSmokeHoleGeneratorComponent::DropPredictedHoles(TConstArrayView<uint16> PredictionKeys)
+{
+#if !UE_SERVER
+	for (int32 i = PredictedHoles.Num() - 1; i >= 0; --i)
+	{
+		if (PredictionKeys.Contains(PredictedHoles[i].PredictionKey))
 		{
-			UE_LOG(LogIVSmoke, Warning, TEXT("[RegisterTrackDynamicHole] Actor already registered"));
-			return;
+			Local_RemovePredictedHoleAt(i);
 		}
 	}
+#endif
+}
 
-	// 2. Register new subject
-	FIVSmokeHoleDynamicSubject NewDynamicSubject;
-	NewDynamicSubject.TargetActor = TargetActor;
-	NewDynamicSubject.PresetID = PresetID;
-	NewDynamicSubject.LastWorldPosition = FVector3f(TargetActor->GetActorLocation());
-	NewDynamicSubject.LastWorldRotation = TargetActor->GetActorQuat();
-	DynamicSubjectList.Add(NewDynamicSubject);
+void UIVSmokeHoleGeneratorComponent::ReconcilePredictedHole(const FIVSmokeHoleData& Hole)
+{
+#if !UE_SERVER
+	if (Hole.PredictionKey == 0 || Hole.PredictionOwnerID == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Other shooters can use the same key, so only a hole of the shooter that predicted it confirms the prediction
+	const int32 Index = PredictedHoles.IndexOfByPredicate([&Hole](const FIVSmokeHoleData& Predicted)
+	{
+		return Predicted.PredictionKey == Hole.PredictionKey && Predicted.PredictionOwnerID == Hole.PredictionOwnerID;
+	});
+
+	if (Index != INDEX_NONE)
+	{
+		Local_RemovePredictedHoleAt(Index);
+	}
+#endif
 }
 #pragma endregion
 
@@ -252,265 +450,424 @@ void UIVSmokeHoleGeneratorComponent::Authority_CreateHole(const FIVSmokeHoleData
 	if (ActiveHoles.Num() < MaxHoles)
 	{
 		ActiveHoles.AddHole(HoleData);
+		MarkHoleRegionDirty(HoleData);
 	}
 	else
 	{
-		int32 OldestIndex = 0;
-		float MinTime = FLT_MAX;
+		// Evict the hole that expires first
+		const int32 OldestIndex = ActiveHoles.GetEarliestExpiringIndex();
+		MarkHoleRegionDirty(ActiveHoles[OldestIndex]);
 
-		for (int32 i = 0; i < ActiveHoles.Num(); ++i)
-		{
-			if (ActiveHoles[i].ExpirationServerTime < MinTime)
-			{
-				MinTime = ActiveHoles[i].ExpirationServerTime;
-				OldestIndex = i;
-			}
-		}
-
-		FIVSmokeHoleData& Target = ActiveHoles[OldestIndex];
-		Target.Position = HoleData.Position;
-		Target.EndPosition = HoleData.EndPosition;
-		Target.ExpirationServerTime = HoleData.ExpirationServerTime;
-		Target.PresetID = HoleData.PresetID;
-		ActiveHoles.MarkItemDirty(Target);
+		ActiveHoles.ReplaceHole(OldestIndex, HoleData);
+		MarkHoleRegionDirty(ActiveHoles[OldestIndex]);
 	}
-
-	MarkHoleTextureDirty();
 }
 
 void UIVSmokeHoleGeneratorComponent::Authority_CleanupExpiredHoles()
 {
 	const float CurrentServerTime = GetSyncedTime();
 
-	for (int32 i = ActiveHoles.Num() - 1; i >= 0; --i)
+	// Pop holes in expiration order; ticks without an expiry only peek the heap top
+	// Expired holes are already faded out of the texture, so removing them needs no carve
+	for (int32 Index = ActiveHoles.GetEarliestExpiringIndex();
+		 Index != INDEX_NONE && ActiveHoles[Index].IsExpired(CurrentServerTime);
+		 Index = ActiveHoles.GetEarliestExpiringIndex())
 	{
-		if (ActiveHoles[i].IsExpired(CurrentServerTime))
-		{
-			ActiveHoles.RemoveAtSwap(i);
-			MarkHoleTextureDirty();
-		}
+		ActiveHoles.RemoveAtSwap(Index);
 	}
 }
 
-bool UIVSmokeHoleGeneratorComponent::Authority_CalculatePenetrationPoints(
-	const FVector3f& Origin, const FVector3f& Direction, const float BulletThickness, FVector3f& OutEntry, FVector3f& OutExit)
+void UIVSmokeHoleGeneratorComponent::Authority_InitializeHoleNetFrame()
 {
-	FVector3f NormalizedDirection = Direction.GetSafeNormal();
-	if (NormalizedDirection.IsNearlyZero())
+	const TObjectPtr<AIVSmokeVoxelVolume> VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
+	if (!VoxelVolume)
 	{
-		UE_LOG(LogIVSmoke, Warning, TEXT("[CalculatePenetrationPoints] Direction is zero"));
-		return false;
+		return;
 	}
 
-	const float DistToCenter = FVector3f::Dist(Origin, FVector3f(GetComponentLocation()));
-	const float DiagonalLength = GetScaledBoxExtent().Size() * 2.0f;
-	const float MaxDistance = DistToCenter + DiagonalLength;
-
-	const FVector3f RayEnd = Origin + NormalizedDirection * MaxDistance;
+	// The grid diagonal covers every rotation; the margin keeps explosions near the surface quantized
+	const float GridDiagonal = FVector3f(VoxelVolume->GetGridResolution()).Size() * VoxelVolume->GetVoxelSize();
+	HoleNetFrame.Origin = FVector3f(VoxelVolume->GetActorLocation());
+	HoleNetFrame.HalfExtent = GridDiagonal * 0.75f;
+}
 
-	FHitResult HitEntry, HitExit;
-	FCollisionQueryParams QueryParams;
-	QueryParams.bTraceComplex = false;
+void UIVSmokeHoleGeneratorComponent::Authority_RefreshHoleRelevancy()
+{
+	if (HoleNetCullDistance <= 0.0f || ActiveHoles.Num() == 0 || GetNetMode() == NM_Standalone)
+	{
+		return;
+	}
 
-	// 1. Forward trace (Origin -> RayEnd) to find Entry point
-	if (!LineTraceComponent(HitEntry, FVector(Origin), FVector(RayEnd), QueryParams))
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	if (CurrentTime - LastHoleRelevancyRefreshTime < HoleRelevancyRefreshInterval)
 	{
-		return false;
+		return;
 	}
+	LastHoleRelevancyRefreshTime = CurrentTime;
 
-	// 2. Reverse trace (RayEnd -> Origin) to find Exit point
-	if (!LineTraceComponent(HitExit, FVector(RayEnd), FVector(Origin), QueryParams))
+	// Unchanged arrays skip the per item comparison, so force it to pick up connections that moved in or out of range
+	ActiveHoles.MarkArrayDirty();
+}
+
+void UIVSmokeHoleGeneratorComponent::Authority_OnSubjectBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (UIVSmokeDynamicHoleSubsystem* DynamicHoleSubsystem = UWorld::GetSubsystem<UIVSmokeDynamicHoleSubsystem>(GetWorld()))
 	{
-		OutExit = FVector3f(HitEntry.Location);
+		DynamicHoleSubsystem->SetSubjectOverlapping(OtherActor, this, true);
 	}
-	else
+}
+
+void UIVSmokeHoleGeneratorComponent::Authority_OnSubjectEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	// Actors with several overlapping primitives only leave once the last one does
+	if (OtherActor && IsOverlappingActor(OtherActor))
 	{
-		OutExit = FVector3f(HitExit.Location);
+		return;
 	}
 
-	OutEntry = FVector3f(HitEntry.Location);
+	if (UIVSmokeDynamicHoleSubsystem* DynamicHoleSubsystem = UWorld::GetSubsystem<UIVSmokeDynamicHoleSubsystem>(GetWorld()))
+	{
+		DynamicHoleSubsystem->SetSubjectOverlapping(OtherActor, this, false);
+	}
+}
+#pragma endregion
 
-	// 3. Obstacle detection using SphereTrace between Entry and Exit
-	if (ObstacleObjectTypes.Num() > 0)
+//~============================================================================
+// Local Only
+#pragma region Local Only
+#if !UE_SERVER
+void UIVSmokeHoleGeneratorComponent::Local_InitializeHoleTexture()
+{
+	const FIntVector Resolution = GetHoleTextureResolution();
+	if (Resolution.X <= 0 || Resolution.Y <= 0 || Resolution.Z <= 0)
 	{
-		TArray<FHitResult> HitResults;
-		FCollisionQueryParams WorldParams;
-		WorldParams.AddIgnoredComponent(this);
-		const FCollisionShape SweepShape = FCollisionShape::MakeSphere(BulletThickness);
-		const FCollisionObjectQueryParams ObjectParams(ObstacleObjectTypes);
+		return;
+	}
 
-		if (GetWorld()->SweepMultiByObjectType(
-			HitResults, FVector(OutEntry), FVector(OutExit), FQuat::Identity,
-			ObjectParams, SweepShape, WorldParams))
-		{
-			for (const FHitResult& Hit : HitResults)
-			{
-				if (AActor* HitActor = Hit.GetActor())
-				{
-					if (!HitActor->ActorHasTag(IVSmokeVoxelVolumeTag))
-					{
-						OutExit = FVector3f(Hit.Location);
-						break;
-					}
-				}
-			}
-		}
+	Local_ReleaseHoleTexture();
+
+	// 1. Allocate a slot in the atlas of the format
+	FIVSmokeHoleAtlas& HoleAtlas = FIVSmokeHoleAtlas::Get();
+	HoleAtlasSlot = HoleAtlas.AllocateSlot(HoleTextureFormat, Resolution);
+	if (HoleAtlasSlot == INDEX_NONE)
+	{
+		return;
 	}
 
-	return true;
+	HoleAtlasFormat = HoleTextureFormat;
+	HoleAtlasResolution = Resolution;
+	CarvedAtlasGeneration = 0;
+
+	// 2. Report memory against the half float texture at VoxelResolution this volume used to allocate.
+	//    The atlas memory itself is reported by the renderer (STAT_IVSmoke_HoleTextures)
+	const EPixelFormat PixelFormat = FIVSmokeHoleAtlas::GetPixelFormat(HoleAtlasFormat);
+	HoleTextureBaselineBytes = CalculateImageBytes(VoxelResolution.X, VoxelResolution.Y, VoxelResolution.Z, PF_FloatRGBA);
+	INC_MEMORY_STAT_BY(STAT_IVSmoke_HoleTexturesBaseline, HoleTextureBaselineBytes);
+
+	const FIVSmokeHoleAtlasLayout& Layout = HoleAtlas.GetLayout(HoleAtlasFormat);
+	UE_LOG(LogIVSmoke, Verbose, TEXT("[UIVSmokeHoleGeneratorComponent::Local_InitializeHoleTexture] %s: slot %d (%dx%dx%d %s, %.1f KB) in a %dx%dx%d atlas (half float %dx%dx%d: %.1f KB)"),
+		*GetNameSafe(GetOwner()), HoleAtlasSlot, Resolution.X, Resolution.Y, Resolution.Z, GetPixelFormatString(PixelFormat),
+		CalculateImageBytes(Resolution.X, Resolution.Y, Resolution.Z, PixelFormat) / 1024.0,
+		Layout.Resolution.X, Layout.Resolution.Y, Layout.Resolution.Z,
+		VoxelResolution.X, VoxelResolution.Y, VoxelResolution.Z, HoleTextureBaselineBytes / 1024.0);
+
+	// 3. A reused slot still holds the holes of its previous owner
+	Local_ClearHoleTexture();
 }
 
-void UIVSmokeHoleGeneratorComponent::Authority_UpdateDynamicSubjectList()
+void UIVSmokeHoleGeneratorComponent::Local_ReleaseHoleTexture()
 {
-	const float CurrentTime = GetSyncedTime();
-	const FBox3f SmokeVolume = FBox3f(Bounds.GetBox());
+	if (HoleAtlasSlot == INDEX_NONE)
+	{
+		return;
+	}
+
+	DEC_MEMORY_STAT_BY(STAT_IVSmoke_HoleTexturesBaseline, HoleTextureBaselineBytes);
+	HoleTextureBaselineBytes = 0;
+
+	FIVSmokeHoleAtlas::Get().FreeSlot(HoleAtlasFormat, HoleAtlasSlot);
+	HoleAtlasSlot = INDEX_NONE;
+	HoleAtlasResolution = FIntVector::ZeroValue;
+	CarvedAtlasGeneration = 0;
+}
 
-	for (int32 i = DynamicSubjectList.Num() - 1; i >= 0; --i)
+void UIVSmokeHoleGeneratorComponent::Local_ClearHoleTexture()
+{
+	if (HoleAtlasSlot == INDEX_NONE)
 	{
-		FIVSmokeHoleDynamicSubject& DynamicSubject = DynamicSubjectList[i];
+		return;
+	}
+
+	// Zero strength is "no hole" in the lifetime layout, so later region updates can carve on top of it.
+	// Compact formats only hold the baked layout, whose "no hole" is full density; they still record the
+	// lifetime layout so an empty texture is not cleared again (see GetHoleTextureEncoding)
+	HoleTextureEncoding = EIVSmokeHoleTextureEncoding::Lifetime;
+	HoleTimeBase = GetSyncedTime();
+	const FVector4f ClearValue = HoleAtlasFormat == EIVSmokeHoleTextureFormat::HalfFloat
+		? FVector4f(0.0f, 0.0f, 0.0f, 0.0f)
+		: FIVSmokeHoleAtlas::GetClearValue(HoleAtlasFormat);
+
+	// The whole slot is cleared, so a smaller hole texture in a larger slot leaves no stale texels behind
+	const EIVSmokeHoleTextureFormat Format = HoleAtlasFormat;
+	const FIVSmokeHoleAtlasLayout Layout = FIVSmokeHoleAtlas::Get().GetLayout(Format);
+	const FIntVector SlotMin = Layout.GetSlotMin(HoleAtlasSlot);
+	CarvedAtlasGeneration = Layout.Generation;
 
-		// 0. Delete if object is not alive
-		if (!DynamicSubject.TargetActor.IsValid())
+	ENQUEUE_RENDER_COMMAND(IVSmokeHoleClear)(
+		[Format, Layout, SlotMin, ClearValue](FRHICommandListImmediate& RHICmdList)
 		{
-			DynamicSubjectList.RemoveAtSwap(i);
-			continue;
-		}
+			FRDGBuilder GraphBuilder(RHICmdList);
+
+			const FRDGTextureRef AtlasTexture = FIVSmokeHoleAtlas::RegisterTexture(GraphBuilder, Format, Layout);
 
-		const TObjectPtr<AActor> Actor = DynamicSubject.TargetActor.Get();
-		const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(DynamicSubject.PresetID);
+			// No holes = full smoke density
+			FIVSmokeHoleAtlasClearCS::FParameters* ClearParameters = GraphBuilder.AllocParameters<FIVSmokeHoleAtlasClearCS::FParameters>();
+			ClearParameters->HoleAtlas = GraphBuilder.CreateUAV(AtlasTexture);
+			ClearParameters->ClearMin = SlotMin;
+			ClearParameters->ClearSize = Layout.SlotResolution;
+			ClearParameters->ClearValue = ClearValue;
 
-		// 0. Delete if preset is not valid
-		if (!Preset)
+			const TShaderMapRef<FIVSmokeHoleAtlasClearCS> ClearShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+			FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleAtlasClearCS>(GraphBuilder,
+				GetGlobalShaderMap(GMaxRHIFeatureLevel), ClearShader, ClearParameters, Layout.SlotResolution);
+
+			GraphBuilder.Execute();
+		}
+	);
+}
+
+void UIVSmokeHoleGeneratorComponent::Local_ExpirePredictedHoles()
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	for (int32 i = PredictedHoles.Num() - 1; i >= 0; --i)
+	{
+		if (PredictedHoleDeadlines[i] <= CurrentTime)
 		{
-			DynamicSubjectList.RemoveAtSwap(i);
-			continue;
+			Local_RemovePredictedHoleAt(i);
 		}
+	}
+}
 
-		const FVector3f CurrentPos = FVector3f(Actor->GetActorLocation());
-		const FVector3f LastPos = FVector3f(DynamicSubject.LastWorldPosition);
+void UIVSmokeHoleGeneratorComponent::Local_RemovePredictedHoleAt(const int32 Index)
+{
+	MarkHoleRegionDirty(PredictedHoles[Index]);
+	PredictedHoles.RemoveAtSwap(Index);
+	PredictedHoleDeadlines.RemoveAtSwap(Index);
+}
 
-		if (!SmokeVolume.IsInside(CurrentPos))
+bool UIVSmokeHoleGeneratorComponent::Local_HasAnimatedHoles() const
+{
+	const float CurrentServerTime = GetSyncedTime();
+
+	for (int32 i = 0; i < ActiveHoles.Num(); ++i)
+	{
+		const FIVSmokeHoleData& Hole = ActiveHoles[i];
+		if (Hole.IsExpired(CurrentServerTime))
 		{
 			continue;
 		}
 
-		// 1. Ignore if object moves a little bit
-		if (Preset->DistanceThreshold > FVector3f::Dist(CurrentPos, LastPos))
+		// Explosions expand and shrink along preset curves, which only the baked layout can express
+		const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID);
+		if (Preset && Preset->HoleType == EIVSmokeHoleType::Explosion)
 		{
-			continue;
+			return true;
 		}
-
-		// 2. Create Hole
-		FIVSmokeHoleData HoleData;
-		HoleData.Position = LastPos;
-		HoleData.EndPosition = CurrentPos;
-		HoleData.PresetID = DynamicSubject.PresetID;
-		HoleData.ExpirationServerTime = CurrentTime + Preset->Duration;
-		Authority_CreateHole(HoleData);
-
-		// 3. Update registered object
-		DynamicSubject.LastWorldPosition = CurrentPos;
-		DynamicSubject.LastWorldRotation = Actor->GetActorQuat();
 	}
+
+	return false;
 }
-#pragma endregion
 
-//~============================================================================
-// Local Only
-#pragma region Local Only
-#if !UE_SERVER
-void UIVSmokeHoleGeneratorComponent::Local_InitializeHoleTexture()
+float UIVSmokeHoleGeneratorComponent::Local_GetNextHoleExpiration(const float CurrentServerTime) const
 {
-	if (VoxelResolution.X <= 0 || VoxelResolution.Y <= 0 || VoxelResolution.Z <= 0)
+	float NextExpiration = TNumericLimits<float>::Max();
+
+	// Expired holes linger until their removal replicates, so the earliest expiration in the heap may be in the past
+	for (int32 i = 0; i < ActiveHoles.Num(); ++i)
 	{
-		return;
+		const FIVSmokeHoleData& Hole = ActiveHoles[i];
+		if (!Hole.IsExpired(CurrentServerTime))
+		{
+			NextExpiration = FMath::Min(NextExpiration, Hole.ExpirationServerTime);
+		}
 	}
 
-	// Create UTextureRenderTargetVolume
-	HoleTexture = NewObject<UTextureRenderTargetVolume>(this, TEXT("HoleTexture"));
-	HoleTexture->Init(VoxelResolution.X, VoxelResolution.Y, VoxelResolution.Z, PF_FloatRGBA);
-	HoleTexture->bCanCreateUAV = true;
-	HoleTexture->ClearColor = FLinearColor::White;
-	HoleTexture->SRGB = false;
-	HoleTexture->UpdateResourceImmediate(true);
+	for (const FIVSmokeHoleData& Hole : PredictedHoles)
+	{
+		if (!Hole.IsExpired(CurrentServerTime))
+		{
+			NextExpiration = FMath::Min(NextExpiration, Hole.ExpirationServerTime);
+		}
+	}
+
+	return NextExpiration;
 }
 
-void UIVSmokeHoleGeneratorComponent::Local_ClearHoleTexture()
+void UIVSmokeHoleGeneratorComponent::Local_UpdateAnalyticHoleMode(const bool bHasHoles)
 {
-	if (!HoleTexture)
+	// 1. Count live holes, up to the holes reserved in analytic mode or the threshold otherwise
+	const int32 MaxLiveHoles = bAnalyticHoleMode ? ReservedAnalyticHoles : AnalyticHoleThreshold;
+	bool bAnalytic = bHasHoles && MaxLiveHoles > 0 && !Local_HasAnimatedHoles();
+	if (bAnalytic)
 	{
-		return;
+		const float CurrentServerTime = GetSyncedTime();
+		int32 NumLiveHoles = PredictedHoles.Num();
+		for (int32 i = 0; i < ActiveHoles.Num() && NumLiveHoles <= MaxLiveHoles; ++i)
+		{
+			if (!ActiveHoles[i].IsExpired(CurrentServerTime))
+			{
+				++NumLiveHoles;
+			}
+		}
+		bAnalytic = NumLiveHoles <= MaxLiveHoles;
 	}
 
-	FTextureRenderTargetResource* RenderTargetResource = HoleTexture->GameThread_GetRenderTargetResource();
-	if (!RenderTargetResource)
+	if (bAnalytic == bAnalyticHoleMode)
 	{
 		return;
 	}
 
-	FTextureRHIRef Texture = RenderTargetResource->GetRenderTargetTexture();
-	if (!Texture.IsValid())
+	// 2. Enter analytic mode only if the whole threshold fits the ray march hole budget, so it never overflows
+	if (bAnalytic)
 	{
-		return;
-	}
-
-	ENQUEUE_RENDER_COMMAND(IVSmokeHoleClear)(
-		[Texture](FRHICommandListImmediate& RHICmdList)
+		UIVSmokeAnalyticHoleSubsystem* AnalyticHoleSubsystem = UWorld::GetSubsystem<UIVSmokeAnalyticHoleSubsystem>(GetWorld());
+		if (!AnalyticHoleSubsystem || !AnalyticHoleSubsystem->TryReserve(AnalyticHoleThreshold))
 		{
-			FRDGBuilder GraphBuilder(RHICmdList);
-
-			const FRDGTextureRef RDGTexture = GraphBuilder.RegisterExternalTexture(
-				CreateRenderTarget(Texture, TEXT("IVSmokeHoleTextureClear"))
-			);
+			return;
+		}
 
-			// Clear to white (1,1,1,1) = no holes = full smoke density
-			AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(RDGTexture), FVector4f(1.0f, 1.0f, 1.0f, 1.0f));
+		ReservedAnalyticHoles = AnalyticHoleThreshold;
+		bAnalyticHoleMode = true;
+	}
+	else
+	{
+		Local_ReleaseAnalyticHoleBudget();
+	}
 
-			GraphBuilder.Execute();
-		}
-	);
+	// 3. Entering clears the texture, leaving carves every hole into the cleared texture
+	MarkHoleTextureDirty();
 }
 
-void UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
+void UIVSmokeHoleGeneratorComponent::Local_ReleaseAnalyticHoleBudget()
 {
-	if (!HoleTexture)
+	if (UIVSmokeAnalyticHoleSubsystem* AnalyticHoleSubsystem = UWorld::GetSubsystem<UIVSmokeAnalyticHoleSubsystem>(GetWorld()))
 	{
-		return;
+		AnalyticHoleSubsystem->Release(ReservedAnalyticHoles);
 	}
+	ReservedAnalyticHoles = 0;
+	bAnalyticHoleMode = false;
+}
 
-	if (HoleTexture->SizeX != VoxelResolution.X ||
-		HoleTexture->SizeY != VoxelResolution.Y ||
-		HoleTexture->SizeZ != VoxelResolution.Z)
+bool UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
+{
+	const FIntVector Resolution = GetHoleTextureResolution();
+	if (HoleAtlasSlot == INDEX_NONE ||
+		HoleAtlasResolution != Resolution ||
+		HoleAtlasFormat != HoleTextureFormat)
 	{
 		Local_InitializeHoleTexture();
-		return;
+		return false;
 	}
 
-	const FTextureRenderTargetResource* RenderTargetResource = HoleTexture->GameThread_GetRenderTargetResource();
-	if (!RenderTargetResource)
+	const TObjectPtr<AIVSmokeVoxelVolume> VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
+	if (VoxelVolume == nullptr)
 	{
-		return;
+		return false;
 	}
 
-	TArray<FIVSmokeHoleGPU> GPUHoles = ActiveHoles.GetHoleGPUData(GetSyncedTime());
+	// Other slots may have grown the atlas since the last carve, which moves this slot and discards its content
+	const FIVSmokeHoleAtlasLayout AtlasLayout = FIVSmokeHoleAtlas::Get().GetLayout(HoleAtlasFormat);
+	const bool bSlotMoved = AtlasLayout.Generation != CarvedAtlasGeneration;
+	const FIntVector SlotMin = AtlasLayout.GetSlotMin(HoleAtlasSlot);
 
-	const TObjectPtr<AIVSmokeVoxelVolume> VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
-	if (VoxelVolume == nullptr)
+	const float CurrentServerTime = GetSyncedTime();
+	const int32 CapturedBlurStep = BlurStep;
+	const bool bFusedBlur = bFusedHoleBlur && CapturedBlurStep > 0 && CapturedBlurStep <= FIVSmokeHoleFusedCarveCS::MaxBlurStep;
+
+	// Region updates carve on top of the current content, so they need the same layout and time base.
+	// Compact formats cannot store lifetimes and always carve the baked layout, whose fades are only valid at the carve time
+	const bool bCompactFormat = HoleTextureFormat != EIVSmokeHoleTextureFormat::HalfFloat;
+	const EIVSmokeHoleTextureEncoding NewEncoding = (bCompactFormat || Local_HasAnimatedHoles()) ? EIVSmokeHoleTextureEncoding::Baked : EIVSmokeHoleTextureEncoding::Lifetime;
+	const bool bFullRebuild = bHoleTextureFullRebuild ||
+		bSlotMoved ||
+		NewEncoding != HoleTextureEncoding ||
+		NewEncoding == EIVSmokeHoleTextureEncoding::Baked ||
+		CurrentServerTime - HoleTimeBase > IVSmokeHoleGenerator::MaxHoleTimeBaseAge;
+
+	FIVSmokeHoleCarveRegion Region = FIVSmokeHoleCarveRegion::MakeFull(Resolution);
+	const FIVSmokeHolePresetTable::FSnapshotRef Presets = FIVSmokeHolePresetTable::Get().GetSnapshot();
+	const FIVSmokeCurveAtlas::FSnapshotRef CurveAtlas = FIVSmokeCurveAtlas::Get().GetSnapshot();
+
+	if (bFullRebuild)
 	{
-		return;
+		// Lifetime times are relative to the carve time and decoded by the ray march with GetHoleTime()
+		HoleTextureEncoding = NewEncoding;
+		HoleTimeBase = CurrentServerTime;
+		BakedHolesExpirationTime = Local_GetNextHoleExpiration(CurrentServerTime);
+		CarvedVolumeMin = FVector3f(VoxelVolume->GetVoxelWorldAABBMin());
+		CarvedVolumeMax = FVector3f(VoxelVolume->GetVoxelWorldAABBMax());
+		CarvedAtlasGeneration = AtlasLayout.Generation;
+	}
+	else if (!FIVSmokeHoleCarve::CalculateRegion(PendingDirtyBounds, CarvedVolumeMin, CarvedVolumeMax, Resolution, CapturedBlurStep, Region))
+	{
+		return true;
 	}
 
-	FTextureRHIRef Texture = RenderTargetResource->GetRenderTargetTexture();
-	if (!Texture.IsValid())
+	// Region updates carve on top of content carved at the time base, and a full rebuild just moved it to now
+	const float HoleTime = HoleTimeBase;
+
+	// Only hole list changes since the last carve are uploaded. The GPU ages the holes and drops expired ones
+	if (!HoleListBuffer.IsValid())
 	{
-		return;
+		HoleListBuffer = MakeShared<FIVSmokeHoleGPUListBuffer, ESPMode::ThreadSafe>();
+	}
+	FIVSmokeHoleGPUListUpdate ListUpdate;
+	ActiveHoles.ConsumeGPUListUpdate(CurrentServerTime, ListUpdate);
+	const TConstArrayView<FIVSmokeHoleGPU> ListHoles = ActiveHoles.GetGPUList().GetEntries();
+	const int32 NumListHoles = ListHoles.Num();
+
+	// Predicted holes are local only, so they follow the list in a small buffer built for each carve
+	TArray<FIVSmokeHoleGPU> OverlayHoles;
+	for (const FIVSmokeHoleData& Hole : PredictedHoles)
+	{
+		if (const UIVSmokeHolePreset* Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID))
+		{
+			OverlayHoles.Emplace(Hole, *Preset);
+		}
 	}
 
-	const FVector3f WorldVolumeMin = FVector3f(VoxelVolume->GetVoxelWorldAABBMin());
-	const FVector3f WorldVolumeMax = FVector3f(VoxelVolume->GetVoxelWorldAABBMax());
-	const FIntVector Resolution = VoxelResolution;
-	const int32 NumHoles = ActiveHoles.Num();
-	const int32 CapturedBlurStep = BlurStep;
+	INC_DWORD_STAT(STAT_IVSmoke_HoleTextureCarves);
+	INC_DWORD_STAT_BY(STAT_IVSmoke_HoleTextureCarvedVoxels, bFusedBlur
+		? FIVSmokeHoleCarve::CalculateFusedCarveVoxels(Region, CapturedBlurStep)
+		: Region.CarveSize.X * Region.CarveSize.Y * Region.CarveSize.Z);
+	INC_DWORD_STAT_BY(STAT_IVSmoke_HoleBufferUploadBytes, ListUpdate.GetUploadBytes() + OverlayHoles.Num() * sizeof(FIVSmokeHoleGPU));
+
+	const FVector3f WorldVolumeMin = CarvedVolumeMin;
+	const FVector3f WorldVolumeMax = CarvedVolumeMax;
+	const int32 Encoding = static_cast<int32>(HoleTextureEncoding);
+	const EIVSmokeHoleTextureFormat AtlasFormat = HoleAtlasFormat;
+	const int32 Format = static_cast<int32>(AtlasFormat);
+	const float DistortionRange = CompactDistortionRange;
+
+	// Bin holes into bricks so the carve iterates only nearby holes (indexed by EIVSmokeHoleType).
+	// Holes faded out by now are left out, which also skips removed list entries. Overlay holes follow the list entries
+	const float NoiseStrengths[] = { PenetrationNoise.Strength, ExplosionNoise.Strength, DynamicNoise.Strength };
+	FIVSmokeHoleBrickBins Bins;
+	if (OverlayHoles.IsEmpty())
+	{
+		Bins.Build(ListHoles, Presets->Entries, NoiseStrengths, CurrentServerTime, WorldVolumeMin, WorldVolumeMax, Resolution, Region);
+
+		// Zeroed dummy keeps the structured buffer valid and is never binned
+		OverlayHoles.AddZeroed(1);
+	}
+	else
+	{
+		TArray<FIVSmokeHoleGPU> BinnedHoles;
+		BinnedHoles.Reserve(NumListHoles + OverlayHoles.Num());
+		BinnedHoles.Append(ListHoles);
+		BinnedHoles.Append(OverlayHoles);
+		Bins.Build(BinnedHoles, Presets->Entries, NoiseStrengths, CurrentServerTime, WorldVolumeMin, WorldVolumeMax, Resolution, Region);
+	}
 
 	// Capture noise settings for render thread
 	FTextureRHIRef PenetrationNoiseTextureRHI = PenetrationNoise.Texture && PenetrationNoise.Texture->GetResource()
@@ -527,8 +884,9 @@ void UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
 	const float CapturedDynamicNoiseStrength = DynamicNoise.Strength;
 	const float CapturedDynamicNoiseScale = DynamicNoise.Scale;
 
-	ENQUEUE_RENDER_COMMAND(IVSmokeHoleCarveFullRebuild)(
-		[Texture, GPUHoles = MoveTemp(GPUHoles), WorldVolumeMin, WorldVolumeMax, Resolution, NumHoles, CapturedBlurStep,
+	ENQUEUE_RENDER_COMMAND(IVSmokeHoleCarve)(
+		[AtlasFormat, AtlasLayout, SlotMin, ListBuffer = HoleListBuffer, ListUpdate = MoveTemp(ListUpdate), OverlayHoles = MoveTemp(OverlayHoles), NumListHoles, HoleTime,
+		 Presets, CurveAtlas, Bins = MoveTemp(Bins), WorldVolumeMin, WorldVolumeMax, Resolution, Region, CapturedBlurStep, bFusedBlur, Encoding, Format, DistortionRange,
 		 PenetrationNoiseTextureRHI, ExplosionNoiseTextureRHI, DynamicNoiseTextureRHI,
 		 CapturedPenetrationNoiseStrength, CapturedPenetrationNoiseScale,
 		 CapturedExplosionNoiseStrength, CapturedExplosionNoiseScale,
@@ -537,29 +895,75 @@ void UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
 		{
 			FRDGBuilder GraphBuilder(RHICmdList);
 
-			const FRDGTextureRef RDGTexture = GraphBuilder.RegisterExternalTexture(
-				CreateRenderTarget(Texture, TEXT("IVSmokeHoleTexture"))
-			);
+			const FRDGTextureRef AtlasTexture = FIVSmokeHoleAtlas::RegisterTexture(GraphBuilder, AtlasFormat, AtlasLayout);
+
+			const FRDGBufferRef HoleBuffer = ListBuffer->Update(GraphBuilder, ListUpdate);
 
-			const FRDGBufferRef HoleBuffer = CreateStructuredBuffer(
+			const FRDGBufferRef OverlayHoleBuffer = CreateStructuredBuffer(
 				GraphBuilder,
-				TEXT("IVSmokeHoleBuffer"),
+				TEXT("IVSmokeOverlayHoleBuffer"),
 				sizeof(FIVSmokeHoleGPU),
-				GPUHoles.Num(),
-				GPUHoles.GetData(),
-				sizeof(FIVSmokeHoleGPU) * GPUHoles.Num()
+				OverlayHoles.Num(),
+				OverlayHoles.GetData(),
+				sizeof(FIVSmokeHoleGPU) * OverlayHoles.Num()
+			);
+
+			const FRDGBufferRef HolePresetBuffer = FIVSmokeHolePresetTable::RegisterBuffer(GraphBuilder, *Presets);
+			const FRDGBufferRef CurveAtlasBuffer = FIVSmokeCurveAtlas::RegisterBuffer(GraphBuilder, *CurveAtlas);
+
+			const FRDGBufferRef BrickRangeBuffer = CreateStructuredBuffer(
+				GraphBuilder,
+				TEXT("IVSmokeHoleBrickRanges"),
+				sizeof(FUintVector2),
+				Bins.BrickRanges.Num(),
+				Bins.BrickRanges.GetData(),
+				sizeof(FUintVector2) * Bins.BrickRanges.Num()
+			);
+
+			const FRDGBufferRef BrickHoleIndexBuffer = CreateStructuredBuffer(
+				GraphBuilder,
+				TEXT("IVSmokeHoleBrickHoleIndices"),
+				sizeof(uint32),
+				Bins.HoleIndices.Num(),
+				Bins.HoleIndices.GetData(),
+				sizeof(uint32) * Bins.HoleIndices.Num()
 			);
 
+			// Without blur the carve writes straight into the slot, and so does the fused carve and blur. The separate
+			// blur reads neighbouring texels, so it carves into a transient texture and only its last pass writes the write region into the slot
+			const EPixelFormat HoleFormat = AtlasTexture->Desc.Format;
+			const FIntVector CarveSize = Region.CarveSize;
+			const bool bBlur = CapturedBlurStep > 0 && !bFusedBlur;
+			const FRDGTextureRef CarveTexture = bBlur
+				? GraphBuilder.CreateTexture(
+					FRDGTextureDesc::Create3D(CarveSize, HoleFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV),
+					TEXT("IVSmokeHoleCarveRegion"))
+				: AtlasTexture;
+
 			// ============================================================================
-			// Pass 1: Hole Carve
+			// Pass 1: Hole Carve (fused with the blur, or followed by it)
 			// ============================================================================
-			FIVSmokeHoleCarveCS::FParameters* CarveParameters = GraphBuilder.AllocParameters<FIVSmokeHoleCarveCS::FParameters>();
-			CarveParameters->VolumeTexture = GraphBuilder.CreateUAV(RDGTexture);
+			FIVSmokeHoleFusedCarveCS::FParameters* FusedParameters = bFusedBlur ? GraphBuilder.AllocParameters<FIVSmokeHoleFusedCarveCS::FParameters>() : nullptr;
+			FIVSmokeHoleCarveCS::FParameters* CarveParameters = bFusedBlur ? &FusedParameters->Carve : GraphBuilder.AllocParameters<FIVSmokeHoleCarveCS::FParameters>();
+			CarveParameters->VolumeTexture = GraphBuilder.CreateUAV(CarveTexture);
 			CarveParameters->HoleBuffer = GraphBuilder.CreateSRV(HoleBuffer);
+			CarveParameters->OverlayHoleBuffer = GraphBuilder.CreateSRV(OverlayHoleBuffer);
+			CarveParameters->HolePresetBuffer = GraphBuilder.CreateSRV(HolePresetBuffer);
+			CarveParameters->CurveAtlas = GraphBuilder.CreateSRV(CurveAtlasBuffer);
+			CarveParameters->BrickRanges = GraphBuilder.CreateSRV(BrickRangeBuffer);
+			CarveParameters->BrickHoleIndices = GraphBuilder.CreateSRV(BrickHoleIndexBuffer);
+			CarveParameters->BrickCount = Bins.BrickCount;
 			CarveParameters->VolumeMin = WorldVolumeMin;
 			CarveParameters->VolumeMax = WorldVolumeMax;
 			CarveParameters->Resolution = Resolution;
-			CarveParameters->NumHoles = NumHoles;
+			CarveParameters->RegionMin = Region.CarveMin;
+			CarveParameters->RegionSize = CarveSize;
+			CarveParameters->OutputOffset = bBlur ? FIntVector::ZeroValue : SlotMin + (bFusedBlur ? Region.WriteMin : Region.CarveMin);
+			CarveParameters->NumListHoles = NumListHoles;
+			CarveParameters->HoleTime = HoleTime;
+			CarveParameters->HoleEncoding = Encoding;
+			CarveParameters->HoleFormat = Format;
+			CarveParameters->DistortionRange = DistortionRange;
 
 			// Noise textures (use GWhiteTexture as fallback for null textures)
 			CarveParameters->PenetrationNoiseTexture = PenetrationNoiseTextureRHI ? PenetrationNoiseTextureRHI : GWhiteTexture->TextureRHI;
@@ -575,18 +979,31 @@ void UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
 			CarveParameters->DynamicNoiseStrength = CapturedDynamicNoiseStrength;
 			CarveParameters->DynamicNoiseScale = CapturedDynamicNoiseScale;
 
-			const TShaderMapRef<FIVSmokeHoleCarveCS> CarveShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
-			FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleCarveCS>(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), CarveShader, CarveParameters, Resolution);
+			if (bFusedBlur)
+			{
+				// One group per brick of the write region, each carving its own blur apron
+				FusedParameters->BlurStep = CapturedBlurStep;
+				FusedParameters->WriteOffset = Region.WriteMin - Region.CarveMin;
+				FusedParameters->WriteSize = Region.WriteSize;
+
+				const TShaderMapRef<FIVSmokeHoleFusedCarveCS> FusedShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+				FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleFusedCarveCS>(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), FusedShader, FusedParameters, Region.WriteSize);
+			}
+			else
+			{
+				const TShaderMapRef<FIVSmokeHoleCarveCS> CarveShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+				FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleCarveCS>(GraphBuilder, GetGlobalShaderMap(GMaxRHIFeatureLevel), CarveShader, CarveParameters, CarveSize);
+			}
 
 			// ============================================================================
 			// Pass 2-4: Separable Gaussian Blur (X, Y, Z)
 			// ============================================================================
-			if (CapturedBlurStep > 0)
+			if (bBlur)
 			{
-				// Create ping-pong texture for blur
+				// Create ping-pong texture for blur (same format as the atlas, so precision matches the slot)
 				const FRDGTextureDesc BlurTexDesc = FRDGTextureDesc::Create3D(
-					FIntVector(Resolution.X, Resolution.Y, Resolution.Z),
-					PF_FloatRGBA,
+					CarveSize,
+					HoleFormat,
 					FClearValueBinding::Black,
 					TexCreate_ShaderResource | TexCreate_UAV
 				);
@@ -602,35 +1019,36 @@ void UIVSmokeHoleGeneratorComponent::Local_RebuildHoleTexture()
 					FIntVector(0, 0, 1)   // Z
 				};
 
-				const FRDGTextureRef PingPong[2] = { RDGTexture, BlurTempTexture };
-				int32 CurrentInput = 0;
+				// X: carve -> temp, Y: temp -> carve, Z: carve -> atlas slot (write region only)
+				const FRDGTextureRef Inputs[3] = { CarveTexture, BlurTempTexture, CarveTexture };
+				const FRDGTextureRef Outputs[3] = { BlurTempTexture, CarveTexture, AtlasTexture };
 
 				for (int32 i = 0; i < 3; ++i)
 				{
+					const bool bLastPass = i == 2;
+					const FIntVector DispatchSize = bLastPass ? Region.WriteSize : CarveSize;
+
 					FIVSmokeHoleBlurCS::FParameters* BlurParameters = GraphBuilder.AllocParameters<FIVSmokeHoleBlurCS::FParameters>();
-					BlurParameters->InputTexture = GraphBuilder.CreateSRV(PingPong[CurrentInput]);
+					BlurParameters->InputTexture = GraphBuilder.CreateSRV(Inputs[i]);
 					BlurParameters->InputSampler = LinearClampSampler;
-					BlurParameters->OutputTexture = GraphBuilder.CreateUAV(PingPong[1 - CurrentInput]);
-					BlurParameters->Resolution = Resolution;
+					BlurParameters->OutputTexture = GraphBuilder.CreateUAV(Outputs[i]);
+					BlurParameters->Resolution = CarveSize;
+					BlurParameters->DispatchOffset = bLastPass ? Region.WriteMin - Region.CarveMin : FIntVector::ZeroValue;
+					BlurParameters->DispatchSize = DispatchSize;
+					BlurParameters->OutputOffset = bLastPass ? SlotMin + Region.WriteMin : FIntVector::ZeroValue;
 					BlurParameters->BlurDirection = BlurDirections[i];
 					BlurParameters->BlurStep = CapturedBlurStep;
 
 					FIVSmokePostProcessPass::AddComputeShaderPass<FIVSmokeHoleBlurCS>(GraphBuilder,
-						GetGlobalShaderMap(GMaxRHIFeatureLevel), BlurShader, BlurParameters, Resolution);
-
-					CurrentInput = 1 - CurrentInput;
-				}
-
-				// If final result is in BlurTempTexture (CurrentInput == 1), copy back to RDGTexture
-				if (CurrentInput == 1)
-				{
-					AddCopyTexturePass(GraphBuilder, BlurTempTexture, RDGTexture, FRHICopyTextureInfo());
+						GetGlobalShaderMap(GMaxRHIFeatureLevel), BlurShader, BlurParameters, DispatchSize);
 				}
 			}
 
 			GraphBuilder.Execute();
 		}
 	);
+
+	return true;
 }
 #endif
 #pragma endregion
@@ -651,6 +1069,160 @@ float UIVSmokeHoleGeneratorComponent::GetSyncedTime() const
 	return 0.0f;
 }
 
+FIntVector UIVSmokeHoleGeneratorComponent::GetHoleTextureResolution() const
+{
+	const AIVSmokeVoxelVolume* VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
+	if (!bAutoVoxelResolution || !VoxelVolume || VoxelVolume->GetVoxelSize() <= 0.0f)
+	{
+		return VoxelResolution;
+	}
+
+	// The carved voxel AABB spans at most the grid plus one voxel of margin per side (see GetVoxelWorldAABBMin/Max)
+	const float VoxelSize = VoxelVolume->GetVoxelSize();
+	const FVector Extent = FVector(VoxelVolume->GetGridResolution() + FIntVector(2)) * VoxelSize;
+	const double TexelSize = VoxelSize / AutoResolutionScale;
+
+	// Whole carve bricks keep the brick bins free of partial bricks
+	auto GetAxisResolution = [TexelSize](const double AxisExtent)
+	{
+		const int32 Texels = FMath::CeilToInt32(AxisExtent / TexelSize);
+		const int32 BrickSize = FIVSmokeHoleBrickBins::BrickSize;
+		return FMath::Clamp(FMath::DivideAndRoundUp(Texels, BrickSize) * BrickSize, 2 * BrickSize, 128);
+	};
+
+	return FIntVector(GetAxisResolution(Extent.X), GetAxisResolution(Extent.Y), GetAxisResolution(Extent.Z));
+}
+
+void UIVSmokeHoleGeneratorComponent::MarkHoleTextureDirty(const bool bIsDirty)
+{
+	bHoleTextureDirty = bIsDirty;
+	bHoleTextureFullRebuild = bIsDirty;
+
+	if (!bIsDirty)
+	{
+		PendingDirtyBounds = FBox3f(ForceInit);
+	}
+}
+
+void UIVSmokeHoleGeneratorComponent::MarkHoleRegionDirty(const FIVSmokeHoleData& Hole)
+{
+	// Analytic holes are not in the texture, and leaving analytic mode carves them all
+	if (bAnalyticHoleMode)
+	{
+		return;
+	}
+
+	const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID);
+	if (!Preset)
+	{
+		return;
+	}
+
+	// Expired holes have already faded out of the texture
+	const float CurrentServerTime = GetSyncedTime();
+	if (Hole.IsExpired(CurrentServerTime))
+	{
+		return;
+	}
+
+	float NoiseStrength = 0.0f;
+	switch (Preset->HoleType)
+	{
+	case EIVSmokeHoleType::Penetration:
+		NoiseStrength = PenetrationNoise.Strength;
+		break;
+	case EIVSmokeHoleType::Explosion:
+		NoiseStrength = ExplosionNoise.Strength;
+		break;
+	case EIVSmokeHoleType::Dynamic:
+		NoiseStrength = DynamicNoise.Strength;
+		break;
+	}
+
+	FBox3f HoleBounds;
+	if (!FIVSmokeHoleCarve::CalculateHoleBounds(FIVSmokeHoleGPU(Hole, *Preset.Get()), FIVSmokeHolePresetGPU(*Preset.Get()), NoiseStrength, HoleBounds))
+	{
+		MarkHoleTextureDirty();
+		return;
+	}
+
+	PendingDirtyBounds += HoleBounds;
+	bHoleTextureDirty = true;
+}
+
+bool UIVSmokeHoleGeneratorComponent::CalculatePenetrationPoints(
+	const FVector3f& Origin, const FVector3f& Direction, const float BulletThickness, FVector3f& OutEntry, FVector3f& OutExit)
+{
+	FVector3f NormalizedDirection = Direction.GetSafeNormal();
+	if (NormalizedDirection.IsNearlyZero())
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[CalculatePenetrationPoints] Direction is zero"));
+		return false;
+	}
+
+	const TObjectPtr<AIVSmokeVoxelVolume> VoxelVolume = Cast<AIVSmokeVoxelVolume>(GetOwner());
+	if (!VoxelVolume || VoxelVolume->GetActiveVoxelNum() <= 0)
+	{
+		return false;
+	}
+
+	// 1. Ray against the voxel AABB, long enough to leave it on the far side
+	const FBox VoxelBounds(VoxelVolume->GetVoxelWorldAABBMin(), VoxelVolume->GetVoxelWorldAABBMax());
+	const FVector RayStart(Origin);
+	const double MaxDistance = FVector::Dist(RayStart, VoxelBounds.GetCenter()) + VoxelBounds.GetExtent().Size();
+	const FVector RayEnd = RayStart + FVector(NormalizedDirection) * MaxDistance;
+
+	if (!FMath::LineBoxIntersection(VoxelBounds, RayStart, RayEnd, RayEnd - RayStart))
+	{
+		return false;
+	}
+
+	// 2. DDA through the voxel grid from the first to the last active voxel, so the hole spans actual smoke
+	const FTransform ActorTransform = VoxelVolume->GetActorTransform();
+	const float InvVoxelSize = 1.0f / VoxelVolume->GetVoxelSize();
+	const FVector GridOrigin = FVector(VoxelVolume->GetCenterOffset()) + FVector(0.5f);
+	const FVector P0 = ActorTransform.InverseTransformPosition(RayStart) * InvVoxelSize + GridOrigin;
+	const FVector P1 = ActorTransform.InverseTransformPosition(RayEnd) * InvVoxelSize + GridOrigin;
+
+	float EnterT, ExitT;
+	if (!FIVSmokeBitGrid::FindSetSpan(VoxelVolume->GetVoxelBits(), VoxelVolume->GetGridResolution(), P0, P1, EnterT, ExitT))
+	{
+		return false;
+	}
+
+	OutEntry = FVector3f(FMath::Lerp(RayStart, RayEnd, static_cast<double>(EnterT)));
+	OutExit = FVector3f(FMath::Lerp(RayStart, RayEnd, static_cast<double>(ExitT)));
+
+	// 3. Obstacle detection using SphereTrace between Entry and Exit
+	if (ObstacleObjectTypes.Num() > 0)
+	{
+		TArray<FHitResult> HitResults;
+		FCollisionQueryParams WorldParams;
+		WorldParams.AddIgnoredActor(GetOwner());
+		const FCollisionShape SweepShape = FCollisionShape::MakeSphere(BulletThickness);
+		const FCollisionObjectQueryParams ObjectParams(ObstacleObjectTypes);
+
+		if (GetWorld()->SweepMultiByObjectType(
+			HitResults, FVector(OutEntry), FVector(OutExit), FQuat::Identity,
+			ObjectParams, SweepShape, WorldParams))
+		{
+			for (const FHitResult& Hit : HitResults)
+			{
+				if (AActor* HitActor = Hit.GetActor())
+				{
+					if (!HitActor->ActorHasTag(IVSmokeVoxelVolumeTag))
+					{
+						OutExit = FVector3f(Hit.Location);
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
 #if !UE_SERVER
 void UIVSmokeHoleGeneratorComponent::SetBoxToVoxelAABB()
 {
@@ -658,25 +1230,93 @@ void UIVSmokeHoleGeneratorComponent::SetBoxToVoxelAABB()
 	{
 		const FVector WorldVoxelAABBMin = VoxelVolume->GetVoxelWorldAABBMin();
 		const FVector WorldVoxelAABBMax = VoxelVolume->GetVoxelWorldAABBMax();
+
+		// 1. Most frames the AABB is unchanged, and moving the box would still propagate its transform and update overlaps
+		if (AppliedVoxelAABB.IsValid && AppliedVoxelAABB.Min == WorldVoxelAABBMin && AppliedVoxelAABB.Max == WorldVoxelAABBMax)
+		{
+			INC_DWORD_STAT(STAT_IVSmoke_HoleBoxUpdatesSkipped);
+			return;
+		}
+
 		const FVector Extent = (WorldVoxelAABBMax - WorldVoxelAABBMin) * 0.5f;
 		const FVector WorldVoxelCenter = (WorldVoxelAABBMax + WorldVoxelAABBMin) * 0.5f;
+		const bool bMoved = GetComponentLocation() != WorldVoxelCenter;
 
-		SetWorldLocation(WorldVoxelCenter);
-		SetBoxExtent(Extent, false);
+		// 2. Resize first so the move updates overlaps once for both. Without a move the resize updates them itself
+		if (GetUnscaledBoxExtent() != Extent)
+		{
+			SetBoxExtent(Extent, !bMoved);
+		}
+		if (bMoved)
+		{
+			SetWorldLocation(WorldVoxelCenter);
+		}
+
+		AppliedVoxelAABB = FBox(WorldVoxelAABBMin, WorldVoxelAABBMax);
+		INC_DWORD_STAT(STAT_IVSmoke_HoleBoxUpdatesApplied);
+	}
+}
+
+void UIVSmokeHoleGeneratorComponent::GetHoleAtlasSlot(FVector3f& OutUVMin, FVector3f& OutUVMax, uint32& OutFormat) const
+{
+	const FIVSmokeHoleAtlasLayout& Layout = FIVSmokeHoleAtlas::Get().GetLayout(HoleAtlasFormat);
+
+	// A slot whose content is from an older layout would sample whatever moved into its place
+	if (HoleAtlasSlot == INDEX_NONE || Layout.IsEmpty() || Layout.Generation != CarvedAtlasGeneration)
+	{
+		OutUVMin = FVector3f::ZeroVector;
+		OutUVMax = FVector3f::ZeroVector;
+		OutFormat = FIVSmokeHoleAtlas::NoSlotFormat;
+		return;
 	}
+
+	const FVector3f AtlasResolution(Layout.Resolution);
+	const FIntVector SlotMin = Layout.GetSlotMin(HoleAtlasSlot);
+	OutUVMin = FVector3f(SlotMin) / AtlasResolution;
+	OutUVMax = FVector3f(SlotMin + HoleAtlasResolution) / AtlasResolution;
+	OutFormat = static_cast<uint32>(HoleAtlasFormat);
 }
 
-FTextureRHIRef UIVSmokeHoleGeneratorComponent::GetHoleTextureRHI() const
+bool UIVSmokeHoleGeneratorComponent::GetAnalyticHoles(TArray<FIVSmokeHoleGPU>& OutHoles, TArray<FVector4f>& OutBounds) const
 {
-	if (HoleTexture)
+	if (!bAnalyticHoleMode)
 	{
-		if (const FTextureRenderTargetResource* Resource = HoleTexture->GameThread_GetRenderTargetResource())
+		return false;
+	}
+
+	const float CurrentServerTime = GetSyncedTime();
+	const FIVSmokeHolePresetTable& PresetTable = FIVSmokeHolePresetTable::Get();
+	auto AddHole = [&](FIVSmokeHoleGPU Hole)
+	{
+		// Faded holes and removed list entries carve nothing. Explosions have no finite bounds and are never analytic
+		const FIVSmokeHolePresetGPU& Preset = PresetTable.GetEntry(static_cast<int32>(Hole.PresetIndex));
+		FBox3f Bounds;
+		if (Hole.ExpirationTime <= CurrentServerTime || !FIVSmokeHoleCarve::CalculateHoleBounds(Hole, Preset, 0.0f, Bounds))
 		{
-			return Resource->GetRenderTargetTexture();
+			return;
 		}
+
+		// The ray march evaluates the holes at GetHoleTime()
+		Hole.ExpirationTime -= HoleTimeBase;
+		OutHoles.Add(Hole);
+		OutBounds.Add(FVector4f(Bounds.Min, 0.0f));
+		OutBounds.Add(FVector4f(Bounds.Max, 0.0f));
+	};
+
+	for (const FIVSmokeHoleGPU& Hole : ActiveHoles.GetGPUList().GetEntries())
+	{
+		AddHole(Hole);
 	}
 
-	return nullptr;
+	for (const FIVSmokeHoleData& Hole : PredictedHoles)
+	{
+		if (const UIVSmokeHolePreset* Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID))
+		{
+			AddHole(FIVSmokeHoleGPU(Hole, *Preset));
+		}
+	}
+
+	return true;
 }
 #endif
 
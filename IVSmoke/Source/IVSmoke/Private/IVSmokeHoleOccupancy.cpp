@@ -0,0 +1,754 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeHoleOccupancy.h"
+
+#include "HAL/IConsoleManager.h"
+#include "IVSmoke.h"
+#include "IVSmokeGridLibrary.h"
+#include "IVSmokeHoleData.h"
+#include "Math/RandomStream.h"
+
+DECLARE_CYCLE_STAT(TEXT("Build Hole Occupancy"), STAT_IVSmoke_BuildHoleOccupancy, STATGROUP_IVSmoke);
+DECLARE_CYCLE_STAT(TEXT("Mask Voxel Bits By Holes"), STAT_IVSmoke_MaskVoxelBitsByHoles, STATGROUP_IVSmoke);
+
+namespace IVSmokeHoleOccupancy
+{
+	/** Z offset scale of explosion holes. Must match `Explosion()` in IVSmokeHoleCarveCS.usf. */
+	static constexpr float ExplosionZScale = 0.7f;
+
+	/** Minimum bin edge length (cm). */
+	static constexpr float MinBinSize = 100.0f;
+
+	/** Upper bound of bins along a single axis. */
+	static constexpr int32 MaxBinsPerAxis = 8;
+
+	/** Movement frame of a dynamic hole. Must match the dynamic branch of IVSmokeHoleCarveCS.usf. */
+	struct FDynamicFrame
+	{
+		FVector3f Center;
+		FVector3f Right;
+		FVector3f Forward;
+		FVector3f Up;
+		float HalfX;
+		float HalfY;
+		float BodyHalfHeight;
+		float CapRadius;
+	};
+
+	static FDynamicFrame MakeDynamicFrame(const FIVSmokeHoleShape& Shape)
+	{
+		FDynamicFrame Frame;
+
+		const FVector3f Diff = Shape.EndPosition - Shape.Position;
+		const float MoveLength = Diff.Size();
+
+		Frame.Forward = MoveLength > 0.1f ? Diff / MoveLength : FVector3f(0.0f, 0.0f, 1.0f);
+		const FVector3f UpHint = FMath::Abs(Frame.Forward.Z) < 0.999f ? FVector3f(0.0f, 0.0f, 1.0f) : FVector3f(1.0f, 0.0f, 0.0f);
+		Frame.Right = FVector3f::CrossProduct(UpHint, Frame.Forward).GetSafeNormal();
+		Frame.Up = FVector3f::CrossProduct(Frame.Forward, Frame.Right);
+
+		Frame.Center = (Shape.Position + Shape.EndPosition) * 0.5f;
+		Frame.HalfX = Shape.Extent.X * 0.5f;
+		Frame.HalfY = Shape.Extent.Y * 0.5f + MoveLength * 0.5f;
+		Frame.BodyHalfHeight = Shape.Extent.Z * 0.5f * 0.8f;
+		Frame.CapRadius = Frame.HalfX;
+
+		return Frame;
+	}
+
+	static FORCEINLINE void SetLane(VectorRegister4Float& Register, const int32 Lane, const float Value)
+	{
+		reinterpret_cast<float*>(&Register)[Lane] = Value;
+	}
+
+	static FORCEINLINE void SetLaneMask(VectorRegister4Float& Register, const int32 Lane)
+	{
+		reinterpret_cast<uint32*>(&Register)[Lane] = 0xFFFFFFFFu;
+	}
+}
+
+//~==============================================================================
+// Build
+#pragma region Build
+
+void FIVSmokeHoleOccupancy::Build(const FIVSmokeHoleArray& Holes, const float CurrentServerTime)
+{
+	Shapes.Reset();
+
+	for (int32 i = 0; i < Holes.Num(); ++i)
+	{
+		const FIVSmokeHoleData& Hole = Holes[i];
+		if (Hole.IsExpired(CurrentServerTime))
+		{
+			continue;
+		}
+
+		const TObjectPtr<UIVSmokeHolePreset> Preset = UIVSmokeHolePreset::FindByID(Hole.PresetID);
+		if (!Preset)
+		{
+			continue;
+		}
+
+		FIVSmokeHoleShape& Shape = Shapes.AddDefaulted_GetRef();
+		Shape.HoleType = Preset->HoleType;
+		Shape.Position = Hole.Position;
+		Shape.EndPosition = Preset->HoleType == EIVSmokeHoleType::Explosion ? Hole.Position : Hole.EndPosition;
+		Shape.Radius = Preset->Radius;
+		Shape.EndRadius = Preset->EndRadius;
+		Shape.Extent = Preset->Extent;
+	}
+
+	BuildPackets();
+}
+
+void FIVSmokeHoleOccupancy::Build(TConstArrayView<FIVSmokeHoleShape> InShapes)
+{
+	Shapes.Reset();
+	Shapes.Append(InShapes.GetData(), InShapes.Num());
+
+	BuildPackets();
+}
+
+void FIVSmokeHoleOccupancy::Reset()
+{
+	Shapes.Reset();
+	BuildPackets();
+}
+
+void FIVSmokeHoleOccupancy::BuildPackets()
+{
+	using namespace IVSmokeHoleOccupancy;
+
+	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_BuildHoleOccupancy);
+
+	SpherePackets.Reset();
+	ConePackets.Reset();
+	DynamicPackets.Reset();
+	Bins.Reset();
+	Bounds = FBox3f(ForceInit);
+	BinCount = FIntVector::ZeroValue;
+	InvBinSize = 0.0f;
+	NumShapes = Shapes.Num();
+
+	if (NumShapes == 0)
+	{
+		return;
+	}
+
+	// 1. Shape bounds
+	ShapeBounds.SetNumUninitialized(NumShapes, EAllowShrinking::No);
+	for (int32 i = 0; i < NumShapes; ++i)
+	{
+		ShapeBounds[i] = CalculateShapeBounds(Shapes[i]);
+		Bounds += ShapeBounds[i];
+	}
+
+	// 2. Bin grid over the combined bounds
+	const FVector3f BoundsSize = Bounds.GetSize();
+	const float BinSize = FMath::Max(MinBinSize, BoundsSize.GetMax() / MaxBinsPerAxis);
+	InvBinSize = 1.0f / BinSize;
+	BinCount = FIntVector(
+		FMath::Clamp(FMath::CeilToInt(BoundsSize.X * InvBinSize), 1, MaxBinsPerAxis),
+		FMath::Clamp(FMath::CeilToInt(BoundsSize.Y * InvBinSize), 1, MaxBinsPerAxis),
+		FMath::Clamp(FMath::CeilToInt(BoundsSize.Z * InvBinSize), 1, MaxBinsPerAxis));
+
+	const int32 NumBins = BinCount.X * BinCount.Y * BinCount.Z;
+	Bins.SetNum(NumBins);
+
+	auto GetBinRange = [this](const FBox3f& Box, FIntVector& OutMin, FIntVector& OutMax)
+	{
+		const FVector3f MinCell = (Box.Min - Bounds.Min) * InvBinSize;
+		const FVector3f MaxCell = (Box.Max - Bounds.Min) * InvBinSize;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			OutMin[Axis] = FMath::Clamp(FMath::FloorToInt(MinCell[Axis]), 0, BinCount[Axis] - 1);
+			OutMax[Axis] = FMath::Clamp(FMath::FloorToInt(MaxCell[Axis]), 0, BinCount[Axis] - 1);
+		}
+	};
+
+	// 3. Counting sort of (bin, shape) pairs
+	BinShapeOffsets.Reset();
+	BinShapeOffsets.SetNumZeroed(NumBins + 1);
+
+	FIntVector CellMin, CellMax;
+	for (int32 i = 0; i < NumShapes; ++i)
+	{
+		GetBinRange(ShapeBounds[i], CellMin, CellMax);
+		for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+		{
+			for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+			{
+				for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+				{
+					++BinShapeOffsets[UIVSmokeGridLibrary::GridToIndex(FIntVector(X, Y, Z), BinCount)];
+				}
+			}
+		}
+	}
+
+	// Offsets[b] = end of bin b
+	for (int32 b = 1; b <= NumBins; ++b)
+	{
+		BinShapeOffsets[b] += BinShapeOffsets[b - 1];
+	}
+
+	// Fill backwards so every bin keeps the original hole order, leaving Offsets[b] = begin of bin b
+	BinShapeIndices.SetNumUninitialized(BinShapeOffsets[NumBins], EAllowShrinking::No);
+	for (int32 i = NumShapes - 1; i >= 0; --i)
+	{
+		GetBinRange(ShapeBounds[i], CellMin, CellMax);
+		for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+		{
+			for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+			{
+				for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+				{
+					BinShapeIndices[--BinShapeOffsets[UIVSmokeGridLibrary::GridToIndex(FIntVector(X, Y, Z), BinCount)]] = i;
+				}
+			}
+		}
+	}
+
+	// 4. Pack every bin into SoA packets
+	for (int32 b = 0; b < NumBins; ++b)
+	{
+		FBin& Bin = Bins[b];
+		Bin.SphereBegin = SpherePackets.Num();
+		Bin.ConeBegin = ConePackets.Num();
+		Bin.DynamicBegin = DynamicPackets.Num();
+
+		int32 SphereLane = 4;
+		int32 ConeLane = 4;
+		int32 DynamicLane = 4;
+
+		// BinShapeOffsets[NumBins] was never decremented and still holds the total pair count
+		for (int32 p = BinShapeOffsets[b]; p < BinShapeOffsets[b + 1]; ++p)
+		{
+			const FIVSmokeHoleShape& Shape = Shapes[BinShapeIndices[p]];
+
+			switch (Shape.HoleType)
+			{
+			case EIVSmokeHoleType::Explosion:
+			{
+				if (SphereLane == 4)
+				{
+					FSpherePacket& NewPacket = SpherePackets.AddZeroed_GetRef();
+					NewPacket.RadiusSquared = VectorSetFloat1(-1.0f);
+					SphereLane = 0;
+				}
+
+				FSpherePacket& Packet = SpherePackets.Last();
+				SetLane(Packet.CenterX, SphereLane, Shape.Position.X);
+				SetLane(Packet.CenterY, SphereLane, Shape.Position.Y);
+				SetLane(Packet.CenterZ, SphereLane, Shape.Position.Z);
+				SetLane(Packet.RadiusSquared, SphereLane, FMath::Square(Shape.Radius));
+				++SphereLane;
+				break;
+			}
+			case EIVSmokeHoleType::Penetration:
+			{
+				if (ConeLane == 4)
+				{
+					ConePackets.AddZeroed();
+					ConeLane = 0;
+				}
+
+				const FVector3f StartToEnd = Shape.EndPosition - Shape.Position;
+				const float Length = StartToEnd.Size();
+				const bool bDegenerate = Length < 0.0001f;
+				const FVector3f Dir = bDegenerate ? FVector3f::ZeroVector : StartToEnd / Length;
+
+				FConePacket& Packet = ConePackets.Last();
+				SetLane(Packet.StartX, ConeLane, Shape.Position.X);
+				SetLane(Packet.StartY, ConeLane, Shape.Position.Y);
+				SetLane(Packet.StartZ, ConeLane, Shape.Position.Z);
+				SetLane(Packet.DirX, ConeLane, Dir.X);
+				SetLane(Packet.DirY, ConeLane, Dir.Y);
+				SetLane(Packet.DirZ, ConeLane, Dir.Z);
+				SetLane(Packet.InvLength, ConeLane, bDegenerate ? 0.0f : 1.0f / Length);
+				SetLane(Packet.Radius, ConeLane, Shape.Radius);
+				SetLane(Packet.RadiusDelta, ConeLane, Shape.EndRadius - Shape.Radius);
+				SetLaneMask(Packet.LaneMask, ConeLane);
+				++ConeLane;
+				break;
+			}
+			case EIVSmokeHoleType::Dynamic:
+			{
+				if (DynamicLane == 4)
+				{
+					DynamicPackets.AddZeroed();
+					DynamicLane = 0;
+				}
+
+				const FDynamicFrame Frame = MakeDynamicFrame(Shape);
+
+				FDynamicPacket& Packet = DynamicPackets.Last();
+				SetLane(Packet.CenterX, DynamicLane, Frame.Center.X);
+				SetLane(Packet.CenterY, DynamicLane, Frame.Center.Y);
+				SetLane(Packet.CenterZ, DynamicLane, Frame.Center.Z);
+				SetLane(Packet.RightX, DynamicLane, Frame.Right.X);
+				SetLane(Packet.RightY, DynamicLane, Frame.Right.Y);
+				SetLane(Packet.RightZ, DynamicLane, Frame.Right.Z);
+				SetLane(Packet.ForwardX, DynamicLane, Frame.Forward.X);
+				SetLane(Packet.ForwardY, DynamicLane, Frame.Forward.Y);
+				SetLane(Packet.ForwardZ, DynamicLane, Frame.Forward.Z);
+				SetLane(Packet.UpX, DynamicLane, Frame.Up.X);
+				SetLane(Packet.UpY, DynamicLane, Frame.Up.Y);
+				SetLane(Packet.UpZ, DynamicLane, Frame.Up.Z);
+				SetLane(Packet.HalfX, DynamicLane, Frame.HalfX);
+				SetLane(Packet.HalfY, DynamicLane, Frame.HalfY);
+				SetLane(Packet.BodyHalfHeight, DynamicLane, Frame.BodyHalfHeight);
+				SetLane(Packet.CapRadiusSquared, DynamicLane, FMath::Square(Frame.CapRadius));
+				SetLaneMask(Packet.LaneMask, DynamicLane);
+				++DynamicLane;
+				break;
+			}
+			}
+		}
+
+		Bin.SphereNum = SpherePackets.Num() - Bin.SphereBegin;
+		Bin.ConeNum = ConePackets.Num() - Bin.ConeBegin;
+		Bin.DynamicNum = DynamicPackets.Num() - Bin.DynamicBegin;
+	}
+}
+
+FBox3f FIVSmokeHoleOccupancy::CalculateShapeBounds(const FIVSmokeHoleShape& Shape)
+{
+	using namespace IVSmokeHoleOccupancy;
+
+	switch (Shape.HoleType)
+	{
+	case EIVSmokeHoleType::Explosion:
+	{
+		const FVector3f HalfSize(Shape.Radius, Shape.Radius, Shape.Radius / ExplosionZScale);
+		return FBox3f(Shape.Position - HalfSize, Shape.Position + HalfSize);
+	}
+	case EIVSmokeHoleType::Penetration:
+	{
+		const FBox3f Segment(FVector3f::Min(Shape.Position, Shape.EndPosition), FVector3f::Max(Shape.Position, Shape.EndPosition));
+		return Segment.ExpandBy(FMath::Max(Shape.Radius, Shape.EndRadius));
+	}
+	case EIVSmokeHoleType::Dynamic:
+	default:
+	{
+		const FDynamicFrame Frame = MakeDynamicFrame(Shape);
+		const FVector3f HalfSize =
+			Frame.Right.GetAbs() * Frame.HalfX +
+			Frame.Forward.GetAbs() * FMath::Max(Frame.HalfY, Frame.CapRadius) +
+			Frame.Up.GetAbs() * (Frame.BodyHalfHeight + Frame.CapRadius);
+		return FBox3f(Frame.Center - HalfSize, Frame.Center + HalfSize);
+	}
+	}
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Query
+#pragma region Query
+
+bool FIVSmokeHoleOccupancy::IsPointCarved(const FVector3f& WorldPos) const
+{
+	if (const FBin* Bin = FindBin(WorldPos))
+	{
+		return IsPointCarvedInBin(*Bin, WorldPos);
+	}
+	return false;
+}
+
+const FIVSmokeHoleOccupancy::FBin* FIVSmokeHoleOccupancy::FindBin(const FVector3f& WorldPos) const
+{
+	if (NumShapes == 0 || !Bounds.IsInsideOrOn(WorldPos))
+	{
+		return nullptr;
+	}
+
+	const FVector3f Cell = (WorldPos - Bounds.Min) * InvBinSize;
+	const FIntVector BinPos(
+		FMath::Min(FMath::FloorToInt(Cell.X), BinCount.X - 1),
+		FMath::Min(FMath::FloorToInt(Cell.Y), BinCount.Y - 1),
+		FMath::Min(FMath::FloorToInt(Cell.Z), BinCount.Z - 1));
+
+	return &Bins[UIVSmokeGridLibrary::GridToIndex(BinPos, BinCount)];
+}
+
+bool FIVSmokeHoleOccupancy::IsPointCarvedInBin(const FBin& Bin, const FVector3f& WorldPos) const
+{
+	const VectorRegister4Float PX = VectorSetFloat1(WorldPos.X);
+	const VectorRegister4Float PY = VectorSetFloat1(WorldPos.Y);
+	const VectorRegister4Float PZ = VectorSetFloat1(WorldPos.Z);
+
+	// Explosion: |(dx, dy, dz * 0.7)| < Radius
+	const VectorRegister4Float ExplosionZScale = VectorSetFloat1(IVSmokeHoleOccupancy::ExplosionZScale);
+	for (int32 i = Bin.SphereBegin; i < Bin.SphereBegin + Bin.SphereNum; ++i)
+	{
+		const FSpherePacket& Packet = SpherePackets[i];
+
+		const VectorRegister4Float DX = VectorSubtract(PX, Packet.CenterX);
+		const VectorRegister4Float DY = VectorSubtract(PY, Packet.CenterY);
+		const VectorRegister4Float DZ = VectorMultiply(VectorSubtract(PZ, Packet.CenterZ), ExplosionZScale);
+
+		VectorRegister4Float DistSquared = VectorMultiply(DX, DX);
+		DistSquared = VectorMultiplyAdd(DY, DY, DistSquared);
+		DistSquared = VectorMultiplyAdd(DZ, DZ, DistSquared);
+
+		if (VectorMaskBits(VectorCompareLT(DistSquared, Packet.RadiusSquared)))
+		{
+			return true;
+		}
+	}
+
+	// Penetration: 0 <= t <= 1 and distance to axis < lerp(Radius, EndRadius, t)
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float One = VectorOneFloat();
+	for (int32 i = Bin.ConeBegin; i < Bin.ConeBegin + Bin.ConeNum; ++i)
+	{
+		const FConePacket& Packet = ConePackets[i];
+
+		const VectorRegister4Float SX = VectorSubtract(PX, Packet.StartX);
+		const VectorRegister4Float SY = VectorSubtract(PY, Packet.StartY);
+		const VectorRegister4Float SZ = VectorSubtract(PZ, Packet.StartZ);
+
+		VectorRegister4Float T = VectorMultiply(SX, Packet.DirX);
+		T = VectorMultiplyAdd(SY, Packet.DirY, T);
+		T = VectorMultiplyAdd(SZ, Packet.DirZ, T);
+		const VectorRegister4Float NormalizedT = VectorMultiply(T, Packet.InvLength);
+
+		VectorRegister4Float DistSquared = VectorMultiply(SX, SX);
+		DistSquared = VectorMultiplyAdd(SY, SY, DistSquared);
+		DistSquared = VectorMultiplyAdd(SZ, SZ, DistSquared);
+		DistSquared = VectorNegateMultiplyAdd(T, T, DistSquared);
+
+		const VectorRegister4Float RadiusAtT = VectorMultiplyAdd(Packet.RadiusDelta, NormalizedT, Packet.Radius);
+
+		VectorRegister4Float Mask = VectorCompareLT(DistSquared, VectorMultiply(RadiusAtT, RadiusAtT));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(NormalizedT, Zero));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareLE(NormalizedT, One));
+		Mask = VectorBitwiseAnd(Mask, Packet.LaneMask);
+
+		if (VectorMaskBits(Mask))
+		{
+			return true;
+		}
+	}
+
+	// Dynamic: box body or either sphere cap in the movement frame
+	for (int32 i = Bin.DynamicBegin; i < Bin.DynamicBegin + Bin.DynamicNum; ++i)
+	{
+		const FDynamicPacket& Packet = DynamicPackets[i];
+
+		const VectorRegister4Float LX = VectorSubtract(PX, Packet.CenterX);
+		const VectorRegister4Float LY = VectorSubtract(PY, Packet.CenterY);
+		const VectorRegister4Float LZ = VectorSubtract(PZ, Packet.CenterZ);
+
+		VectorRegister4Float X = VectorMultiply(LX, Packet.RightX);
+		X = VectorMultiplyAdd(LY, Packet.RightY, X);
+		X = VectorMultiplyAdd(LZ, Packet.RightZ, X);
+
+		VectorRegister4Float Y = VectorMultiply(LX, Packet.ForwardX);
+		Y = VectorMultiplyAdd(LY, Packet.ForwardY, Y);
+		Y = VectorMultiplyAdd(LZ, Packet.ForwardZ, Y);
+
+		VectorRegister4Float Z = VectorMultiply(LX, Packet.UpX);
+		Z = VectorMultiplyAdd(LY, Packet.UpY, Z);
+		Z = VectorMultiplyAdd(LZ, Packet.UpZ, Z);
+
+		VectorRegister4Float InBox = VectorCompareLT(VectorAbs(X), Packet.HalfX);
+		InBox = VectorBitwiseAnd(InBox, VectorCompareLT(VectorAbs(Y), Packet.HalfY));
+		InBox = VectorBitwiseAnd(InBox, VectorCompareLT(VectorAbs(Z), Packet.BodyHalfHeight));
+
+		VectorRegister4Float PlanarSquared = VectorMultiply(X, X);
+		PlanarSquared = VectorMultiplyAdd(Y, Y, PlanarSquared);
+
+		const VectorRegister4Float TopZ = VectorSubtract(Z, Packet.BodyHalfHeight);
+		const VectorRegister4Float BottomZ = VectorAdd(Z, Packet.BodyHalfHeight);
+		const VectorRegister4Float InTop = VectorCompareLT(VectorMultiplyAdd(TopZ, TopZ, PlanarSquared), Packet.CapRadiusSquared);
+		const VectorRegister4Float InBottom = VectorCompareLT(VectorMultiplyAdd(BottomZ, BottomZ, PlanarSquared), Packet.CapRadiusSquared);
+
+		const VectorRegister4Float Mask = VectorBitwiseAnd(VectorBitwiseOr(InBox, VectorBitwiseOr(InTop, InBottom)), Packet.LaneMask);
+
+		if (VectorMaskBits(Mask))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool FIVSmokeHoleOccupancy::IsPointInsideShape(const FIVSmokeHoleShape& Shape, const FVector3f& WorldPos)
+{
+	using namespace IVSmokeHoleOccupancy;
+
+	switch (Shape.HoleType)
+	{
+	case EIVSmokeHoleType::Explosion:
+	{
+		FVector3f Offset = WorldPos - Shape.Position;
+		Offset.Z *= ExplosionZScale;
+		return Offset.Size() < Shape.Radius;
+	}
+	case EIVSmokeHoleType::Penetration:
+	{
+		const FVector3f StartToEnd = Shape.EndPosition - Shape.Position;
+		const FVector3f StartToCur = WorldPos - Shape.Position;
+		const float Length = StartToEnd.Size();
+
+		FVector3f Dir = FVector3f::ZeroVector;
+		float T = 0.0f;
+		float NormalizedT = 0.0f;
+		if (Length >= 0.0001f)
+		{
+			Dir = StartToEnd / Length;
+			T = FVector3f::DotProduct(StartToCur, Dir);
+			NormalizedT = T / Length;
+		}
+
+		if (NormalizedT < 0.0f || NormalizedT > 1.0f)
+		{
+			return false;
+		}
+
+		const float RadiusAtT = FMath::Lerp(Shape.Radius, Shape.EndRadius, NormalizedT);
+		return FVector3f::Dist(WorldPos, Shape.Position + Dir * T) < RadiusAtT;
+	}
+	case EIVSmokeHoleType::Dynamic:
+	{
+		const FDynamicFrame Frame = MakeDynamicFrame(Shape);
+		const FVector3f Local = WorldPos - Frame.Center;
+		const FVector3f P(
+			FVector3f::DotProduct(Local, Frame.Right),
+			FVector3f::DotProduct(Local, Frame.Forward),
+			FVector3f::DotProduct(Local, Frame.Up));
+
+		if (FMath::Abs(P.X) < Frame.HalfX && FMath::Abs(P.Y) < Frame.HalfY && FMath::Abs(P.Z) < Frame.BodyHalfHeight)
+		{
+			return true;
+		}
+
+		return FVector3f::Dist(P, FVector3f(0.0f, 0.0f, Frame.BodyHalfHeight)) < Frame.CapRadius
+			|| FVector3f::Dist(P, FVector3f(0.0f, 0.0f, -Frame.BodyHalfHeight)) < Frame.CapRadius;
+	}
+	}
+
+	return false;
+}
+
+int32 FIVSmokeHoleOccupancy::MaskVoxelBits(TArray<uint64>& VoxelBits, const FIntVector& GridResolution, const float VoxelSize, const FTransform& LocalToWorld) const
+{
+	if (NumShapes == 0 || VoxelBits.Num() < GridResolution.Y * GridResolution.Z)
+	{
+		return 0;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_MaskVoxelBitsByHoles);
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT("IVSmoke::FIVSmokeHoleOccupancy::MaskVoxelBits");
+
+	// World position of voxel (X, Y, Z) = Origin + AxisX * X + AxisY * Y + AxisZ * Z
+	const FIntVector CenterOffset = GridResolution / 2;
+	const FVector3f Origin = FVector3f(LocalToWorld.TransformPosition(UIVSmokeGridLibrary::GridToLocal(FIntVector::ZeroValue, VoxelSize, CenterOffset)));
+	const FVector3f AxisX = FVector3f(LocalToWorld.TransformVector(FVector(VoxelSize, 0.0f, 0.0f)));
+	const FVector3f AxisY = FVector3f(LocalToWorld.TransformVector(FVector(0.0f, VoxelSize, 0.0f)));
+	const FVector3f AxisZ = FVector3f(LocalToWorld.TransformVector(FVector(0.0f, 0.0f, VoxelSize)));
+	const FVector3f RowSpan = AxisX * (GridResolution.X - 1);
+
+	int32 ClearedNum = 0;
+
+	for (int32 Z = 0; Z < GridResolution.Z; ++Z)
+	{
+		for (int32 Y = 0; Y < GridResolution.Y; ++Y)
+		{
+			const int32 Index = UIVSmokeGridLibrary::GridToVoxelBitIndex(Y, Z, GridResolution.Y);
+			uint64 Row = VoxelBits[Index];
+			if (Row == 0)
+			{
+				continue;
+			}
+
+			const FVector3f RowStart = Origin + AxisY * Y + AxisZ * Z;
+
+			// Reject rows that never enter the hole bounds
+			FBox3f RowBounds(RowStart, RowStart);
+			RowBounds += RowStart + RowSpan;
+			if (!RowBounds.Intersect(Bounds))
+			{
+				continue;
+			}
+
+			uint64 Remaining = Row;
+			while (Remaining != 0)
+			{
+				const int32 X = static_cast<int32>(FMath::CountTrailingZeros64(Remaining));
+				Remaining &= Remaining - 1;
+
+				if (IsPointCarved(RowStart + AxisX * X))
+				{
+					Row &= ~(1ULL << X);
+					++ClearedNum;
+				}
+			}
+
+			VoxelBits[Index] = Row;
+		}
+	}
+
+	return ClearedNum;
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Verification
+#pragma region Verification
+
+namespace IVSmokeHoleOccupancyCVars
+{
+	struct FExpectedPoint
+	{
+		FVector3f Position;
+		bool bCarved;
+	};
+
+	/** Evaluates hand-computed points against a single shape. Returns the number of failures. */
+	static int32 VerifyKnownShape(const TCHAR* Name, const FIVSmokeHoleShape& Shape, TConstArrayView<FExpectedPoint> Points)
+	{
+		FIVSmokeHoleOccupancy Occupancy;
+		Occupancy.Build(MakeArrayView(&Shape, 1));
+
+		int32 Failures = 0;
+		for (const FExpectedPoint& Point : Points)
+		{
+			const bool bPacked = Occupancy.IsPointCarved(Point.Position);
+			const bool bReference = FIVSmokeHoleOccupancy::IsPointInsideShape(Shape, Point.Position);
+			if (bPacked != Point.bCarved || bReference != Point.bCarved)
+			{
+				UE_LOG(LogIVSmoke, Error, TEXT("[IVSmoke.Holes] %s: (%s) expected %d, packed %d, reference %d"),
+					Name, *Point.Position.ToString(), Point.bCarved, bPacked, bReference);
+				++Failures;
+			}
+		}
+		return Failures;
+	}
+
+	static FAutoConsoleCommand Cmd_Holes_VerifyOccupancy(
+		TEXT("IVSmoke.Holes.VerifyOccupancy"),
+		TEXT("Checks the CPU hole occupancy against known hole configurations and a scalar reference on random configurations.\nUsage: IVSmoke.Holes.VerifyOccupancy [Samples]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 Samples = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100000;
+			int32 Failures = 0;
+
+			// 1. Known configurations
+			{
+				FIVSmokeHoleShape Explosion;
+				Explosion.HoleType = EIVSmokeHoleType::Explosion;
+				Explosion.Radius = 100.0f;
+
+				const FExpectedPoint Points[] = {
+					{ FVector3f(0.0f, 0.0f, 0.0f), true },
+					{ FVector3f(99.0f, 0.0f, 0.0f), true },
+					{ FVector3f(101.0f, 0.0f, 0.0f), false },
+					{ FVector3f(0.0f, 0.0f, 140.0f), true },	// 140 * 0.7 = 98
+					{ FVector3f(0.0f, 0.0f, 145.0f), false },	// 145 * 0.7 = 101.5
+				};
+				Failures += VerifyKnownShape(TEXT("Explosion"), Explosion, Points);
+			}
+			{
+				FIVSmokeHoleShape Penetration;
+				Penetration.HoleType = EIVSmokeHoleType::Penetration;
+				Penetration.EndPosition = FVector3f(1000.0f, 0.0f, 0.0f);
+				Penetration.Radius = 50.0f;
+				Penetration.EndRadius = 25.0f;
+
+				const FExpectedPoint Points[] = {
+					{ FVector3f(0.0f, 0.0f, 49.0f), true },
+					{ FVector3f(500.0f, 0.0f, 37.0f), true },	// Radius at t=0.5 is 37.5
+					{ FVector3f(500.0f, 0.0f, 38.0f), false },
+					{ FVector3f(-10.0f, 0.0f, 0.0f), false },	// No caps
+					{ FVector3f(1010.0f, 0.0f, 0.0f), false },
+				};
+				Failures += VerifyKnownShape(TEXT("Penetration"), Penetration, Points);
+			}
+			{
+				// Forward = +X, Right = +Y, Up = +Z, HalfExtent = (50, 150, 50), BodyHalfHeight = 40, CapRadius = 50
+				FIVSmokeHoleShape Dynamic;
+				Dynamic.HoleType = EIVSmokeHoleType::Dynamic;
+				Dynamic.EndPosition = FVector3f(200.0f, 0.0f, 0.0f);
+				Dynamic.Extent = FVector3f(100.0f, 100.0f, 100.0f);
+
+				const FExpectedPoint Points[] = {
+					{ FVector3f(249.0f, 0.0f, 0.0f), true },
+					{ FVector3f(251.0f, 0.0f, 0.0f), false },
+					{ FVector3f(100.0f, 49.0f, 0.0f), true },
+					{ FVector3f(100.0f, 51.0f, 0.0f), false },
+					{ FVector3f(100.0f, 0.0f, 85.0f), true },	// Inside top cap
+					{ FVector3f(100.0f, 0.0f, 95.0f), false },
+					{ FVector3f(240.0f, 0.0f, 45.0f), false },	// Above the body, outside the caps
+				};
+				Failures += VerifyKnownShape(TEXT("Dynamic"), Dynamic, Points);
+			}
+
+			// 2. Random configurations against the scalar reference
+			FRandomStream Stream(0x1F5A0E);
+			TArray<FIVSmokeHoleShape> Shapes;
+			for (int32 i = 0; i < 96; ++i)
+			{
+				FIVSmokeHoleShape& Shape = Shapes.AddDefaulted_GetRef();
+				Shape.HoleType = static_cast<EIVSmokeHoleType>(i % 3);
+				Shape.Position = FVector3f(Stream.FRandRange(-1500.0f, 1500.0f), Stream.FRandRange(-1500.0f, 1500.0f), Stream.FRandRange(-500.0f, 500.0f));
+				Shape.EndPosition = Shape.HoleType == EIVSmokeHoleType::Explosion
+					? Shape.Position
+					: Shape.Position + FVector3f(Stream.VRand()) * Stream.FRandRange(0.0f, 800.0f);
+				Shape.Radius = Stream.FRandRange(10.0f, 300.0f);
+				Shape.EndRadius = Stream.FRandRange(0.0f, 150.0f);
+				Shape.Extent = FVector3f(Stream.FRandRange(20.0f, 200.0f), Stream.FRandRange(20.0f, 200.0f), Stream.FRandRange(20.0f, 200.0f));
+			}
+
+			FIVSmokeHoleOccupancy Occupancy;
+			Occupancy.Build(Shapes);
+
+			TArray<FVector3f> Points;
+			Points.Reserve(Samples);
+			for (int32 i = 0; i < Samples; ++i)
+			{
+				Points.Add(FVector3f(Stream.FRandRange(-2000.0f, 2000.0f), Stream.FRandRange(-2000.0f, 2000.0f), Stream.FRandRange(-1000.0f, 1000.0f)));
+			}
+
+			int32 Mismatches = 0;
+			int32 CarvedNum = 0;
+
+			const double PackedStart = FPlatformTime::Seconds();
+			for (const FVector3f& Point : Points)
+			{
+				CarvedNum += Occupancy.IsPointCarved(Point) ? 1 : 0;
+			}
+			const double PackedMs = (FPlatformTime::Seconds() - PackedStart) * 1000.0;
+
+			const double ReferenceStart = FPlatformTime::Seconds();
+			for (const FVector3f& Point : Points)
+			{
+				bool bReference = false;
+				for (const FIVSmokeHoleShape& Shape : Shapes)
+				{
+					if (FIVSmokeHoleOccupancy::IsPointInsideShape(Shape, Point))
+					{
+						bReference = true;
+						break;
+					}
+				}
+
+				if (bReference != Occupancy.IsPointCarved(Point))
+				{
+					++Mismatches;
+				}
+			}
+			const double ReferenceMs = (FPlatformTime::Seconds() - ReferenceStart) * 1000.0;
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] Known configurations: %s (%d failure(s))"), Failures == 0 ? TEXT("PASS") : TEXT("FAIL"), Failures);
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] Random configuration: %d holes, %d samples, %d carved, %d mismatch(es)"), Shapes.Num(), Samples, CarvedNum, Mismatches);
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes]   Packed %.3f ms, scalar reference %.3f ms"), PackedMs, ReferenceMs);
+		})
+	);
+}
+
+#pragma endregion
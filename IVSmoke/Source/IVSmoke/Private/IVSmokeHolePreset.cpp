@@ -1,8 +1,66 @@
 ﻿// Copyright (c) 2026, Team SDB. All rights reserved.
 
 #include "IVSmokeHolePreset.h"
+#include "IVSmoke.h"
+#include "IVSmokeHolePresetTable.h"
+#include "IVSmokeSettings.h"
+#include "HAL/IConsoleManager.h"
 
-static TMap<uint8, TWeakObjectPtr<UIVSmokeHolePreset>> GHolePresetRegistry;
+UIVSmokeHolePreset* UIVSmokeHolePreset::Registry[MaxPresetIDs] = {};
+
+namespace IVSmokeHolePresetRegistry
+{
+	/** Ids handed out so far, by preset path. Never reused, so a reloaded preset gets its previous id back. */
+	static TMap<FSoftObjectPath, uint8> AssignedIDs;
+
+	/** Ids taken by AssignedIDs or reserved for a position in UIVSmokeSettings::HolePresets. */
+	static bool UsedIDs[UIVSmokeHolePreset::MaxPresetIDs] = {};
+
+	/** First id for presets missing from UIVSmokeSettings::HolePresets. 0 until the listed ids are assigned. */
+	static int32 FirstUnlistedID = 0;
+
+	/** Assigns the ids of UIVSmokeSettings::HolePresets, once. */
+	static void AssignListedIDs()
+	{
+		if (FirstUnlistedID != 0)
+		{
+			return;
+		}
+
+		const TArray<TSoftObjectPtr<UIVSmokeHolePreset>>& HolePresets = UIVSmokeSettings::Get()->HolePresets;
+		const int32 NumListed = FMath::Min(HolePresets.Num(), UIVSmokeHolePreset::MaxPresetIDs - 1);
+		if (HolePresets.Num() > NumListed)
+		{
+			UE_LOG(LogIVSmoke, Error, TEXT("[IVSmokeHolePresetRegistry::AssignListedIDs] %d hole presets listed, only the first %d get an id."),
+				HolePresets.Num(), NumListed);
+		}
+
+		// The id is the list position plus one, so appending presets keeps the ids of listed ones.
+		// Empty and duplicate entries still reserve their position
+		UsedIDs[0] = true;
+		for (int32 i = 0; i < NumListed; ++i)
+		{
+			UsedIDs[i + 1] = true;
+
+			const FSoftObjectPath& Path = HolePresets[i].ToSoftObjectPath();
+			if (!Path.IsNull() && !AssignedIDs.Contains(Path))
+			{
+				AssignedIDs.Add(Path, static_cast<uint8>(i + 1));
+			}
+		}
+		FirstUnlistedID = NumListed + 1;
+	}
+
+	/**
+	 * Returns the preferred id of a preset missing from the list, above the listed range.
+	 * Hashes the lowercase path string rather than the FName, whose hash differs between processes.
+	 */
+	static int32 GetUnlistedHomeID(const FSoftObjectPath& Path)
+	{
+		const int32 NumUnlistedIDs = UIVSmokeHolePreset::MaxPresetIDs - FirstUnlistedID;
+		return FirstUnlistedID + static_cast<int32>(FCrc::StrCrc32(*Path.ToString().ToLower()) % static_cast<uint32>(NumUnlistedIDs));
+	}
+}
 
 void UIVSmokeHolePreset::PostLoad()
 {
@@ -18,48 +76,106 @@ void UIVSmokeHolePreset::BeginDestroy()
 	Super::BeginDestroy();
 }
 
-void UIVSmokeHolePreset::RegisterToGlobalRegistry()
+#if WITH_EDITOR
+void UIVSmokeHolePreset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
-	uint8 ID = static_cast<uint8>(GetTypeHash(GetPathName()));
-	const uint8 StartID = ID;
-	TObjectPtr<UIVSmokeHolePreset> ToInsert = this;
+	Super::PostEditChangeProperty(PropertyChangedEvent);
 
-	while (TObjectPtr<UIVSmokeHolePreset> Existing = GHolePresetRegistry.FindRef(ID).Get())
+	FIVSmokeHolePresetTable::Get().Update(GPUIndex, *this);
+}
+#endif
+
+void UIVSmokeHolePreset::RegisterToGlobalRegistry()
+{
+	if (GPUIndex == INDEX_NONE)
 	{
-		if (Existing == ToInsert)
-		{
-			return;
-		}
+		GPUIndex = FIVSmokeHolePresetTable::Get().Register(*this);
+	}
 
-		if (ToInsert->GetPathName() < Existing->GetPathName())
-		{
-			GHolePresetRegistry.Remove(ID);
-			ToInsert->CachedID = ID;
-			GHolePresetRegistry.Add(ID, ToInsert);
-			ToInsert = Existing;
-		}
+	if (CachedID != 0 && Registry[CachedID] == this)
+	{
+		return;
+	}
 
-		ID++;
+	const uint8 ID = AssignPresetID();
+	if (ID == 0)
+	{
+		ensureMsgf(false, TEXT("[UIVSmokeHolePreset] Registry full: %s"), *GetName());
+		return;
+	}
 
-		if (ID == StartID)
-		{
-			ensureMsgf(false, TEXT("[UIVSmokeHolePreset] Registry full: %s"), *ToInsert->GetName());
-			return;
-		}
+	// A reloaded preset takes over the id of the instance it replaces
+	if (UIVSmokeHolePreset* Existing = Registry[ID]; Existing && Existing != this)
+	{
+		Existing->CachedID = 0;
 	}
 
-	ToInsert->CachedID = ID;
-	GHolePresetRegistry.Add(ID, ToInsert);
+	Registry[ID] = this;
+	CachedID = ID;
 }
 
 void UIVSmokeHolePreset::UnregisterFromGlobalRegistry()
 {
-	GHolePresetRegistry.Remove(CachedID);
+	if (CachedID != 0 && Registry[CachedID] == this)
+	{
+		Registry[CachedID] = nullptr;
+	}
+	CachedID = 0;
+
+	if (GPUIndex != INDEX_NONE)
+	{
+		FIVSmokeHolePresetTable::Get().Unregister(GPUIndex);
+		GPUIndex = INDEX_NONE;
+	}
 }
 
-TObjectPtr<UIVSmokeHolePreset> UIVSmokeHolePreset::FindByID(const uint8 InPresetID)
+uint8 UIVSmokeHolePreset::AssignPresetID() const
 {
-	return GHolePresetRegistry.FindRef(InPresetID).Get();
+	using namespace IVSmokeHolePresetRegistry;
+
+	AssignListedIDs();
+
+	const FSoftObjectPath Path(this);
+	if (const uint8* ID = AssignedIDs.Find(Path))
+	{
+		return *ID;
+	}
+
+	if (FirstUnlistedID >= MaxPresetIDs)
+	{
+		return 0;
+	}
+
+	// 1. Start at the id hashed from the path, so every machine derives the same id independently of load order
+	const int32 HomeID = GetUnlistedHomeID(Path);
+	const int32 NumUnlistedIDs = MaxPresetIDs - FirstUnlistedID;
+
+	// 2. Probe upwards through the unlisted range, wrapping around, for the first free id
+	for (int32 Probe = 0; Probe < NumUnlistedIDs; ++Probe)
+	{
+		const int32 ID = FirstUnlistedID + (HomeID - FirstUnlistedID + Probe) % NumUnlistedIDs;
+		if (UsedIDs[ID])
+		{
+			continue;
+		}
+
+		// Only colliding unlisted presets can end up with ids that depend on which of them registered first
+		if (Probe > 0)
+		{
+			UE_LOG(LogIVSmoke, Warning, TEXT("[UIVSmokeHolePreset::AssignPresetID] %s is not listed in the IVSmoke Hole Presets settings and its hashed id %d is taken, so it got id %d. List it so server and clients agree on its id."),
+				*Path.ToString(), HomeID, ID);
+		}
+		else
+		{
+			UE_LOG(LogIVSmoke, Log, TEXT("[UIVSmokeHolePreset::AssignPresetID] %s is not listed in the IVSmoke Hole Presets settings, using its hashed id %d."),
+				*Path.ToString(), ID);
+		}
+
+		UsedIDs[ID] = true;
+		return AssignedIDs.Add(Path, static_cast<uint8>(ID));
+	}
+
+	return 0;
 }
 
 float UIVSmokeHolePreset::GetFloatValue(const TObjectPtr<UCurveFloat> Curve, const float X)
@@ -70,3 +186,25 @@ float UIVSmokeHolePreset::GetFloatValue(const TObjectPtr<UCurveFloat> Curve, con
 	}
 	return 0;
 }
+
+namespace IVSmokeHolePresetCVars
+{
+	static FAutoConsoleCommand Cmd_Holes_DumpPresetIDs(
+		TEXT("IVSmoke.Holes.DumpPresetIDs"),
+		TEXT("Logs the id of every registered hole preset, to compare between server and clients."),
+		FConsoleCommandDelegate::CreateLambda([]()
+		{
+			int32 NumRegistered = 0;
+			for (int32 ID = 1; ID < UIVSmokeHolePreset::MaxPresetIDs; ++ID)
+			{
+				if (const UIVSmokeHolePreset* Preset = UIVSmokeHolePreset::FindByID(static_cast<uint8>(ID)))
+				{
+					UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes.DumpPresetIDs] %3d %s"), ID, *Preset->GetPathName());
+					++NumRegistered;
+				}
+			}
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes.DumpPresetIDs] %d presets registered, %d listed in settings."),
+				NumRegistered, UIVSmokeSettings::Get()->HolePresets.Num());
+		})
+	);
+}
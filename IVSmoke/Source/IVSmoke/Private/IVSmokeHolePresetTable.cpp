@@ -0,0 +1,144 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeHolePresetTable.h"
+
+#include "IVSmoke.h"
+#include "IVSmokeCurveAtlas.h"
+#include "IVSmokeHolePreset.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderResource.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hole Preset Table Uploads"), STAT_IVSmoke_HolePresetTableUploads, STATGROUP_IVSmoke);
+
+namespace IVSmokeHolePresetTable
+{
+	/** Preset buffer kept on the render thread between hole carves. */
+	class FPresetBuffer : public FRenderResource
+	{
+	public:
+		TRefCountPtr<FRDGPooledBuffer> Buffer;
+
+		/** Table version of Buffer. 0 if nothing was uploaded. */
+		uint32 Version = 0;
+
+		virtual void ReleaseRHI() override
+		{
+			Buffer.SafeRelease();
+			Version = 0;
+		}
+	};
+
+	static TGlobalResource<FPresetBuffer> GPresetBuffer;
+}
+
+FIVSmokeHolePresetGPU::FIVSmokeHolePresetGPU(const UIVSmokeHolePreset& Preset)
+{
+	HoleType = static_cast<int32>(Preset.HoleType);
+	Radius = Preset.Radius;
+	Duration = Preset.Duration;
+	Softness = Preset.Softness;
+	Extent = Preset.Extent;
+	EndRadius = Preset.EndRadius;
+	ExpansionDuration = Preset.ExpansionDuration;
+	DistortionExpOverTime = Preset.DistortionExpOverTime;
+	DistortionDistance = Preset.DistortionDistance;
+
+	FIVSmokeCurveAtlas& CurveAtlas = FIVSmokeCurveAtlas::Get();
+	ExpansionCurveRow = static_cast<uint32>(CurveAtlas.FindOrAddCurve(Preset.ExpansionFadeRangeCurveOverTime, FIVSmokeCurveAtlas::LinearRow));
+	ShrinkCurveRow = static_cast<uint32>(CurveAtlas.FindOrAddCurve(Preset.ShrinkFadeRangeCurveOverTime, FIVSmokeCurveAtlas::InverseLinearRow));
+}
+
+FIVSmokeHolePresetTable::FIVSmokeHolePresetTable()
+{
+	Entries.AddDefaulted();
+}
+
+FIVSmokeHolePresetTable& FIVSmokeHolePresetTable::Get()
+{
+	static FIVSmokeHolePresetTable Table;
+	return Table;
+}
+
+int32 FIVSmokeHolePresetTable::Register(const UIVSmokeHolePreset& Preset)
+{
+	check(IsInGameThread());
+
+	const int32 Index = FreeIndices.Num() > 0 ? FreeIndices.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+	Entries[Index] = FIVSmokeHolePresetGPU(Preset);
+	++Version;
+	return Index;
+}
+
+void FIVSmokeHolePresetTable::Update(const int32 Index, const UIVSmokeHolePreset& Preset)
+{
+	check(IsInGameThread());
+
+	if (Index <= 0 || !Entries.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	Entries[Index] = FIVSmokeHolePresetGPU(Preset);
+	++Version;
+}
+
+void FIVSmokeHolePresetTable::Unregister(const int32 Index)
+{
+	check(IsInGameThread());
+
+	if (Index <= 0 || !Entries.IsValidIndex(Index))
+	{
+		return;
+	}
+
+	Entries[Index] = FIVSmokeHolePresetGPU();
+	FreeIndices.Add(Index);
+	++Version;
+}
+
+const FIVSmokeHolePresetGPU& FIVSmokeHolePresetTable::GetEntry(const int32 Index) const
+{
+	return Entries.IsValidIndex(Index) ? Entries[Index] : Entries[0];
+}
+
+FIVSmokeHolePresetTable::FSnapshotRef FIVSmokeHolePresetTable::GetSnapshot()
+{
+	check(IsInGameThread());
+
+	if (!Snapshot.IsValid() || Snapshot->Version != Version)
+	{
+		TSharedRef<FIVSmokeHolePresetSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FIVSmokeHolePresetSnapshot, ESPMode::ThreadSafe>();
+		NewSnapshot->Entries = Entries;
+		NewSnapshot->Version = Version;
+		Snapshot = NewSnapshot;
+	}
+
+	return Snapshot.ToSharedRef();
+}
+
+FRDGBufferRef FIVSmokeHolePresetTable::RegisterBuffer(FRDGBuilder& GraphBuilder, const FIVSmokeHolePresetSnapshot& InSnapshot)
+{
+	check(IsInRenderingThread());
+
+	IVSmokeHolePresetTable::FPresetBuffer& PresetBuffer = IVSmokeHolePresetTable::GPresetBuffer;
+	if (PresetBuffer.Buffer.IsValid() && PresetBuffer.Version == InSnapshot.Version)
+	{
+		return GraphBuilder.RegisterExternalBuffer(PresetBuffer.Buffer);
+	}
+
+	INC_DWORD_STAT(STAT_IVSmoke_HolePresetTableUploads);
+
+	const FRDGBufferRef Buffer = CreateStructuredBuffer(
+		GraphBuilder,
+		TEXT("IVSmokeHolePresetBuffer"),
+		sizeof(FIVSmokeHolePresetGPU),
+		InSnapshot.Entries.Num(),
+		InSnapshot.Entries.GetData(),
+		sizeof(FIVSmokeHolePresetGPU) * InSnapshot.Entries.Num()
+	);
+
+	PresetBuffer.Buffer = GraphBuilder.ConvertToExternalBuffer(Buffer);
+	PresetBuffer.Version = InSnapshot.Version;
+	return Buffer;
+}
@@ -2,17 +2,46 @@
 
 #include "IVSmokeHoleRequestComponent.h"
 
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "IVSmoke.h"
 #include "IVSmokeHoleGeneratorComponent.h"
 #include "IVSmokeHolePreset.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Serialization/BitWriter.h"
 
 UIVSmokeHoleRequestComponent::UIVSmokeHoleRequestComponent()
 {
+	// Ticks only while shots are queued
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 	SetIsReplicatedByDefault(true);
 }
 
+void UIVSmokeHoleRequestComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	LastPredictionKey = static_cast<uint16>(FMath::RandRange(0, MAX_uint16));
+}
+
+void UIVSmokeHoleRequestComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (GetWorld()->GetTimeSeconds() - PendingSinceTime >= MaxBatchInterval)
+	{
+		FlushHoleRequests();
+	}
+}
+
+void UIVSmokeHoleRequestComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FlushHoleRequests();
+	Super::EndPlay(EndPlayReason);
+}
+
 UIVSmokeHoleRequestComponent* UIVSmokeHoleRequestComponent::GetHoleRequester(const APawn* Instigator)
 {
 	if (!Instigator)
@@ -109,3 +138,277 @@ void UIVSmokeHoleRequestComponent::RequestDynamicHole_Implementation(UIVSmokeHol
 
 	IVSmokeHoleGeneratorComponent->RegisterTrackDynamicHole(TargetActor, Preset->GetPresetID());
 }
+
+//~============================================================================
+// Batched Requests
+#pragma region Batching
+void UIVSmokeHoleRequestComponent::QueuePenetrationHole(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, const FVector3f& Origin, const FVector3f& Direction, UIVSmokeHolePreset* Preset)
+{
+	if (!IVSmokeHoleGeneratorComponent || !Preset)
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[UIVSmokeHoleRequestComponent::QueuePenetrationHole] IVSmokeHoleGeneratorComponent or Preset is null"));
+		return;
+	}
+
+	// 1. Nothing to batch on the authority
+	if (GetOwner()->HasAuthority())
+	{
+		RequestPenetrationHole(IVSmokeHoleGeneratorComponent, Origin, Direction, Preset);
+		return;
+	}
+
+	// 2. Find or add the group for this generator and preset
+	FIVSmokePendingHoleShots* Pending = PendingShots.FindByPredicate([IVSmokeHoleGeneratorComponent, Preset](const FIVSmokePendingHoleShots& Group)
+	{
+		return Group.Generator == IVSmokeHoleGeneratorComponent && Group.Preset == Preset;
+	});
+
+	if (!Pending)
+	{
+		Pending = &PendingShots.AddDefaulted_GetRef();
+		Pending->Generator = IVSmokeHoleGeneratorComponent;
+		Pending->Preset = Preset;
+		Pending->Shots.Reserve(MaxBatchShots);
+	}
+
+	if (!IsComponentTickEnabled())
+	{
+		PendingSinceTime = GetWorld()->GetTimeSeconds();
+		SetComponentTickEnabled(true);
+	}
+
+	// 3. Show the hole on this client right away, the replicated hole with the same key replaces it
+	FIVSmokeHoleShot& Shot = Pending->Shots.Emplace_GetRef(Origin, Direction);
+	if (bPredictPenetrationHoles)
+	{
+		Shot.PredictionKey = AllocatePredictionKey();
+		if (!IVSmokeHoleGeneratorComponent->PredictPenetrationHole(Shot, Preset->GetPresetID(), GetPredictionOwnerID()))
+		{
+			Shot.PredictionKey = 0;
+		}
+	}
+
+	// 4. Send early once the group is full
+	if (Pending->Shots.Num() >= MaxBatchShots)
+	{
+		FlushPendingShots(*Pending);
+	}
+}
+
+void UIVSmokeHoleRequestComponent::FlushHoleRequests()
+{
+	for (FIVSmokePendingHoleShots& Pending : PendingShots)
+	{
+		FlushPendingShots(Pending);
+	}
+
+	// Groups are kept so their shot arrays are reused by the next burst
+	PendingShots.RemoveAll([](const FIVSmokePendingHoleShots& Group)
+	{
+		return !Group.Generator.IsValid() || !Group.Preset.IsValid();
+	});
+
+	SetComponentTickEnabled(false);
+}
+
+void UIVSmokeHoleRequestComponent::FlushPendingShots(FIVSmokePendingHoleShots& Pending)
+{
+	if (Pending.Shots.IsEmpty())
+	{
+		return;
+	}
+
+	UIVSmokeHoleGeneratorComponent* Generator = Pending.Generator.Get();
+	UIVSmokeHolePreset* Preset = Pending.Preset.Get();
+	if (Generator && Preset)
+	{
+		RequestPenetrationHoleBatch(Generator, Preset, Pending.Shots);
+	}
+
+	Pending.Shots.Reset();
+}
+
+void UIVSmokeHoleRequestComponent::RequestPenetrationHoleBatch_Implementation(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, UIVSmokeHolePreset* Preset, const TArray<FIVSmokeHoleShot>& Shots)
+{
+	if (!IVSmokeHoleGeneratorComponent)
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[UIVSmokeHoleRequestComponent::RequestPenetrationHoleBatch] IVSmokeHoleGeneratorComponent is null"));
+		return;
+	}
+
+	if (!Preset)
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[UIVSmokeHoleRequestComponent::RequestPenetrationHoleBatch] Preset is null"));
+		return;
+	}
+
+	if (Preset->HoleType != EIVSmokeHoleType::Penetration)
+	{
+		UE_LOG(LogIVSmoke, Warning, TEXT("[UIVSmokeHoleRequestComponent::RequestPenetrationHoleBatch] Preset type mismatch"));
+		return;
+	}
+
+	const int32 NumShots = FMath::Min(Shots.Num(), MaxBatchShots);
+	TArray<uint16> RejectedKeys;
+	IVSmokeHoleGeneratorComponent->CreatePenetrationHoles(MakeArrayView(Shots.GetData(), NumShots), Preset->GetPresetID(), GetPredictionOwnerID(), &RejectedKeys);
+
+	// Shots beyond the limit are ignored, so their predictions are rejected as well
+	for (int32 i = NumShots; i < Shots.Num(); ++i)
+	{
+		if (Shots[i].PredictionKey != 0)
+		{
+			RejectedKeys.Add(Shots[i].PredictionKey);
+		}
+	}
+
+	if (RejectedKeys.Num() > 0)
+	{
+		ClientRejectPredictedHoles(IVSmokeHoleGeneratorComponent, RejectedKeys);
+	}
+}
+
+void UIVSmokeHoleRequestComponent::ClientRejectPredictedHoles_Implementation(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, const TArray<uint16>& PredictionKeys)
+{
+	if (IVSmokeHoleGeneratorComponent)
+	{
+		IVSmokeHoleGeneratorComponent->DropPredictedHoles(PredictionKeys);
+	}
+}
+
+uint16 UIVSmokeHoleRequestComponent::AllocatePredictionKey()
+{
+	// 0 marks unpredicted shots
+	if (++LastPredictionKey == 0)
+	{
+		++LastPredictionKey;
+	}
+	return LastPredictionKey;
+}
+
+int32 UIVSmokeHoleRequestComponent::GetPredictionOwnerID() const
+{
+	const APlayerState* PlayerState = nullptr;
+	if (const APawn* Pawn = Cast<APawn>(GetOwner()))
+	{
+		PlayerState = Pawn->GetPlayerState();
+	}
+	else if (const AController* Controller = Cast<AController>(GetOwner()))
+	{
+		PlayerState = Controller->PlayerState;
+	}
+
+	return PlayerState ? PlayerState->GetPlayerId() : INDEX_NONE;
+}
+#pragma endregion
+
+//~============================================================================
+// Console Commands
+#pragma region ConsoleCommands
+namespace IVSmokeHoleRequestCVars
+{
+	static FAutoConsoleCommand Cmd_Holes_BenchmarkRequestBatching(
+		TEXT("IVSmoke.Holes.BenchmarkRequestBatching"),
+		TEXT("Simulates sustained automatic fire and compares RPC count and parameter bytes of per-shot and batched penetration hole requests.\nUsage: IVSmoke.Holes.BenchmarkRequestBatching [RPM] [Seconds] [TickRate]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const float RPM = Args.Num() > 0 ? FMath::Max(1.0f, FCString::Atof(*Args[0])) : 900.0f;
+			const float Seconds = Args.Num() > 1 ? FMath::Max(0.1f, FCString::Atof(*Args[1])) : 10.0f;
+			const float TickRate = Args.Num() > 2 ? FMath::Max(1.0f, FCString::Atof(*Args[2])) : 60.0f;
+
+			const UIVSmokeHoleRequestComponent* Defaults = GetDefault<UIVSmokeHoleRequestComponent>();
+			const float MaxBatchInterval = Defaults->MaxBatchInterval;
+			const int32 MaxBatchShots = Defaults->MaxBatchShots;
+			const bool bPredict = Defaults->bPredictPenetrationHoles;
+
+			FRandomStream Stream(0x1F5E);
+			uint16 NextPredictionKey = 0;
+			auto MakeShot = [&Stream, &NextPredictionKey, bPredict]()
+			{
+				return FIVSmokeHoleShot(
+					FVector3f(Stream.FRandRange(-20000.0f, 20000.0f), Stream.FRandRange(-20000.0f, 20000.0f), Stream.FRandRange(0.0f, 2000.0f)),
+					FVector3f(Stream.VRand()),
+					bPredict ? ++NextPredictionKey : 0);
+			};
+
+			// 1. Per-shot RequestPenetrationHole: two raw FVector3f per RPC
+			const int32 NumShots = FMath::FloorToInt(Seconds * RPM / 60.0f);
+			int64 SingleBits = 0;
+			for (int32 i = 0; i < NumShots; ++i)
+			{
+				const FIVSmokeHoleShot Shot = MakeShot();
+				FVector3f Origin(Shot.Origin);
+				FVector3f Direction(Shot.Direction);
+
+				FBitWriter Writer(256, true);
+				Writer << Origin << Direction;
+				SingleBits += Writer.GetNumBits();
+			}
+
+			// 2. RequestPenetrationHoleBatch: replays QueuePenetrationHole and the tick flush at TickRate
+			const float ShotInterval = 60.0f / RPM;
+			const float TickInterval = 1.0f / TickRate;
+			int32 NumBatches = 0;
+			int64 BatchBits = 0;
+			int32 Pending = 0;
+			float PendingSince = 0.0f;
+			int32 NextShot = 0;
+
+			auto Flush = [&]()
+			{
+				if (Pending == 0)
+				{
+					return;
+				}
+
+				// Array length plus every FIVSmokeHoleShot property in declaration order, as the RPC sends them
+				FBitWriter Writer(0, true);
+				uint16 ArrayNum = static_cast<uint16>(Pending);
+				Writer << ArrayNum;
+				for (int32 i = 0; i < Pending; ++i)
+				{
+					FIVSmokeHoleShot Shot = MakeShot();
+					bool bSuccess = true;
+					Shot.Origin.NetSerialize(Writer, nullptr, bSuccess);
+					Shot.Direction.NetSerialize(Writer, nullptr, bSuccess);
+					Writer << Shot.PredictionKey;
+				}
+
+				BatchBits += Writer.GetNumBits();
+				++NumBatches;
+				Pending = 0;
+			};
+
+			for (float Time = 0.0f; NextShot < NumShots || Pending > 0; Time += TickInterval)
+			{
+				while (NextShot < NumShots && NextShot * ShotInterval <= Time)
+				{
+					if (Pending == 0)
+					{
+						PendingSince = Time;
+					}
+					++Pending;
+					++NextShot;
+
+					if (Pending >= MaxBatchShots)
+					{
+						Flush();
+					}
+				}
+
+				if (Pending > 0 && Time - PendingSince >= MaxBatchInterval)
+				{
+					Flush();
+				}
+			}
+
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes] %.0f RPM for %.1f s (%d shots, %.0f Hz tick, %.2f s / %d shot batches, prediction %s)"),
+				RPM, Seconds, NumShots, TickRate, MaxBatchInterval, MaxBatchShots, bPredict ? TEXT("on") : TEXT("off"));
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes]   Per shot : %6d RPCs, %8lld parameter bytes (%.1f per shot)"),
+				NumShots, (SingleBits + 7) / 8, NumShots > 0 ? SingleBits / 8.0 / NumShots : 0.0);
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes]   Batched  : %6d RPCs, %8lld parameter bytes (%.1f per shot)"),
+				NumBatches, (BatchBits + 7) / 8, NumShots > 0 ? BatchBits / 8.0 / NumShots : 0.0);
+			UE_LOG(LogIVSmoke, Log, TEXT("[IVSmoke.Holes]   Each RPC additionally carries its header and two object references (generator, preset)."));
+		})
+	);
+}
+#pragma endregion
@@ -3,4 +3,8 @@
 #include "IVSmokeHoleShaders.h"
 
 IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleCarveCS, "/Plugin/IVSmoke/IVSmokeHoleCarveCS.usf", "MainCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleFusedCarveCS, "/Plugin/IVSmoke/IVSmokeHoleCarveCS.usf", "FusedMainCS", SF_Compute);
 IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleBlurCS, "/Plugin/IVSmoke/IVSmokeHoleBlurCS.usf", "MainCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleAtlasClearCS, "/Plugin/IVSmoke/IVSmokeHoleAtlasClearCS.usf", "MainCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleListScatterCS, "/Plugin/IVSmoke/IVSmokeHoleListScatterCS.usf", "MainCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FIVSmokeHoleListCompactCS, "/Plugin/IVSmoke/IVSmokeHoleListCompactCS.usf", "MainCS", SF_Compute);
@@ -42,13 +42,15 @@ namespace IVSmokeOccupancy
 
 	/**
 	 * Add Pass 0: Tile Setup.
-	 * Computes per-tile depth range and quick volume mask.
+	 * Computes per-tile depth range, quick volume mask and analytic hole mask.
 	 */
 	void AddTileSetupPass(
 		FRDGBuilder& GraphBuilder,
 		const FSceneView& View,
 		FRDGBufferRef VolumeDataBuffer,
 		uint32 NumActiveVolumes,
+		FRDGBufferRef AnalyticHoleBoundsBuffer,
+		uint32 NumAnalyticHoles,
 		FRDGBufferRef OutTileDataBuffer,
 		const FIntPoint& TileCount,
 		uint32 StepSliceCount,
@@ -71,6 +73,10 @@ namespace IVSmokeOccupancy
 		Parameters->VolumeDataBuffer = GraphBuilder.CreateSRV(VolumeDataBuffer);
 		Parameters->NumActiveVolumes = NumActiveVolumes;
 
+		// Analytic hole bounds
+		Parameters->AnalyticHoleBounds = GraphBuilder.CreateSRV(AnalyticHoleBoundsBuffer);
+		Parameters->NumAnalyticHoles = NumAnalyticHoles;
+
 		// Tile configuration
 		Parameters->TileCount = TileCount;
 		Parameters->StepSliceCount = StepSliceCount;
@@ -29,6 +29,8 @@
 #include "PixelShaderUtils.h"
 #include "FXRenderingUtils.h"  // For UE::FXRenderingUtils::GetRawViewRectUnsafe
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Analytic Holes (Per Frame)"), STAT_IVSmoke_AnalyticHoles, STATGROUP_IVSmoke);
+
 #if !UE_SERVER
 FIVSmokeRenderer& FIVSmokeRenderer::Get()
 {
@@ -357,32 +359,17 @@ FIVSmokePackedRenderData FIVSmokeRenderer::PrepareRenderData(const TArray<AIVSmo
 
 	Result.VolumeCount = VolumesToProcess.Num();
 	Result.VolumeDataArray.Reserve(Result.VolumeCount);
-	Result.HoleTextures.Reserve(Result.VolumeCount);
-	Result.HoleTextureSizes.Reserve(Result.VolumeCount);
 
-	// Get resolution info from first valid volume
+	// Get voxel resolution from first valid volume
 	for (AIVSmokeVoxelVolume* Volume : VolumesToProcess)
 	{
 		if (Volume)
 		{
 			Result.VoxelResolution = Volume->GetGridResolution();
-			if (UIVSmokeHoleGeneratorComponent* HoleComp = Volume->GetHoleGeneratorComponent())
-			{
-				if (FTextureRHIRef HoleTex = HoleComp->GetHoleTextureRHI())
-				{
-					Result.HoleResolution = HoleTex->GetSizeXYZ();
-				}
-			}
 			break;
 		}
 	}
 
-	// Fallback for hole resolution
-	if (Result.HoleResolution == FIntVector::ZeroValue)
-	{
-		Result.HoleResolution = FIntVector(64, 64, 64);
-	}
-
 	// Calculate packed buffer sizes
 	const int32 TexturePackInterval = 4;
 	TArray<float> VoxelIntervalData;
@@ -420,27 +407,6 @@ FIVSmokePackedRenderData FIVSmokeRenderer::PrepareRenderData(const TArray<AIVSmo
 			Result.PackedVoxelDeathTimes.Append(VoxelIntervalData);
 		}
 
-		//~==========================================================================
-		// Hole Texture reference (RHI resources are thread-safe)
-		if (UIVSmokeHoleGeneratorComponent* HoleComp = Volume->GetHoleGeneratorComponent())
-		{
-			FTextureRHIRef HoleTex = HoleComp->GetHoleTextureRHI();
-			Result.HoleTextures.Add(HoleTex);
-			if (HoleTex)
-			{
-				Result.HoleTextureSizes.Add(HoleTex->GetSizeXYZ());
-			}
-			else
-			{
-				Result.HoleTextureSizes.Add(FIntVector::ZeroValue);
-			}
-		}
-		else
-		{
-			Result.HoleTextures.Add(nullptr);
-			Result.HoleTextureSizes.Add(FIntVector::ZeroValue);
-		}
-
 		//~==========================================================================
 		// Build GPU metadata
 		const FIntVector GridRes = Volume->GetGridResolution();
@@ -474,6 +440,38 @@ FIVSmokePackedRenderData FIVSmokeRenderer::PrepareRenderData(const TArray<AIVSmo
 		GPUData.VoxelWorldAABBMax = FVector3f(Volume->GetVoxelWorldAABBMax());
 		GPUData.FadeInDuration = Volume->FadeInDuration;
 		GPUData.FadeOutDuration = Volume->FadeOutDuration;
+		GPUData.FadeInCurveRow = static_cast<uint32>(Volume->GetFadeInCurveRow());
+		GPUData.FadeOutCurveRow = static_cast<uint32>(Volume->GetFadeOutCurveRow());
+
+		if (const UIVSmokeHoleGeneratorComponent* HoleComp = Volume->GetHoleGeneratorComponent())
+		{
+			GPUData.HoleTime = HoleComp->GetHoleTime();
+			GPUData.HoleEncoding = static_cast<uint32>(HoleComp->GetHoleTextureEncoding());
+			GPUData.HoleDistortionRange = HoleComp->CompactDistortionRange;
+			HoleComp->GetHoleAtlasSlot(GPUData.HoleUVMin, GPUData.HoleUVMax, GPUData.HoleFormat);
+
+			// Few holes are evaluated by the ray march instead of the hole texture. Generators reserve their share of
+			// the tile hole mask, so the budget only overflows for a frame before a generator falls back to the texture
+			const int32 FirstAnalyticHole = Result.AnalyticHoles.Num();
+			if (HoleComp->GetAnalyticHoles(Result.AnalyticHoles, Result.AnalyticHoleBounds))
+			{
+				if (Result.AnalyticHoles.Num() > static_cast<int32>(FIVSmokeOccupancyConfig::MaxAnalyticHoles))
+				{
+					Result.AnalyticHoles.SetNum(FirstAnalyticHole);
+					Result.AnalyticHoleBounds.SetNum(FirstAnalyticHole * 2);
+				}
+
+				for (int32 HoleIndex = FirstAnalyticHole; HoleIndex < Result.AnalyticHoles.Num(); ++HoleIndex)
+				{
+					GPUData.AnalyticHoleMask[HoleIndex / 32] |= 1u << (HoleIndex % 32);
+				}
+			}
+		}
+		else
+		{
+			GPUData.HoleDistortionRange = 1.0f;
+			GPUData.HoleFormat = FIVSmokeHoleAtlas::NoSlotFormat;
+		}
 
 		if (Preset)
 		{
@@ -661,6 +659,18 @@ FIVSmokePackedRenderData FIVSmokeRenderer::PrepareRenderData(const TArray<AIVSmo
 		}
 	}
 
+	Result.CurveAtlas = FIVSmokeCurveAtlas::Get().GetSnapshot();
+	Result.HoleAtlas = FIVSmokeHoleAtlas::Get().GetSnapshot();
+	Result.HolePresets = FIVSmokeHolePresetTable::Get().GetSnapshot();
+
+	// The analytic hole buffers are bound even without analytic holes
+	Result.NumAnalyticHoles = Result.AnalyticHoles.Num();
+	INC_DWORD_STAT_BY(STAT_IVSmoke_AnalyticHoles, Result.NumAnalyticHoles);
+	if (Result.AnalyticHoles.IsEmpty())
+	{
+		Result.AnalyticHoles.AddZeroed(1);
+		Result.AnalyticHoleBounds.AddZeroed(2);
+	}
 	Result.bIsValid = Result.VolumeDataArray.Num() && Result.PackedVoxelBirthTimes.Num() > 0 && Result.PackedVoxelDeathTimes.Num() > 0;
 
 	if (VolumesToProcess.Num() > 0 && VolumesToProcess[0])
@@ -982,9 +992,7 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	const int32 TexturePackInterval = 4;
 	const int32 TexturePackMaxSize = 2048;
 	const FIntVector VoxelResolution = RenderData.VoxelResolution;
-	const FIntVector HoleResolution = RenderData.HoleResolution;
 	const FIntVector VoxelAtlasCount = GetAtlasTexCount(VoxelResolution, VolumeCount, TexturePackInterval, TexturePackMaxSize);
-	const FIntVector HoleAtlasCount = GetAtlasTexCount(HoleResolution, VolumeCount, TexturePackInterval, TexturePackMaxSize);
 
 	// Voxel Atlas: 3D packing
 	const FIntVector VoxelAtlasResolution = FIntVector(
@@ -994,13 +1002,6 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	);
 	const FIntVector VoxelAtlasFXAAResolution = VoxelAtlasResolution * 1;
 
-	// Hole Atlas: 3D packing
-	const FIntVector HoleAtlasResolution = FIntVector(
-		HoleResolution.X * HoleAtlasCount.X + TexturePackInterval * (HoleAtlasCount.X - 1),
-		HoleResolution.Y * HoleAtlasCount.Y + TexturePackInterval * (HoleAtlasCount.Y - 1),
-		HoleResolution.Z * HoleAtlasCount.Z + TexturePackInterval * (HoleAtlasCount.Z - 1)
-	);
-
 	// Create atlas textures
 	FRDGTextureDesc VoxelAtlasDesc = FRDGTextureDesc::Create3D(
 		VoxelAtlasResolution,
@@ -1018,51 +1019,14 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	);
 	FRDGTextureRef PackedVoxelAtlasFXAA = GraphBuilder.CreateTexture(VoxelAtlasFXAAResDesc, TEXT("IVSmoke_PackedVoxelAtlasFXAA"));
 
-	FRDGTextureDesc HoleAtlasDesc = FRDGTextureDesc::Create3D(
-		HoleAtlasResolution,
-		PF_FloatRGBA,
-		FClearValueBinding::None,
-		TexCreate_ShaderResource | TexCreate_UAV
-	);
-	FRDGTextureRef PackedHoleAtlas = GraphBuilder.CreateTexture(HoleAtlasDesc, TEXT("IVSmoke_PackedHoleAtlas"));
-
-	// Clear Hole Atlas with alpha = 1 (so density is not zeroed when HoleTexture is missing)
-	AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(PackedHoleAtlas), FLinearColor(0.0f, 0.0f, 0.0f, 1.0f));
-
-	// Copy Hole Textures to Atlas
-	FRHICopyTextureInfo HoleCpyInfo;
-	HoleCpyInfo.Size = HoleResolution;
-	HoleCpyInfo.SourcePosition = FIntVector::ZeroValue;
-
-	for (int z = 0; z < HoleAtlasCount.Z; ++z)
+	// Hole Atlases: persistent, carved in place by each UIVSmokeHoleGeneratorComponent (see FIVSmokeHoleAtlas)
+	FRDGTextureRef PackedHoleAtlases[IVSmokeHoleAtlas::NumFormats];
+	FVector3f HoleAtlasTexelSizes[IVSmokeHoleAtlas::NumFormats];
+	for (int32 i = 0; i < IVSmokeHoleAtlas::NumFormats; ++i)
 	{
-		for (int y = 0; y < HoleAtlasCount.Y; ++y)
-		{
-			for (int x = 0; x < HoleAtlasCount.X; ++x)
-			{
-				int i = x + HoleAtlasCount.X * y + z * HoleAtlasCount.X * HoleAtlasCount.Y;
-
-				if (i >= RenderData.HoleTextures.Num())
-				{
-					break;
-				}
-
-				FTextureRHIRef SourceRHI = RenderData.HoleTextures[i];
-				if (!SourceRHI)
-				{
-					continue;
-				}
-
-				FRDGTextureRef SourceTexture = GraphBuilder.RegisterExternalTexture(
-					CreateRenderTarget(SourceRHI, TEXT("IVSmoke_CopyHoleSource"))
-				);
-
-				HoleCpyInfo.DestPosition.X = x * (HoleResolution.X + TexturePackInterval);
-				HoleCpyInfo.DestPosition.Y = y * (HoleResolution.Y + TexturePackInterval);
-				HoleCpyInfo.DestPosition.Z = z * (HoleResolution.Z + TexturePackInterval);
-				AddCopyTexturePass(GraphBuilder, SourceTexture, PackedHoleAtlas, HoleCpyInfo);
-			}
-		}
+		const FIVSmokeHoleAtlasLayout& Layout = RenderData.HoleAtlas->Layouts[i];
+		PackedHoleAtlases[i] = FIVSmokeHoleAtlas::RegisterTexture(GraphBuilder, static_cast<EIVSmokeHoleTextureFormat>(i), Layout);
+		HoleAtlasTexelSizes[i] = Layout.IsEmpty() ? FVector3f::ZeroVector : FVector3f(1.0f) / FVector3f(Layout.Resolution);
 	}
 
 	// Create GPU buffers
@@ -1080,6 +1044,24 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	FRDGBufferRef VolumeBuffer = GraphBuilder.CreateBuffer(VolumeBufferDesc, TEXT("IVSmokeVolumeDataBuffer"));
 	GraphBuilder.QueueBufferUpload(VolumeBuffer, RenderData.VolumeDataArray.GetData(), RenderData.VolumeDataArray.Num() * sizeof(FIVSmokeVolumeGPUData));
 
+	const FRDGBufferRef AnalyticHoleBuffer = CreateStructuredBuffer(
+		GraphBuilder,
+		TEXT("IVSmokeAnalyticHoleBuffer"),
+		sizeof(FIVSmokeHoleGPU),
+		RenderData.AnalyticHoles.Num(),
+		RenderData.AnalyticHoles.GetData(),
+		sizeof(FIVSmokeHoleGPU) * RenderData.AnalyticHoles.Num()
+	);
+
+	const FRDGBufferRef AnalyticHoleBoundsBuffer = CreateStructuredBuffer(
+		GraphBuilder,
+		TEXT("IVSmokeAnalyticHoleBounds"),
+		sizeof(FVector4f),
+		RenderData.AnalyticHoleBounds.Num(),
+		RenderData.AnalyticHoleBounds.GetData(),
+		sizeof(FVector4f) * RenderData.AnalyticHoleBounds.Num()
+	);
+
 	// StructuredToTexture Pass
 	TShaderMapRef<FIVSmokeStructuredToTextureCS> StructuredCopyShader(ShaderMap);
 	auto* StructuredCopyParams = GraphBuilder.AllocParameters<FIVSmokeStructuredToTextureCS::FParameters>();
@@ -1087,6 +1069,7 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	StructuredCopyParams->BirthTimes = GraphBuilder.CreateSRV(BirthBuffer);
 	StructuredCopyParams->DeathTimes = GraphBuilder.CreateSRV(DeathBuffer);
 	StructuredCopyParams->VolumeDataBuffer = GraphBuilder.CreateSRV(VolumeBuffer);
+	StructuredCopyParams->CurveAtlas = GraphBuilder.CreateSRV(FIVSmokeCurveAtlas::RegisterBuffer(GraphBuilder, *RenderData.CurveAtlas));
 	StructuredCopyParams->TexSize = VoxelAtlasResolution;
 	StructuredCopyParams->VoxelResolution = RenderData.VoxelResolution;
 	StructuredCopyParams->PackedInterval = TexturePackInterval;
@@ -1160,6 +1143,8 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 		View,
 		VolumeBuffer,
 		RenderData.VolumeDataArray.Num(),
+		AnalyticHoleBoundsBuffer,
+		RenderData.NumAnalyticHoles,
 		OccResources.TileDataBuffer,
 		TileCount,
 		StepSliceCount,
@@ -1253,10 +1238,14 @@ void FIVSmokeRenderer::AddMultiVolumeRayMarchPass(
 	Parameters->VoxelTexSize = VoxelResolution;
 	Parameters->PackedVoxelTexSize = VoxelAtlasResolution;
 	Parameters->VoxelAtlasCount = VoxelAtlasCount;
-	Parameters->PackedHoleAtlas = GraphBuilder.CreateSRV(PackedHoleAtlas);
-	Parameters->HoleTexSize = HoleResolution;
-	Parameters->PackedHoleTexSize = HoleAtlasResolution;
-	Parameters->HoleAtlasCount = HoleAtlasCount;
+	Parameters->PackedHoleAtlas = GraphBuilder.CreateSRV(PackedHoleAtlases[static_cast<int32>(EIVSmokeHoleTextureFormat::HalfFloat)]);
+	Parameters->PackedHoleAtlasRGBA8 = GraphBuilder.CreateSRV(PackedHoleAtlases[static_cast<int32>(EIVSmokeHoleTextureFormat::RGBA8)]);
+	Parameters->PackedHoleAtlasR8 = GraphBuilder.CreateSRV(PackedHoleAtlases[static_cast<int32>(EIVSmokeHoleTextureFormat::R8)]);
+	Parameters->HoleAtlasTexelSize = HoleAtlasTexelSizes[static_cast<int32>(EIVSmokeHoleTextureFormat::HalfFloat)];
+	Parameters->HoleAtlasRGBA8TexelSize = HoleAtlasTexelSizes[static_cast<int32>(EIVSmokeHoleTextureFormat::RGBA8)];
+	Parameters->HoleAtlasR8TexelSize = HoleAtlasTexelSizes[static_cast<int32>(EIVSmokeHoleTextureFormat::R8)];
+	Parameters->AnalyticHoleBuffer = GraphBuilder.CreateSRV(AnalyticHoleBuffer);
+	Parameters->HolePresetBuffer = GraphBuilder.CreateSRV(FIVSmokeHolePresetTable::RegisterBuffer(GraphBuilder, *RenderData.HolePresets));
 
 	// Scene Textures
 	Parameters->SceneTexturesStruct = GetSceneTextureShaderParameters(View).SceneTextures;
@@ -1493,10 +1482,12 @@ void FIVSmokeRenderer::UpdateStatsIfNeeded(const FIVSmokePackedRenderData& Rende
 	CachedPerFrameSize = CalculatePerFrameTextureSize(
 		ViewportSize,
 		RenderData.VolumeCount,
-		RenderData.VoxelResolution,
-		RenderData.HoleResolution
+		RenderData.VoxelResolution
 	);
 
+	// Hole atlases persist across frames and are sized by their slot layout
+	CachedHoleAtlasSize = RenderData.HoleAtlas.IsValid() ? RenderData.HoleAtlas->AllocatedBytes : 0;
+
 	// Calculate CSM size using CalcTextureMemorySizeEnum
 	CachedCSMSize = 0;
 	if (CSMRenderer && CSMRenderer->IsInitialized())
@@ -1522,8 +1513,7 @@ void FIVSmokeRenderer::UpdateStatsIfNeeded(const FIVSmokePackedRenderData& Rende
 int64 FIVSmokeRenderer::CalculatePerFrameTextureSize(
 	const FIntPoint& ViewportSize,
 	int32 VolumeCount,
-	const FIntVector& VoxelResolution,
-	const FIntVector& HoleResolution
+	const FIntVector& VoxelResolution
 ) const
 {
 	if (VolumeCount == 0)
@@ -1550,15 +1540,6 @@ int64 FIVSmokeRenderer::CalculatePerFrameTextureSize(
 	// PackedVoxelAtlas (PF_R32_FLOAT) + PackedVoxelAtlasFXAA (PF_R32_FLOAT)
 	TotalSize += CalculateImageBytes(VoxelAtlasResolution.X, VoxelAtlasResolution.Y, VoxelAtlasResolution.Z, PF_R32_FLOAT) * 2;
 
-	// Hole Atlas (PF_FloatRGBA)
-	FIntVector HoleAtlasCount = GetAtlasTexCount(HoleResolution, VolumeCount, TexturePackInterval, TexturePackMaxSize);
-	FIntVector HoleAtlasResolution(
-		HoleResolution.X * HoleAtlasCount.X + TexturePackInterval * (HoleAtlasCount.X - 1),
-		HoleResolution.Y * HoleAtlasCount.Y + TexturePackInterval * (HoleAtlasCount.Y - 1),
-		HoleResolution.Z * HoleAtlasCount.Z + TexturePackInterval * (HoleAtlasCount.Z - 1)
-	);
-	TotalSize += CalculateImageBytes(HoleAtlasResolution.X, HoleAtlasResolution.Y, HoleAtlasResolution.Z, PF_FloatRGBA);
-
 	// Occupancy textures (View + Light): Use FIVSmokeOccupancyConfig constants
 	const UIVSmokeSettings* Settings = UIVSmokeSettings::Get();
 	if (Settings)
@@ -1581,7 +1562,8 @@ void FIVSmokeRenderer::UpdateAllStats()
 	SET_MEMORY_STAT(STAT_IVSmoke_NoiseVolume, CachedNoiseVolumeSize);
 	SET_MEMORY_STAT(STAT_IVSmoke_CSMShadowMaps, CachedCSMSize);
 	SET_MEMORY_STAT(STAT_IVSmoke_PerFrameTextures, CachedPerFrameSize);
-	SET_MEMORY_STAT(STAT_IVSmoke_TotalVRAM, CachedNoiseVolumeSize + CachedCSMSize + CachedPerFrameSize);
+	SET_MEMORY_STAT(STAT_IVSmoke_HoleTextures, CachedHoleAtlasSize);
+	SET_MEMORY_STAT(STAT_IVSmoke_TotalVRAM, CachedNoiseVolumeSize + CachedCSMSize + CachedPerFrameSize + CachedHoleAtlasSize);
 }
 
 //~==============================================================================
@@ -0,0 +1,210 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#include "IVSmokeSightQuerySubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "IVSmoke.h"
+#include "IVSmokeBitGrid.h"
+#include "IVSmokeGridLibrary.h"
+#include "IVSmokeHoleGeneratorComponent.h"
+#include "IVSmokeSettings.h"
+#include "IVSmokeVoxelVolume.h"
+
+DECLARE_CYCLE_STAT(TEXT("Sight Query Snapshot"),	STAT_IVSmoke_SightQuerySnapshot,	STATGROUP_IVSmoke);
+DECLARE_CYCLE_STAT(TEXT("Sight Query Batch"),		STAT_IVSmoke_SightQueryBatch,		STATGROUP_IVSmoke);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sight Queries (Per Frame)"), STAT_IVSmoke_SightQueryCount, STATGROUP_IVSmoke);
+
+namespace IVSmokeSightQuery
+{
+	/** Batches smaller than this run on the calling thread. */
+	static constexpr int32 MinParallelBatchSize = 32;
+}
+
+//~==============================================================================
+// Public API
+#pragma region API
+
+bool UIVSmokeSightQuerySubsystem::IsSightBlockedBySmoke(const FVector& Start, const FVector& End)
+{
+	RefreshSnapshot();
+	INC_DWORD_STAT(STAT_IVSmoke_SightQueryCount);
+
+	const float BlockingDistance = UIVSmokeSettings::Get()->SightBlockingSmokeDistance;
+	return QuerySegment(Start, End, BlockingDistance) >= BlockingDistance;
+}
+
+float UIVSmokeSightQuerySubsystem::GetOpticalDepth(const FVector& Start, const FVector& End)
+{
+	RefreshSnapshot();
+	INC_DWORD_STAT(STAT_IVSmoke_SightQueryCount);
+
+	return QuerySegment(Start, End, FLT_MAX);
+}
+
+void UIVSmokeSightQuerySubsystem::BatchQuerySight(const TArray<FIVSmokeSightQuery>& Queries, TArray<FIVSmokeSightQueryResult>& OutResults, bool bStopAtBlocking)
+{
+	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_SightQueryBatch);
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT("IVSmoke::UIVSmokeSightQuerySubsystem::BatchQuerySight");
+
+	RefreshSnapshot();
+	INC_DWORD_STAT_BY(STAT_IVSmoke_SightQueryCount, Queries.Num());
+
+	OutResults.SetNum(Queries.Num());
+
+	if (Volumes.IsEmpty())
+	{
+		for (FIVSmokeSightQueryResult& Result : OutResults)
+		{
+			Result = FIVSmokeSightQueryResult();
+		}
+		return;
+	}
+
+	const float BlockingDistance = UIVSmokeSettings::Get()->SightBlockingSmokeDistance;
+	const float StopDistance = bStopAtBlocking ? BlockingDistance : FLT_MAX;
+
+	const EParallelForFlags Flags = Queries.Num() < IVSmokeSightQuery::MinParallelBatchSize
+		? EParallelForFlags::ForceSingleThread
+		: EParallelForFlags::None;
+
+	ParallelFor(Queries.Num(), [this, &Queries, &OutResults, BlockingDistance, StopDistance](int32 Index)
+	{
+		const FIVSmokeSightQuery& Query = Queries[Index];
+		FIVSmokeSightQueryResult& Result = OutResults[Index];
+
+		Result.OpticalDepth = QuerySegment(Query.Start, Query.End, StopDistance);
+		Result.bBlocked = Result.OpticalDepth >= BlockingDistance;
+	}, Flags);
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Snapshot
+#pragma region Snapshot
+
+void UIVSmokeSightQuerySubsystem::RefreshSnapshot()
+{
+	if (SnapshotFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_IVSmoke_SightQuerySnapshot);
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT("IVSmoke::UIVSmokeSightQuerySubsystem::RefreshSnapshot");
+
+	SnapshotFrame = GFrameCounter;
+
+	int32 VolumeNum = 0;
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		Volumes.Reset();
+		return;
+	}
+
+	const bool bAccountForHoles = UIVSmokeSettings::Get()->bSightQueryAccountForHoles;
+
+	for (TActorIterator<AIVSmokeVoxelVolume> Iter(World); Iter; ++Iter)
+	{
+		AIVSmokeVoxelVolume* Volume = *Iter;
+		if (!Volume || Volume->GetActiveVoxelNum() <= 0)
+		{
+			continue;
+		}
+
+		if (Volumes.Num() <= VolumeNum)
+		{
+			Volumes.AddDefaulted();
+		}
+
+		FVolumeSnapshot& Snapshot = Volumes[VolumeNum++];
+		Snapshot.ActorTransform = Volume->GetActorTransform();
+		Snapshot.WorldBounds = FBox(Volume->GetVoxelWorldAABBMin(), Volume->GetVoxelWorldAABBMax());
+		Snapshot.GridResolution = Volume->GetGridResolution();
+		Snapshot.GridOrigin = FVector(Volume->GetCenterOffset()) + FVector(0.5f);
+		Snapshot.VoxelSize = Volume->GetVoxelSize();
+		Snapshot.VoxelBits = Volume->GetVoxelBits();
+
+		if (!bAccountForHoles)
+		{
+			continue;
+		}
+
+		const UIVSmokeHoleGeneratorComponent* HoleGenerator = Volume->GetHoleGeneratorComponent();
+		if (!HoleGenerator || HoleGenerator->GetActiveHoles().Num() == 0)
+		{
+			continue;
+		}
+
+		HoleOccupancy.Build(HoleGenerator->GetActiveHoles(), HoleGenerator->GetSyncedTime());
+		HoleOccupancy.MaskVoxelBits(Snapshot.VoxelBits, Snapshot.GridResolution, Snapshot.VoxelSize, Snapshot.ActorTransform);
+	}
+
+	Volumes.SetNum(VolumeNum);
+}
+
+#pragma endregion
+
+//~==============================================================================
+// Tracing
+#pragma region Tracing
+
+float UIVSmokeSightQuerySubsystem::QuerySegment(const FVector& Start, const FVector& End, float StopDistance) const
+{
+	const FVector StartToEnd = End - Start;
+	const float SegmentLength = StartToEnd.Size();
+	if (SegmentLength <= UE_KINDA_SMALL_NUMBER)
+	{
+		return 0.0f;
+	}
+
+	const float InvSegmentLength = 1.0f / SegmentLength;
+
+	float AccumulatedParam = 0.0f;
+	const float StopParam = StopDistance * InvSegmentLength;
+
+	for (const FVolumeSnapshot& Volume : Volumes)
+	{
+		// Broadphase: voxel AABB
+		if (!FMath::LineBoxIntersection(Volume.WorldBounds, Start, End, StartToEnd))
+		{
+			continue;
+		}
+
+		AccumulatedParam += TraceVolume(Volume, Start, End, StopParam - AccumulatedParam);
+		if (AccumulatedParam >= StopParam)
+		{
+			break;
+		}
+	}
+
+	return AccumulatedParam * SegmentLength;
+}
+
+float UIVSmokeSightQuerySubsystem::TraceVolume(const FVolumeSnapshot& Volume, const FVector& Start, const FVector& End, float StopParam)
+{
+	// Grid space: voxel (X, Y, Z) covers [X, X + 1) on each axis.
+	const float InvVoxelSize = 1.0f / Volume.VoxelSize;
+	const FVector P0 = Volume.ActorTransform.InverseTransformPosition(Start) * InvVoxelSize + Volume.GridOrigin;
+	const FVector P1 = Volume.ActorTransform.InverseTransformPosition(End) * InvVoxelSize + Volume.GridOrigin;
+	const FIntVector& Resolution = Volume.GridResolution;
+
+	// Accumulate the parameter length spent in active, uncarved voxels
+	float Accumulated = 0.0f;
+	FIVSmokeBitGrid::TraverseSegment(Resolution, P0, P1, [&Volume, &Resolution, &Accumulated, StopParam](const FIntVector& Voxel, float TEnter, float TExit)
+	{
+		if (FIVSmokeBitGrid::IsBitSet(Volume.VoxelBits, Voxel, Resolution.Y))
+		{
+			Accumulated += TExit - TEnter;
+			return Accumulated < StopParam;
+		}
+		return true;
+	});
+
+	return Accumulated;
+}
+
+#pragma endregion
@@ -6,7 +6,9 @@
 #include "Engine/World.h"
 #include "EngineUtils.h"
 #include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
 #include "IVSmoke.h"
+#include "IVSmokeBitGrid.h"
 #include "IVSmokeCollisionComponent.h"
 #include "IVSmokeGridLibrary.h"
 #include "IVSmokeHoleGeneratorComponent.h"
@@ -133,6 +135,12 @@ static const FIntVector FloodFillDirections[] = {
 	FIntVector(0, 0, 1), FIntVector(0, 0, -1)
 };
 
+namespace IVSmokeVoxelVolume
+{
+	/** Seconds between checks of the closest player view for the net update frequency. */
+	static constexpr float NetUpdateFrequencyCheckInterval = 0.5f;
+}
+
 //~==============================================================================
 // Actor Lifecycle
 #pragma region Lifecycle
@@ -174,6 +182,8 @@ void AIVSmokeVoxelVolume::BeginPlay()
 
 	ClearSimulationData();
 
+	BakeCurves();
+
 	Super::BeginPlay();
 
 	HoleGeneratorComponent = FindComponentByClass<UIVSmokeHoleGeneratorComponent>();
@@ -186,6 +196,13 @@ void AIVSmokeVoxelVolume::BeginPlay()
 		{
 			StartSimulation();
 		}
+
+		if (GetNetMode() != NM_Standalone && DistantNetUpdateDistance > 0.0f)
+		{
+			NearNetUpdateFrequency = GetNetUpdateFrequency();
+			GetWorldTimerManager().SetTimer(NetUpdateFrequencyTimerHandle, this, &AIVSmokeVoxelVolume::UpdateNetUpdateFrequency,
+				IVSmokeVoxelVolume::NetUpdateFrequencyCheckInterval, true);
+		}
 	}
 }
 
@@ -194,6 +211,8 @@ void AIVSmokeVoxelVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	// Reset state so ShouldRender() returns false (prevents rendering after PIE exit)
 	ServerState.State = EIVSmokeVoxelVolumeState::Idle;
 
+	GetWorldTimerManager().ClearTimer(NetUpdateFrequencyTimerHandle);
+
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -241,6 +260,7 @@ void AIVSmokeVoxelVolume::Tick(float DeltaTime)
 		break;
 	}
 
+	UpdateVoxelWorldAABB();
 	TryUpdateCollision();
 
 #if WITH_EDITOR
@@ -302,6 +322,14 @@ void AIVSmokeVoxelVolume::PostEditChangeProperty(struct FPropertyChangedEvent& P
 			PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, ExpansionNoise)	||
 			PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, DissipationNoise);
 
+	if (PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, ExpansionCurve)		||
+		PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, DissipationCurve)	||
+		PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, FadeInCurve)		||
+		PropertyName == GET_MEMBER_NAME_CHECKED(AIVSmokeVoxelVolume, FadeOutCurve))
+	{
+		BakeCurves();
+	}
+
 	// Handle bDebugEnabled toggle: stop preview if disabled during preview
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(FIVSmokeDebugSettings, bDebugEnabled))
 	{
@@ -373,6 +401,15 @@ void AIVSmokeVoxelVolume::Initialize()
 	bIsInitialized = true;
 }
 
+void AIVSmokeVoxelVolume::BakeCurves()
+{
+	FIVSmokeCurveAtlas& CurveAtlas = FIVSmokeCurveAtlas::Get();
+	ExpansionCurveRow = CurveAtlas.FindOrAddCurve(ExpansionCurve, FIVSmokeCurveAtlas::LinearRow);
+	DissipationCurveRow = CurveAtlas.FindOrAddCurve(DissipationCurve, FIVSmokeCurveAtlas::LinearRow);
+	FadeInCurveRow = CurveAtlas.FindOrAddCurve(FadeInCurve, FIVSmokeCurveAtlas::SquareRootRow);
+	FadeOutCurveRow = CurveAtlas.FindOrAddCurve(FadeOutCurve, FIVSmokeCurveAtlas::InverseSquareRootRow);
+}
+
 void AIVSmokeVoxelVolume::StartSimulation_Implementation()
 {
 	StartSimulationInternal();
@@ -419,6 +456,41 @@ void AIVSmokeVoxelVolume::OnRep_ServerState()
 	HandleStateTransition(ServerState.State);
 }
 
+void AIVSmokeVoxelVolume::UpdateNetUpdateFrequency()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// 1. Closest player view to the volume bounds
+	const FBox VolumeBounds = VolumeBoundComponent->Bounds.GetBox();
+	double ClosestDistanceSquared = TNumericLimits<double>::Max();
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PC->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, VolumeBounds.ComputeSquaredDistanceToPoint(ViewLocation));
+		}
+	}
+
+	// 2. Nobody nearby replicates at the distant rate
+	const bool bDistant = ClosestDistanceSquared > FMath::Square(static_cast<double>(DistantNetUpdateDistance));
+	const float TargetFrequency = bDistant ? FMath::Min(DistantNetUpdateFrequency, NearNetUpdateFrequency) : NearNetUpdateFrequency;
+	if (GetNetUpdateFrequency() != TargetFrequency)
+	{
+		SetNetUpdateFrequency(TargetFrequency);
+		if (!bDistant)
+		{
+			ForceNetUpdate();
+		}
+	}
+}
+
 void AIVSmokeVoxelVolume::HandleStateTransition(EIVSmokeVoxelVolumeState NewState)
 {
 	if (LocalState == NewState)
@@ -426,6 +498,12 @@ void AIVSmokeVoxelVolume::HandleStateTransition(EIVSmokeVoxelVolumeState NewStat
 		return;
 	}
 
+	// Distant volumes replicate rarely, but clients must not see transitions late
+	if (HasAuthority())
+	{
+		ForceNetUpdate();
+	}
+
 	SimTime = 0.0f;
 
 	switch (NewState)
@@ -443,6 +521,9 @@ void AIVSmokeVoxelVolume::HandleStateTransition(EIVSmokeVoxelVolumeState NewStat
 
 		RandomStream.Initialize(ServerState.RandomSeed);
 
+		// Curves may have been reassigned since BeginPlay
+		BakeCurves();
+
 		int32 CenterIndex = UIVSmokeGridLibrary::GridToIndex(GetCenterOffset(), GetGridResolution());
 
 		if (VoxelCosts.IsValidIndex(CenterIndex))
@@ -502,6 +583,10 @@ void AIVSmokeVoxelVolume::ClearSimulationData()
 
 	FMemory::Memzero(VoxelBits.GetData(), VoxelBits.Num() * sizeof(uint64));
 
+	VoxelWorldAABBMin = FVector(FLT_MAX, FLT_MAX, FLT_MAX);
+	VoxelWorldAABBMax = FVector(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	bVoxelBoundsDirty = false;
+
 	VoxelCosts.Init(FLT_MAX, VoxelCosts.Num());
 
 	GeneratedVoxelIndices.Reset();
@@ -634,6 +719,8 @@ void AIVSmokeVoxelVolume::FastForwardSimulation()
 	HandleStateTransition(ServerState.State);
 
 	bIsFastForwarding = false;
+
+	UpdateVoxelWorldAABB();
 }
 
 void AIVSmokeVoxelVolume::UpdateExpansion()
@@ -653,7 +740,7 @@ void AIVSmokeVoxelVolume::UpdateExpansion()
 
 	if (EndSimTime < ExpansionDuration)
 	{
-		float CurveValue = GetCurveValue(CurrentSimTime, ExpansionDuration, ExpansionCurve);
+		float CurveValue = GetCurveValue(CurrentSimTime, ExpansionDuration, ExpansionCurveRow);
 		TargetSpawnNum = FMath::FloorToInt(MaxVoxelNum * CurveValue);
 	}
 	else
@@ -720,7 +807,7 @@ void AIVSmokeVoxelVolume::UpdateDissipation()
 
 	if (CurrentSimTime < DissipationDuration)
 	{
-		float CurveValue = GetCurveValue(CurrentSimTime, DissipationDuration, DissipationCurve);
+		float CurveValue = GetCurveValue(CurrentSimTime, DissipationDuration, DissipationCurveRow);
 		TargetAliveNum = FMath::FloorToInt(GeneratedVoxelIndices.Num() * CurveValue);
 	}
 	else
@@ -945,21 +1032,14 @@ void AIVSmokeVoxelVolume::SetVoxelBirthTime(int32 Index, float BirthTime)
 		VoxelDeathTimes[Index] = 0.0f;
 	}
 
-	FIntVector GridResolution = GetGridResolution();
-	FIntVector CenterOffset = GetCenterOffset();
-
-	UIVSmokeGridLibrary::SetVoxelBit(VoxelBits, Index, GridResolution, true);
+	const FIntVector GridResolution = GetGridResolution();
+	FIVSmokeBitGrid::SetBit(VoxelBits, UIVSmokeGridLibrary::IndexToGrid(Index, GridResolution), GridResolution.Y);
 
 	++ActiveVoxelNum;
 	INC_DWORD_STAT(STAT_IVSmoke_CreatedVoxel);
 
 	DirtyLevel = EIVSmokeDirtyLevel::Dirty;
-
-	const FIntVector GridPos = UIVSmokeGridLibrary::IndexToGrid(Index, GridResolution);
-	const FVector LocalPos = UIVSmokeGridLibrary::GridToLocal(GridPos, VoxelSize, CenterOffset);
-	const FVector WorldPos = GetActorTransform().TransformPosition(LocalPos);
-	VoxelWorldAABBMin = FVector::Min(WorldPos, VoxelWorldAABBMin);
-	VoxelWorldAABBMax = FVector::Max(WorldPos, VoxelWorldAABBMax);
+	bVoxelBoundsDirty = true;
 }
 
 void AIVSmokeVoxelVolume::SetVoxelDeathTime(int32 Index, float DeathTime)
@@ -977,9 +1057,8 @@ void AIVSmokeVoxelVolume::SetVoxelDeathTime(int32 Index, float DeathTime)
 	const float SafeDeathTime = FMath::Max(DeathTime, 0.001f);
 	VoxelDeathTimes[Index] = SafeDeathTime;
 
-	FIntVector GridResolution = GetGridResolution();
-
-	UIVSmokeGridLibrary::SetVoxelBit(VoxelBits, Index, GridResolution, false);
+	const FIntVector GridResolution = GetGridResolution();
+	FIVSmokeBitGrid::ClearBit(VoxelBits, UIVSmokeGridLibrary::IndexToGrid(Index, GridResolution), GridResolution.Y);
 
 	--ActiveVoxelNum;
 	INC_DWORD_STAT(STAT_IVSmoke_DestroyedVoxel)
@@ -987,6 +1066,39 @@ void AIVSmokeVoxelVolume::SetVoxelDeathTime(int32 Index, float DeathTime)
 	DirtyLevel = EIVSmokeDirtyLevel::Dirty;
 }
 
+void AIVSmokeVoxelVolume::UpdateVoxelWorldAABB()
+{
+	if (!bVoxelBoundsDirty)
+	{
+		return;
+	}
+	bVoxelBoundsDirty = false;
+
+	const FIntVector GridResolution = GetGridResolution();
+
+	FIntVector GridMin, GridMax;
+	if (!FIVSmokeBitGrid::CalculateBounds(VoxelBits, GridResolution, GridMin, GridMax))
+	{
+		return;
+	}
+
+	// Grow only: voxels removed during dissipation keep fading out inside the previous bounds.
+	const FIntVector CenterOffset = GetCenterOffset();
+	const FTransform ActorTrans = GetActorTransform();
+	for (int32 Corner = 0; Corner < 8; ++Corner)
+	{
+		const FIntVector GridPos(
+			(Corner & 1) ? GridMax.X : GridMin.X,
+			(Corner & 2) ? GridMax.Y : GridMin.Y,
+			(Corner & 4) ? GridMax.Z : GridMin.Z);
+
+		const FVector LocalPos = UIVSmokeGridLibrary::GridToLocal(GridPos, VoxelSize, CenterOffset);
+		const FVector WorldPos = ActorTrans.TransformPosition(LocalPos);
+		VoxelWorldAABBMin = FVector::Min(WorldPos, VoxelWorldAABBMin);
+		VoxelWorldAABBMax = FVector::Max(WorldPos, VoxelWorldAABBMax);
+	}
+}
+
 #pragma endregion
 
 //~==============================================================================
@@ -1008,7 +1120,8 @@ void AIVSmokeVoxelVolume::TryUpdateCollision(bool bForce)
 			VoxelSize,
 			ActiveVoxelNum,
 			GetSyncWorldTimeSeconds(),
-			bForce
+			bForce,
+			HoleGeneratorComponent ? &HoleGeneratorComponent->GetActiveHoles() : nullptr
 		);
 	}
 }
@@ -1079,15 +1192,6 @@ TObjectPtr<UIVSmokeCollisionComponent> AIVSmokeVoxelVolume::GetCollisionComponen
 	return CollisionComponent;
 }
 
-FTextureRHIRef AIVSmokeVoxelVolume::GetHoleTexture() const
-{
-	if (HoleGeneratorComponent)
-	{
-		return HoleGeneratorComponent->GetHoleTextureRHI();
-	}
-	return nullptr;
-}
-
 float AIVSmokeVoxelVolume::GetSyncWorldTimeSeconds() const
 {
 	UWorld* World = GetWorld();
@@ -1174,31 +1278,37 @@ void AIVSmokeVoxelVolume::DrawDebugVoxelWireframes() const
 		return;
 	}
 
-	FTransform ActorTrans = GetActorTransform();
-	int32 VoxelNum = GeneratedVoxelIndices.Num();
-	int32 MaxVisibleIndex = FMath::Clamp(VoxelNum * DebugSettings.VisibleStepCountPercent / 100.0f, 0, VoxelNum);
+	const FTransform ActorTrans = GetActorTransform();
+	const FIntVector GridResolution = GetGridResolution();
+	const FIntVector CenterOffset = GetCenterOffset();
+	const int32 VoxelNum = GeneratedVoxelIndices.Num();
+	const int32 MaxVisibleIndex = FMath::Clamp(VoxelNum * DebugSettings.VisibleStepCountPercent / 100.0f, 0, VoxelNum);
 
-	const FVector HalfVoxelSize(VoxelSize * 0.5f);
+	// Visible = generated within the step percentage, still active and below the slice height
+	DebugVisibleBits.SetNumUninitialized(VoxelBits.Num(), EAllowShrinking::No);
+	FMemory::Memzero(DebugVisibleBits.GetData(), DebugVisibleBits.Num() * sizeof(uint64));
 	for (int32 i = 0; i < MaxVisibleIndex; ++i)
 	{
-		int32 VoxelIndex = GeneratedVoxelIndices[i];
-		if (!IsVoxelActive(VoxelIndex))
-		{
-			continue;
-		}
+		const FIntVector GridPos = UIVSmokeGridLibrary::IndexToGrid(GeneratedVoxelIndices[i], GridResolution);
+		FIVSmokeBitGrid::SetBit(DebugVisibleBits, GridPos, GridResolution.Y);
+	}
+	FIVSmokeBitGrid::And(DebugVisibleBits, VoxelBits);
 
-		FIntVector GridResolution = GetGridResolution();
-		FIntVector CenterOffset = GetCenterOffset();
+	const int32 SliceBeginZ = FMath::FloorToInt(DebugSettings.SliceHeight * GridResolution.Z) + 1;
+	for (int32 Z = FMath::Max(SliceBeginZ, 0); Z < GridResolution.Z; ++Z)
+	{
+		FMemory::Memzero(DebugVisibleBits.GetData() + Z * GridResolution.Y, GridResolution.Y * sizeof(uint64));
+	}
 
-		FIntVector GridPos = UIVSmokeGridLibrary::IndexToGrid(VoxelIndex, GridResolution);
-		float NormHeight = static_cast<float>(GridPos.Z) / static_cast<float>(GridResolution.Z);
-		if (NormHeight > DebugSettings.SliceHeight)
-		{
-			continue;
-		}
+	// Interior voxels are fully hidden by their neighbours; draw the surface only
+	DebugSurfaceBits.SetNumUninitialized(DebugVisibleBits.Num(), EAllowShrinking::No);
+	FIVSmokeBitGrid::ExtractSurface(DebugVisibleBits, DebugSurfaceBits, GridResolution);
 
-		FVector LocalPos = UIVSmokeGridLibrary::GridToLocal(GridPos, VoxelSize, CenterOffset);
-		FVector WorldPos = ActorTrans.TransformPosition(LocalPos);
+	const FVector HalfVoxelSize(VoxelSize * 0.5f);
+	FIVSmokeBitGrid::ForEachSetBit(DebugSurfaceBits, GridResolution, [&](const FIntVector& GridPos)
+	{
+		const FVector LocalPos = UIVSmokeGridLibrary::GridToLocal(GridPos, VoxelSize, CenterOffset);
+		const FVector WorldPos = ActorTrans.TransformPosition(LocalPos);
 
 		DrawDebugBox(
 			World,
@@ -1208,7 +1318,7 @@ void AIVSmokeVoxelVolume::DrawDebugVoxelWireframes() const
 			DebugSettings.DebugWireframeColor,
 			false, -1.0f, 0, 1.5f
 		);
-	}
+	});
 #endif
 }
 
@@ -1326,14 +1436,18 @@ void AIVSmokeVoxelVolume::DrawDebugStatusText() const
 
 	float Percent = MaxVoxelNum > 0 ? (static_cast<float>(ActiveVoxelNum) / MaxVoxelNum * 100.0f) : 0.0f;
 
+	// Counted from VoxelBits, so a mismatch with ActiveVoxelNum exposes a missed birth or death
+	const int32 SetBitNum = FIVSmokeBitGrid::CountSetBits(VoxelBits);
+
 	FString DebugMsg = FString::Printf(
-		TEXT("State: %s\nSeed: %d\nTime: %.2fs\nVoxels: %d / %d (%.1f%%)\nHeap: %d\nChecksum: %u"),
+		TEXT("State: %s\nSeed: %d\nTime: %.2fs\nVoxels: %d / %d (%.1f%%)\nSet Bits: %d\nHeap: %d\nChecksum: %u"),
 		*StateStr,
 		ServerState.RandomSeed,
 		SimTime,
 		ActiveVoxelNum,
 		MaxVoxelNum,
 		Percent,
+		SetBitNum,
 		ExpansionHeap.Num(),
 		CalculateSimulationChecksum()
 	);
@@ -1356,12 +1470,7 @@ uint32 AIVSmokeVoxelVolume::CalculateSimulationChecksum() const
 	int32 StateInt = (int32)ServerState.State;
 	Checksum = FCrc::MemCrc32(&StateInt, sizeof(int32), Checksum);
 
-	if (VoxelBits.Num() > 0)
-	{
-		Checksum = FCrc::MemCrc32(VoxelBits.GetData(), VoxelBits.Num() * sizeof(uint64), Checksum);
-	}
-
-	return Checksum;
+	return FIVSmokeBitGrid::CalculateChecksum(VoxelBits, Checksum);
 }
 
 #pragma endregion
@@ -21,6 +21,8 @@ DECLARE_MEMORY_STAT(TEXT("Noise Volume"), STAT_IVSmoke_NoiseVolume, STATGROUP_IV
 DECLARE_MEMORY_STAT(TEXT("CSM Shadow Maps"), STAT_IVSmoke_CSMShadowMaps, STATGROUP_IVSmoke);
 DECLARE_MEMORY_STAT(TEXT("Per-Frame Textures"), STAT_IVSmoke_PerFrameTextures, STATGROUP_IVSmoke);
 DECLARE_MEMORY_STAT(TEXT("Total VRAM"), STAT_IVSmoke_TotalVRAM, STATGROUP_IVSmoke);
+DECLARE_MEMORY_STAT(TEXT("Hole Textures"), STAT_IVSmoke_HoleTextures, STATGROUP_IVSmoke);
+DECLARE_MEMORY_STAT(TEXT("Hole Textures (Half Float Baseline)"), STAT_IVSmoke_HoleTexturesBaseline, STATGROUP_IVSmoke);
 
 class FIVSmokeModule : public IModuleInterface
 {
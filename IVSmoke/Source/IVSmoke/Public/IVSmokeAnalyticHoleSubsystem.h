@@ -0,0 +1,42 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "IVSmokeAnalyticHoleSubsystem.generated.h"
+
+/**
+ * Per-world share of the ray march analytic hole budget (FIVSmokeOccupancyConfig::MaxAnalyticHoles).
+ *
+ * ## Overview
+ * A hole generator only evaluates its holes in the ray march after reserving its whole AnalyticHoleThreshold here,
+ * so the holes of every volume in one scene never overflow the per-tile hole mask. Each world renders its own scene,
+ * so worlds sharing the process (PIE clients, editor preview worlds) keep independent budgets.
+ *
+ * @note Game thread only.
+ */
+UCLASS()
+class IVSMOKE_API UIVSmokeAnalyticHoleSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Reserve part of the budget.
+	 *
+	 * @param NumHoles		Holes to reserve.
+	 * @return				False, without reserving anything, if the budget cannot fit them.
+	 */
+	bool TryReserve(const int32 NumHoles);
+
+	/** Return holes reserved with TryReserve. */
+	void Release(const int32 NumHoles);
+
+	/** Returns the number of reserved holes. */
+	FORCEINLINE int32 GetNumReservedHoles() const { return NumReservedHoles; }
+
+private:
+	/** Holes reserved by generators in analytic mode. */
+	int32 NumReservedHoles = 0;
+};
@@ -0,0 +1,296 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Whole-grid operations on bit-packed voxel occupancy.
+ *
+ * ## Layout
+ * Matches `AIVSmokeVoxelVolume::VoxelBits`: one `uint64` per YZ row, X mapped to the bit index,
+ * row index = `Y + Z * Resolution.Y`. X resolution must not exceed 64.
+ *
+ * ## Overview
+ * Every operation works on whole rows, so a single word operation covers up to 64 voxels.
+ * Binary operations between grids additionally process two rows per SIMD register.
+ * Morphology shifts bits inside a row for X neighbours and combines whole row ranges offset by one row (Y)
+ * or one slice (Z) for the other neighbours, so those passes use the same SIMD path.
+ * Bit counting stays per row: the vector API has no portable popcount, so each 64-voxel row costs one
+ * hardware popcount instead.
+ * Morphology (erode, surface) uses the 6-neighbourhood and treats voxels outside the grid as empty.
+ *
+ * Unlike the per-voxel helpers of `UIVSmokeGridLibrary`, nothing here performs per-voxel index
+ * conversion or bounds checks; callers are expected to pass grids of matching size.
+ */
+struct IVSMOKE_API FIVSmokeBitGrid
+{
+	//~==============================================================================
+	// Single Voxel
+
+	/** Returns true if the voxel bit is set. */
+	static FORCEINLINE bool IsBitSet(TConstArrayView<uint64> Bits, const FIntVector& GridPos, int32 ResolutionY)
+	{
+		return (Bits[GridPos.Y + GridPos.Z * ResolutionY] >> GridPos.X) & 1ULL;
+	}
+
+	/** Sets the voxel bit. */
+	static FORCEINLINE void SetBit(TArrayView<uint64> Bits, const FIntVector& GridPos, int32 ResolutionY)
+	{
+		Bits[GridPos.Y + GridPos.Z * ResolutionY] |= 1ULL << GridPos.X;
+	}
+
+	/** Clears the voxel bit. */
+	static FORCEINLINE void ClearBit(TArrayView<uint64> Bits, const FIntVector& GridPos, int32 ResolutionY)
+	{
+		Bits[GridPos.Y + GridPos.Z * ResolutionY] &= ~(1ULL << GridPos.X);
+	}
+
+	//~==============================================================================
+	// Rows
+
+	/** Returns the mask of valid bits in a row. */
+	static FORCEINLINE uint64 GetRowMask(int32 ResolutionX)
+	{
+		return ResolutionX >= 64 ? MAX_uint64 : ((1ULL << ResolutionX) - 1ULL);
+	}
+
+	/** Returns the mask of `Width` bits starting at `BeginX`. */
+	static FORCEINLINE uint64 GetRunMask(int32 BeginX, int32 Width)
+	{
+		return (Width >= 64 ? MAX_uint64 : ((1ULL << Width) - 1ULL)) << BeginX;
+	}
+
+	/**
+	 * Finds the first run of consecutive set bits in a row.
+	 *
+	 * @param Row			Row to scan. Must not be zero.
+	 * @param OutBeginX		Receives the X coordinate of the first bit of the run.
+	 * @param OutWidth		Receives the number of bits in the run.
+	 * @return				Mask covering the run.
+	 */
+	static FORCEINLINE uint64 FindFirstRun(uint64 Row, int32& OutBeginX, int32& OutWidth)
+	{
+		OutBeginX = static_cast<int32>(FMath::CountTrailingZeros64(Row));
+		const uint64 Shifted = Row >> OutBeginX;
+		OutWidth = (Shifted == MAX_uint64) ? (64 - OutBeginX) : static_cast<int32>(FMath::CountTrailingZeros64(~Shifted));
+		return GetRunMask(OutBeginX, OutWidth);
+	}
+
+	/**
+	 * Returns true if every row of [Y, Y + Height) x [Z, Z + Depth) fully contains Mask.
+	 *
+	 * @param Bits			Grid bits.
+	 * @param ResolutionY	Y resolution of the grid.
+	 * @param Mask			Bits that must be set in every row.
+	 */
+	static bool IsBoxFull(TConstArrayView<uint64> Bits, int32 ResolutionY, uint64 Mask, int32 Y, int32 Height, int32 Z, int32 Depth);
+
+	/** Clears Mask from every row of [Y, Y + Height) x [Z, Z + Depth). */
+	static void ClearBox(TArrayView<uint64> Bits, int32 ResolutionY, uint64 Mask, int32 Y, int32 Height, int32 Z, int32 Depth);
+
+	/**
+	 * Invokes Func(Y, Z, BeginX, Width) for every run of consecutive set bits, row by row.
+	 * Each row is read when the iteration reaches it, so Func may clear bits of the current run and of later rows.
+	 */
+	template <typename FuncType>
+	static void ForEachRowRun(TConstArrayView<uint64> Bits, const FIntVector& Resolution, FuncType&& Func)
+	{
+		for (int32 Z = 0; Z < Resolution.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < Resolution.Y; ++Y)
+			{
+				uint64 Row = Bits[Y + Z * Resolution.Y];
+				while (Row != 0)
+				{
+					int32 BeginX, Width;
+					const uint64 RunMask = FindFirstRun(Row, BeginX, Width);
+					Row &= ~RunMask;
+					Func(Y, Z, BeginX, Width);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Invokes Func(const FIntVector& GridPos) for every set bit.
+	 */
+	template <typename FuncType>
+	static void ForEachSetBit(TConstArrayView<uint64> Bits, const FIntVector& Resolution, FuncType&& Func)
+	{
+		for (int32 Z = 0; Z < Resolution.Z; ++Z)
+		{
+			for (int32 Y = 0; Y < Resolution.Y; ++Y)
+			{
+				uint64 Row = Bits[Y + Z * Resolution.Y];
+				while (Row != 0)
+				{
+					const int32 X = static_cast<int32>(FMath::CountTrailingZeros64(Row));
+					Row &= Row - 1;
+					Func(FIntVector(X, Y, Z));
+				}
+			}
+		}
+	}
+
+	//~==============================================================================
+	// Segments
+
+	/**
+	 * Walks the voxels a grid space segment passes through with a 3D DDA, in order along the segment.
+	 * Grid space: voxel (X, Y, Z) covers [X, X + 1) on each axis. The segment is clipped to the grid first.
+	 *
+	 * Invokes Func(const FIntVector& Voxel, float TEnter, float TExit) with segment parameters in [0, 1].
+	 * Returning false from Func stops the walk.
+	 *
+	 * @param Resolution	Grid resolution.
+	 * @param P0			Segment start in grid space.
+	 * @param P1			Segment end in grid space.
+	 */
+	template <typename FuncType>
+	static void TraverseSegment(const FIntVector& Resolution, const FVector& P0, const FVector& P1, FuncType&& Func)
+	{
+		const FVector Dir = P1 - P0;
+
+		// 1. Clip segment against the grid bounds
+		float TMin = 0.0f;
+		float TMax = 1.0f;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			if (FMath::Abs(Dir[Axis]) < UE_SMALL_NUMBER)
+			{
+				if (P0[Axis] < 0.0f || P0[Axis] >= Resolution[Axis])
+				{
+					return;
+				}
+				continue;
+			}
+
+			const float InvDir = 1.0f / Dir[Axis];
+			float T0 = (0.0f - P0[Axis]) * InvDir;
+			float T1 = (Resolution[Axis] - P0[Axis]) * InvDir;
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+
+			TMin = FMath::Max(TMin, T0);
+			TMax = FMath::Min(TMax, T1);
+			if (TMin >= TMax)
+			{
+				return;
+			}
+		}
+
+		// 2. Setup DDA
+		const FVector Entry = P0 + Dir * TMin;
+
+		FIntVector Voxel;
+		FIntVector Step;
+		FVector TNext;
+		FVector TDelta;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+		{
+			Voxel[Axis] = FMath::Clamp(FMath::FloorToInt(Entry[Axis]), 0, Resolution[Axis] - 1);
+
+			if (FMath::Abs(Dir[Axis]) < UE_SMALL_NUMBER)
+			{
+				Step[Axis] = 0;
+				TNext[Axis] = FLT_MAX;
+				TDelta[Axis] = FLT_MAX;
+			}
+			else
+			{
+				Step[Axis] = Dir[Axis] > 0.0f ? 1 : -1;
+				const float Boundary = Voxel[Axis] + (Step[Axis] > 0 ? 1.0f : 0.0f);
+				TNext[Axis] = (Boundary - P0[Axis]) / Dir[Axis];
+				TDelta[Axis] = FMath::Abs(1.0f / Dir[Axis]);
+			}
+		}
+
+		// 3. Walk voxels
+		float T = TMin;
+		while (T < TMax)
+		{
+			const int32 Axis = (TNext.X < TNext.Y)
+				? (TNext.X < TNext.Z ? 0 : 2)
+				: (TNext.Y < TNext.Z ? 1 : 2);
+
+			const float TExit = FMath::Min(static_cast<float>(TNext[Axis]), TMax);
+			if (!Func(Voxel, T, TExit))
+			{
+				return;
+			}
+
+			T = TExit;
+
+			Voxel[Axis] += Step[Axis];
+			TNext[Axis] += TDelta[Axis];
+
+			if (Voxel[Axis] < 0 || Voxel[Axis] >= Resolution[Axis])
+			{
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Finds the part of a grid space segment between entering its first set voxel and leaving its last one.
+	 *
+	 * @param Bits			Grid bits.
+	 * @param Resolution	Grid resolution.
+	 * @param P0			Segment start in grid space.
+	 * @param P1			Segment end in grid space.
+	 * @param OutEnterT		Receives the segment parameter where the first set voxel is entered.
+	 * @param OutExitT		Receives the segment parameter where the last set voxel is left.
+	 * @return				False if the segment passes through no set voxel.
+	 */
+	static bool FindSetSpan(TConstArrayView<uint64> Bits, const FIntVector& Resolution, const FVector& P0, const FVector& P1, float& OutEnterT, float& OutExitT);
+
+	//~==============================================================================
+	// Whole Grid
+
+	/** Returns the number of set bits. Counts one row per hardware popcount. */
+	static int32 CountSetBits(TConstArrayView<uint64> Bits);
+
+	/** Dest &= Other */
+	static void And(TArrayView<uint64> Dest, TConstArrayView<uint64> Other);
+
+	/** Dest |= Other */
+	static void Or(TArrayView<uint64> Dest, TConstArrayView<uint64> Other);
+
+	/** Dest &= ~Other */
+	static void AndNot(TArrayView<uint64> Dest, TConstArrayView<uint64> Other);
+
+	/**
+	 * Keeps only voxels whose 6 neighbours are all set.
+	 *
+	 * @param Source		Input grid.
+	 * @param Dest			Output grid. Must not alias Source.
+	 * @param Resolution	Grid resolution.
+	 */
+	static void Erode(TConstArrayView<uint64> Source, TArrayView<uint64> Dest, const FIntVector& Resolution);
+
+	/**
+	 * Keeps only set voxels that have at least one empty 6-neighbour (Source AND NOT Erode(Source)).
+	 *
+	 * @param Source		Input grid.
+	 * @param Dest			Output grid. Must not alias Source.
+	 * @param Resolution	Grid resolution.
+	 */
+	static void ExtractSurface(TConstArrayView<uint64> Source, TArrayView<uint64> Dest, const FIntVector& Resolution);
+
+	/**
+	 * Computes the inclusive grid bounds of all set bits.
+	 *
+	 * @param Bits			Grid bits.
+	 * @param Resolution	Grid resolution.
+	 * @param OutMin		Receives the minimum grid coordinate.
+	 * @param OutMax		Receives the maximum grid coordinate.
+	 * @return				False if no bit is set.
+	 */
+	static bool CalculateBounds(TConstArrayView<uint64> Bits, const FIntVector& Resolution, FIntVector& OutMin, FIntVector& OutMax);
+
+	/** Returns a CRC32 of the bits, chained from Crc. */
+	static uint32 CalculateChecksum(TConstArrayView<uint64> Bits, uint32 Crc = 0);
+};
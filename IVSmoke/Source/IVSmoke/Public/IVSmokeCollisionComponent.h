@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Components/PrimitiveComponent.h"
 #include "Engine/CollisionProfile.h"
+#include "IVSmokeCollisionMesher.h"
+#include "IVSmokeHoleOccupancy.h"
 #include "IVSmokeCollisionComponent.generated.h"
 
 /**
@@ -13,7 +15,7 @@
  * ## Overview
  * Unlike standard static meshes, this component constructs a set of box colliders (AggGeom)
  * representing the active voxels. It uses a binary greedy meshing algorithm to merge adjacent voxels into
- * larger boxes to minimize the physics cost.
+ * larger boxes to minimize the physics cost. The decomposition strategy is selected by `MeshingStrategy`.
  *
  * ## Usage
  * This component uses the standard Collision category in the Details panel.
@@ -60,8 +62,9 @@ public:
 	 * @param ActiveVoxelNum	Current count of active voxels (used for threshold checks).
 	 * @param SyncTime			Current synchronized world time (used for interval checks).
 	 * @param bForce			If true, bypasses optimization checks and forces an immediate rebuild.
+	 * @param ActiveHoles		Optional holes of the owning volume. Subtracted from the geometry if `bSubtractHoles` is set.
 	 */
-	void TryUpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, int32 ActiveVoxelNum, float SyncTime, bool bForce = false);
+	void TryUpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, int32 ActiveVoxelNum, float SyncTime, bool bForce = false, const FIVSmokeHoleArray* ActiveHoles = nullptr);
 
 	/**
 	 * Clears all generated physics geometry and resets the collision state.
@@ -81,14 +84,41 @@ public:
 	UPROPERTY(EditAnywhere, Category = "IVSmoke | Config", meta = (EditCondition = "bCollisionEnabled", ClampMin = "0.0", UIMax = "2.0"))
 	float MinCollisionUpdateInterval = 0.25f;
 
+	/**
+	 * Strategy used to merge voxels into boxes.
+	 * `BestAxisOrder` generates fewer boxes on irregular shapes at a higher rebuild cost.
+	 * Use `IVSmoke.Collision.Benchmark` to compare strategies on recorded snapshots.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Config", meta = (EditCondition = "bCollisionEnabled"))
+	EIVSmokeCollisionMeshingStrategy MeshingStrategy = EIVSmokeCollisionMeshingStrategy::GreedyXYZ;
+
+	/**
+	 * If true, voxels carved by active holes are removed from the collision geometry.
+	 * A change in the hole set triggers a rebuild regardless of `MinCollisionUpdateVoxelNum`.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Config", meta = (EditCondition = "bCollisionEnabled"))
+	bool bSubtractHoles = false;
+
+	/**
+	 * Converts raw voxel data into `AggGeom.BoxElems` without committing it to the physics engine.
+	 * Uses `FIVSmokeCollisionMesher` to merge adjacent voxels into larger `FKBoxElem` boxes,
+	 * significantly reducing the number of physics bodies required.
+	 *
+	 * Works entirely on persistent scratch storage, so once the buffers have grown to fit the grid
+	 * this makes no heap allocation. `IVSmoke.Collision.VerifyNoAlloc` checks this at runtime.
+	 */
+	void RebuildBoxElems(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, const FIVSmokeHoleArray* ActiveHoles, float SyncTime);
+
 private:
 	/**
 	 * Core algorithm that converts raw voxel data into physics geometry.
-	 * Uses a greedy meshing approach to merge adjacent voxels into larger `FKBoxElem` boxes,
-	 * significantly reducing the number of physics bodies required.
+	 * Rebuilds the boxes via `RebuildBoxElems` and commits them to the physics engine.
 	 * @note This is a computationally expensive operation (O(N) on grid size).
 	 */
-	void UpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize);
+	void UpdateCollision(const TArray<uint64>& VoxelBitArray, const FIntVector& GridResolution, float VoxelSize, const FIVSmokeHoleArray* ActiveHoles, float SyncTime);
+
+	/** Returns a hash of the hole set, used to detect hole changes between rebuilds. */
+	static uint32 CalculateHoleSignature(const FIVSmokeHoleArray& ActiveHoles);
 
 	/** Commits the new geometry to the physics engine. */
 	void FinalizePhysicsUpdate();
@@ -102,6 +132,18 @@ private:
 
 	/** Voxel count at the last update. Used to detect if the shape has changed significantly. */
 	int32 LastActiveVoxelNum = 0;
+
+	/** Hole signature at the last update. Used to detect if the hole set has changed. */
+	uint32 LastHoleSignature = 0;
+
+	/** Hole occupancy reused across rebuilds. */
+	FIVSmokeHoleOccupancy HoleOccupancy;
+
+	/** Copy of the voxel bits consumed by the mesher, reused across rebuilds. */
+	TArray<uint64> ScratchVoxelBits;
+
+	/** Mesher output, reused across rebuilds. */
+	TArray<FIVSmokeVoxelBox> ScratchVoxelBoxes;
 #pragma endregion
 
 	//~==============================================================================
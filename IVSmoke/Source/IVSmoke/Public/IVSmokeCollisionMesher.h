@@ -0,0 +1,58 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IVSmokeCollisionMesher.generated.h"
+
+/**
+ * Strategy used to decompose the voxel grid into collision boxes.
+ */
+UENUM(BlueprintType)
+enum class EIVSmokeCollisionMeshingStrategy : uint8
+{
+	/** Grows every box along X, then Y, then Z from the first set bit. Fastest to build. */
+	GreedyXYZ,
+
+	/**
+	 * For every seed row, tries both Y-first and Z-first growth and keeps the larger box.
+	 * Roughly twice the build cost, but produces noticeably fewer boxes on noisy, ellipsoid shapes.
+	 */
+	BestAxisOrder
+};
+
+/**
+ * Axis-aligned box in voxel grid space produced by the mesher.
+ */
+struct FIVSmokeVoxelBox
+{
+	/** Grid coordinate of the minimum corner voxel. */
+	FIntVector Min = FIntVector::ZeroValue;
+
+	/** Number of voxels along each axis (Width, Height, Depth). */
+	FIntVector Size = FIntVector::ZeroValue;
+};
+
+/**
+ * Converts a bit-packed voxel grid into a set of axis-aligned boxes.
+ *
+ * ## Overview
+ * Each box starts from the first set bit of a row (a run of X voxels) and is then grown along Y and Z
+ * while every covered row still contains the full run. Covered bits are cleared so that every voxel
+ * belongs to exactly one box.
+ *
+ * The mesher is stateless and is shared by `UIVSmokeCollisionComponent` and the offline benchmark
+ * console commands (`IVSmoke.Collision.RecordSnapshots`, `IVSmoke.Collision.Benchmark`).
+ */
+struct IVSMOKE_API FIVSmokeCollisionMesher
+{
+	/**
+	 * Decomposes the grid into boxes.
+	 *
+	 * @param ScratchBits		Bit-packed voxel occupancy (uint64 per YZ row). Consumed: all bits are cleared on return.
+	 * @param GridResolution	The resolution of the voxel grid (X must not exceed 64).
+	 * @param Strategy			Decomposition strategy.
+	 * @param OutBoxes			Receives the generated boxes. Existing elements are kept.
+	 */
+	static void BuildBoxes(TArray<uint64>& ScratchBits, const FIntVector& GridResolution, EIVSmokeCollisionMeshingStrategy Strategy, TArray<FIVSmokeVoxelBox>& OutBoxes);
+};
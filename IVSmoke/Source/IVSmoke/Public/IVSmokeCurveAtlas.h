@@ -0,0 +1,104 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphFwd.h"
+#include "UObject/ObjectKey.h"
+
+class FRDGBuilder;
+class UCurveFloat;
+
+/**
+ * Immutable copy of FIVSmokeCurveAtlas handed to the render thread.
+ */
+struct FIVSmokeCurveAtlasSnapshot
+{
+	/** Baked samples, FIVSmokeCurveAtlas::SamplesPerRow per row. */
+	TArray<float> Samples;
+
+	/** Atlas version the snapshot was taken at. */
+	uint32 Version = 0;
+};
+
+/**
+ * Lookup table of every UCurveFloat driving hole and smoke timing, baked into fixed-size rows.
+ *
+ * ## Overview
+ * Curves are normalized over time (X in [0, 1]), so each one is sampled once into a row of SamplesPerRow
+ * values when the asset referencing it loads. Afterwards the CPU evaluates rows with a table lerp and the
+ * shaders read the same samples from CurveAtlas with SampleCurveAtlas() in IVSmokeCommon.ush, so both sides
+ * agree exactly and no curve is evaluated per frame.
+ *
+ * The first rows are built-in shapes used when no curve is assigned. Rows of curves are never freed.
+ *
+ * @note Game thread only, except RegisterBuffer.
+ */
+class IVSMOKE_API FIVSmokeCurveAtlas
+{
+public:
+	using FSnapshotRef = TSharedRef<const FIVSmokeCurveAtlasSnapshot, ESPMode::ThreadSafe>;
+
+	/** Samples per row. Must match IVSMOKE_CURVE_ATLAS_SAMPLES in IVSmokeCommon.ush. */
+	static constexpr int32 SamplesPerRow = 128;
+
+	/** Rows baked at startup. */
+	enum EBuiltInRow : int32
+	{
+		/** y = x */
+		LinearRow = 0,
+		/** y = 1 - x */
+		InverseLinearRow,
+		/** y = sqrt(x) */
+		SquareRootRow,
+		/** y = 1 - sqrt(x) */
+		InverseSquareRootRow,
+
+		NumBuiltInRows
+	};
+
+	/** Returns the global atlas. */
+	static FIVSmokeCurveAtlas& Get();
+
+	/**
+	 * Returns the row of a curve, baking it on first use.
+	 *
+	 * @param Curve			Curve to look up. May be null.
+	 * @param DefaultRow	Row returned if Curve is null.
+	 * @return				Row index to pass to Evaluate() or to the shaders.
+	 */
+	int32 FindOrAddCurve(const UCurveFloat* Curve, const int32 DefaultRow);
+
+	/** Samples the curve into its row again, e.g. after it was edited. Does nothing if the curve has no row. */
+	void RebakeCurve(const UCurveFloat* Curve);
+
+	/** Evaluates a row at X, clamped to [0, 1]. Invalid rows evaluate as LinearRow. */
+	float Evaluate(const int32 Row, const float X) const;
+
+	/** Returns an immutable copy of the atlas. The same copy is shared until the atlas changes. */
+	FSnapshotRef GetSnapshot();
+
+	/**
+	 * Returns the atlas buffer of a snapshot. Render thread only.
+	 * The buffer persists across graphs and is uploaded only if the snapshot is newer than the last upload.
+	 */
+	static FRDGBufferRef RegisterBuffer(FRDGBuilder& GraphBuilder, const FIVSmokeCurveAtlasSnapshot& Snapshot);
+
+private:
+	FIVSmokeCurveAtlas();
+
+	/** Writes SamplesPerRow samples of Function over [0, 1] into the row. */
+	void BakeRow(const int32 Row, TFunctionRef<float(float)> Function);
+
+	/** Baked samples, SamplesPerRow per row. */
+	TArray<float> Samples;
+
+	/** Row of each baked curve. */
+	TMap<FObjectKey, int32> CurveRows;
+
+	/** Incremented on every change. */
+	uint32 Version = 1;
+
+	/** Copy of the current version, created on demand. */
+	TSharedPtr<const FIVSmokeCurveAtlasSnapshot, ESPMode::ThreadSafe> Snapshot;
+};
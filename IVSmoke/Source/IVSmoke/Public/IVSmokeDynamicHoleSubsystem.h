@@ -0,0 +1,84 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "IVSmokeHoleData.h"
+#include "IVSmokeDynamicHoleSubsystem.generated.h"
+
+class UIVSmokeHoleGeneratorComponent;
+class UPrimitiveComponent;
+class UIVSmokeHolePreset;
+
+/**
+ * World-level registry of actors that carve dynamic holes into smoke.
+ *
+ * ## Overview
+ * Each actor is tracked once, however many hole generators it is registered with. A generator binding only
+ * becomes active while the generator's box overlaps the actor, driven by the generator's overlap events, so
+ * the per-tick cost follows the number of subjects plus the bindings that are actually inside a smoke
+ * instead of subjects times volumes. Actors without any component that generates overlap events cannot
+ * activate through overlaps; their bindings stay active and are checked against the generator bounds every tick.
+ *
+ * Presets are resolved once at registration.
+ *
+ * @note Authority only. Clients never register subjects.
+ */
+UCLASS()
+class IVSMOKE_API UIVSmokeDynamicHoleSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	//~ Begin UTickableWorldSubsystem Interface
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	//~ End UTickableWorldSubsystem Interface
+
+	/**
+	 * Track an actor for a generator.
+	 *
+	 * @param TargetActor	Actor leaving a hole trail.
+	 * @param Generator		Generator the holes are created in.
+	 * @param Preset		Dynamic hole preset.
+	 * @return				False if the actor is already registered with the generator.
+	 */
+	bool RegisterSubject(AActor* TargetActor, UIVSmokeHoleGeneratorComponent* Generator, UIVSmokeHolePreset* Preset);
+
+	/** Remove every binding of the generator. Subjects without bindings are dropped. */
+	void UnregisterGenerator(const UIVSmokeHoleGeneratorComponent* Generator);
+
+	/**
+	 * Activate or deactivate the binding of an actor to a generator. Called from the generator's overlap events.
+	 * Does nothing if the actor is not registered with the generator.
+	 */
+	void SetSubjectOverlapping(AActor* TargetActor, const UIVSmokeHoleGeneratorComponent* Generator, bool bOverlapping);
+
+	/** Returns the number of tracked actors. */
+	FORCEINLINE int32 GetNumSubjects() const { return Subjects.Num(); }
+
+private:
+	/** Moves the binding into or out of the active range at the front of the subject's bindings. */
+	static void SetBindingActive(FIVSmokeHoleDynamicSubject& Subject, int32 BindingIndex, bool bActive);
+
+	/** Removes a binding, keeping the active range intact. */
+	static void RemoveBinding(FIVSmokeHoleDynamicSubject& Subject, int32 BindingIndex);
+
+	/** Removes a subject by swap and keeps SubjectIndices in sync. */
+	void RemoveSubjectAt(int32 SubjectIndex);
+
+	/**
+	 * Returns true if any primitive of the actor generates overlap events with the generator box,
+	 * i.e. both generate overlaps and each responds with ECR_Overlap to the other's object type.
+	 * Otherwise the binding has to be polled.
+	 */
+	static bool CanActivateByOverlap(const AActor* Actor, const UPrimitiveComponent* GeneratorBox);
+
+	/** Tracked actors. */
+	UPROPERTY(Transient)
+	TArray<FIVSmokeHoleDynamicSubject> Subjects;
+
+	/** Index into Subjects per actor. Weak keys stay removable after the actor is destroyed. */
+	TMap<TWeakObjectPtr<AActor>, int32> SubjectIndices;
+};
@@ -0,0 +1,145 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PixelFormat.h"
+#include "RenderGraphFwd.h"
+
+class FRDGBuilder;
+enum class EIVSmokeHoleTextureFormat : uint8;
+
+namespace IVSmokeHoleAtlas
+{
+	/** One atlas per EIVSmokeHoleTextureFormat. */
+	static constexpr int32 NumFormats = 3;
+}
+
+/**
+ * Placement of the slots of one hole atlas.
+ */
+struct IVSMOKE_API FIVSmokeHoleAtlasLayout
+{
+	/** Texels reserved per slot. Hole textures up to this resolution fit in a slot. */
+	FIntVector SlotResolution = FIntVector::ZeroValue;
+
+	/** Slots per axis. */
+	FIntVector SlotCount = FIntVector::ZeroValue;
+
+	/** Atlas texture size. Zero while the atlas holds no slot. */
+	FIntVector Resolution = FIntVector::ZeroValue;
+
+	/** Changes whenever slots move, which discards the atlas content. */
+	uint32 Generation = 0;
+
+	FORCEINLINE bool IsEmpty() const { return Resolution == FIntVector::ZeroValue; }
+
+	/** Returns the first texel of a slot. */
+	FIntVector GetSlotMin(const int32 SlotIndex) const;
+};
+
+/**
+ * Immutable copy of the FIVSmokeHoleAtlas layouts handed to the render thread.
+ */
+struct FIVSmokeHoleAtlasSnapshot
+{
+	/** Layout of each atlas, indexed by EIVSmokeHoleTextureFormat. */
+	FIVSmokeHoleAtlasLayout Layouts[IVSmokeHoleAtlas::NumFormats];
+
+	/** GPU memory of all atlas textures. */
+	int64 AllocatedBytes = 0;
+
+	/** Atlas version the snapshot was taken at. */
+	uint32 Version = 0;
+};
+
+/**
+ * Persistent 3D textures holding the hole texture of every UIVSmokeHoleGeneratorComponent.
+ *
+ * ## Overview
+ * Each generator owns a slot in the atlas of its EIVSmokeHoleTextureFormat. The hole carve and blur write
+ * straight into the slot, and the ray march samples the atlases directly with the slot UVs of
+ * FIVSmokeVolumeGPUData, so no hole texture is copied per frame.
+ *
+ * Slots are laid out on a grid of SlotResolution cells separated by SlotPadding texels cleared to "no hole",
+ * so filtering never reads a neighbouring slot. The grid grows when it runs out of slots or a larger hole
+ * texture arrives; this moves every slot of the format, the atlas is recreated and its generators carve again.
+ * Each layout uses the slot grid closest to a cube, so the atlas does not fill one axis up to MaxResolution
+ * and keep a mostly empty texture resident.
+ *
+ * @note Game thread only, except RegisterTexture.
+ */
+class IVSMOKE_API FIVSmokeHoleAtlas
+{
+public:
+	using FSnapshotRef = TSharedRef<const FIVSmokeHoleAtlasSnapshot, ESPMode::ThreadSafe>;
+
+	/** Texels of "no hole" between slots and around the atlas. */
+	static constexpr int32 SlotPadding = 2;
+
+	/** Largest atlas size per axis. */
+	static constexpr int32 MaxResolution = 2048;
+
+	/** Format value of volumes without a slot. Must match IVSMOKE_HOLE_FORMAT_NONE in IVSmokeCommon.ush. */
+	static constexpr uint32 NoSlotFormat = IVSmokeHoleAtlas::NumFormats;
+
+	/** Returns the global atlas. */
+	static FIVSmokeHoleAtlas& Get();
+
+	/**
+	 * Reserves a slot for a hole texture.
+	 *
+	 * @param Format		Atlas to allocate from.
+	 * @param Resolution	Texels the hole texture needs.
+	 * @return				Slot index, or INDEX_NONE if the atlas is full.
+	 */
+	int32 AllocateSlot(const EIVSmokeHoleTextureFormat Format, const FIntVector& Resolution);
+
+	/** Returns a slot to its atlas. */
+	void FreeSlot(const EIVSmokeHoleTextureFormat Format, const int32 SlotIndex);
+
+	/** Returns the current layout of an atlas. */
+	const FIVSmokeHoleAtlasLayout& GetLayout(const EIVSmokeHoleTextureFormat Format) const;
+
+	/** Returns an immutable copy of the layouts. The same copy is shared until a layout changes. */
+	FSnapshotRef GetSnapshot();
+
+	/**
+	 * Returns the atlas texture of a layout. Render thread only.
+	 * The texture persists across graphs and is recreated, cleared to "no hole", only when the layout generation changes.
+	 * Empty layouts return a dummy texture.
+	 */
+	static FRDGTextureRef RegisterTexture(FRDGBuilder& GraphBuilder, const EIVSmokeHoleTextureFormat Format, const FIVSmokeHoleAtlasLayout& Layout);
+
+	/** Returns the pixel format of an atlas. */
+	static EPixelFormat GetPixelFormat(const EIVSmokeHoleTextureFormat Format);
+
+	/** Returns the "no hole" value of an atlas, in the baked layout. */
+	static FVector4f GetClearValue(const EIVSmokeHoleTextureFormat Format);
+
+private:
+	FIVSmokeHoleAtlas() = default;
+
+	struct FAtlas
+	{
+		FIVSmokeHoleAtlasLayout Layout;
+
+		/** Whether each slot index is in use. */
+		TBitArray<> UsedSlots;
+	};
+
+	/** Lays out the slots of an atlas again for at least MinSlots slots of SlotResolution, on the grid closest to a cube. */
+	bool Relayout(FAtlas& Atlas, const FIntVector& SlotResolution, const int32 MinSlots);
+
+	/** Atlases, indexed by EIVSmokeHoleTextureFormat. */
+	FAtlas Atlases[IVSmokeHoleAtlas::NumFormats];
+
+	/** Last generation given to a layout. Never reused, so the render thread always sees a layout change. */
+	uint32 LastGeneration = 0;
+
+	/** Incremented on every layout change. */
+	uint32 Version = 1;
+
+	/** Copy of the current version, created on demand. */
+	TSharedPtr<const FIVSmokeHoleAtlasSnapshot, ESPMode::ThreadSafe> Snapshot;
+};
@@ -0,0 +1,185 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IVSmokeHoleShaders.h"
+
+/**
+ * Texture space region of a partial hole texture update.
+ *
+ * The separable blur reads BlurStep voxels along each axis, so the written region is the dirty voxels
+ * grown by BlurStep and the carved region is the written region grown by BlurStep once more.
+ * Blur results inside the written region then match a full update exactly.
+ */
+struct FIVSmokeHoleCarveRegion
+{
+	/** First voxel carved and blurred. */
+	FIntVector CarveMin = FIntVector::ZeroValue;
+
+	/** Number of voxels carved and blurred per axis. */
+	FIntVector CarveSize = FIntVector::ZeroValue;
+
+	/** First voxel written back to the hole texture. */
+	FIntVector WriteMin = FIntVector::ZeroValue;
+
+	/** Number of voxels written back per axis. */
+	FIntVector WriteSize = FIntVector::ZeroValue;
+
+	/** Returns true if the region covers the whole texture. */
+	FORCEINLINE bool IsFull(const FIntVector& Resolution) const { return CarveSize == Resolution; }
+
+	/** Returns a region covering the whole texture. */
+	static FIVSmokeHoleCarveRegion MakeFull(const FIntVector& Resolution)
+	{
+		FIVSmokeHoleCarveRegion Region;
+		Region.CarveSize = Resolution;
+		Region.WriteSize = Resolution;
+		return Region;
+	}
+};
+
+/**
+ * Per-brick hole lists for IVSmokeHoleCarveCS.usf.
+ *
+ * The hole texture is split into bricks of BrickSize^3 voxels. Each brick lists the holes whose
+ * conservative bounds overlap it, explosions first and otherwise in hole buffer order, so the carve shader
+ * only iterates holes near the voxel and its cost follows the local hole density instead of the total hole count.
+ * Holes without finite bounds (explosions) are listed in every brick. Holes faded out at the cull time,
+ * including removed FIVSmokeHoleGPUList entries, are listed nowhere.
+ */
+struct IVSMOKE_API FIVSmokeHoleBrickBins
+{
+	/** Brick edge length in voxels. Must match IVSMOKE_HOLE_BRICK_SIZE in IVSmokeHoleCarveCS.usf. */
+	static constexpr int32 BrickSize = 8;
+
+	/** Number of bricks per axis. */
+	FIntVector BrickCount = FIntVector::ZeroValue;
+
+	/** (First entry in HoleIndices, number of holes) per brick, X fastest. */
+	TArray<FUintVector2> BrickRanges;
+
+	/** Hole buffer indices of all bricks, concatenated. */
+	TArray<uint32> HoleIndices;
+
+	/**
+	 * Bins the holes into the bricks that overlap the region. Bricks outside the region stay empty.
+	 *
+	 * @param Holes				GPU hole data, in hole buffer order.
+	 * @param Presets			Preset table the holes index into.
+	 * @param NoiseStrengths	Noise strength per EIVSmokeHoleType.
+	 * @param CullTime			Holes faded out at this time, in the time base of their expiration times, are left out.
+	 * @param VolumeMin			World minimum the hole texture is mapped over.
+	 * @param VolumeMax			World maximum the hole texture is mapped over.
+	 * @param Resolution		Hole texture resolution.
+	 * @param Region			Region that will be carved.
+	 */
+	void Build(TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, TConstArrayView<float> NoiseStrengths, const float CullTime,
+		const FVector3f& VolumeMin, const FVector3f& VolumeMax, const FIntVector& Resolution, const FIVSmokeHoleCarveRegion& Region);
+
+	/** Returns the hole buffer indices binned into the brick containing the voxel. */
+	TConstArrayView<uint32> GetBrickHoles(const FIntVector& VoxelCoord) const
+	{
+		const FIntVector Brick = VoxelCoord / BrickSize;
+		const FUintVector2& Range = BrickRanges[Brick.X + (Brick.Y + Brick.Z * BrickCount.Y) * BrickCount.X];
+		return TConstArrayView<uint32>(HoleIndices.GetData() + Range.X, Range.Y);
+	}
+};
+
+/**
+ * Hole texture update helpers and CPU reference of IVSmokeHoleCarveCS.usf / IVSmokeHoleBlurCS.usf.
+ *
+ * ## Overview
+ * `UIVSmokeHoleGeneratorComponent` uses the bounds and region helpers to carve only the part of the texture
+ * a hole change touches. The reference carve mirrors the lifetime encoding of the compute shader
+ * (penetration and dynamic holes) with noise disabled, and the reference blur mirrors the separable blur.
+ * UpdateRegionFused mirrors the tiling of the fused carve-and-blur pass.
+ *
+ * `IVSmoke.Holes.VerifyRegionCarve` runs random hole sequences through a FIVSmokeHoleGPUList, binned region
+ * updates and unbinned full updates and checks that both produce identical textures.
+ * `IVSmoke.Holes.VerifyFusedCarve` checks that fused updates match the carve followed by three blur passes.
+ */
+struct IVSMOKE_API FIVSmokeHoleCarve
+{
+	/**
+	 * Computes the conservative world bounds of every voxel a hole can change,
+	 * including softness and the maximum noise offset.
+	 *
+	 * @param Hole				GPU hole data.
+	 * @param Preset			Preset parameters of the hole.
+	 * @param NoiseStrength		Noise strength of the hole type.
+	 * @param OutBounds			Receives the world bounds.
+	 * @return					False if the hole affects the whole texture (explosions).
+	 */
+	static bool CalculateHoleBounds(const FIVSmokeHoleGPU& Hole, const FIVSmokeHolePresetGPU& Preset, float NoiseStrength, FBox3f& OutBounds);
+
+	/**
+	 * Converts world bounds into the carve and write regions of a partial update.
+	 *
+	 * @param DirtyBounds		World bounds of every changed voxel.
+	 * @param VolumeMin			World minimum the hole texture is mapped over.
+	 * @param VolumeMax			World maximum the hole texture is mapped over.
+	 * @param Resolution		Hole texture resolution.
+	 * @param BlurStep			Blur radius in voxels.
+	 * @param OutRegion			Receives the region.
+	 * @return					False if the bounds do not overlap the texture.
+	 */
+	static bool CalculateRegion(const FBox3f& DirtyBounds, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+		const FIntVector& Resolution, int32 BlurStep, FIVSmokeHoleCarveRegion& OutRegion);
+
+	//~==============================================================================
+	// CPU Reference
+
+	/**
+	 * Evaluates the lifetime encoded value of a single voxel.
+	 *
+	 * @param Holes			GPU hole data.
+	 * @param Presets		Preset table the holes index into.
+	 * @param HoleTime		Time the holes are evaluated at, the texture time base for the lifetime encoding.
+	 * @param VolumeMin		World minimum the hole texture is mapped over.
+	 * @param VolumeMax		World maximum the hole texture is mapped over.
+	 * @param Resolution	Hole texture resolution.
+	 * @param VoxelCoord	Voxel to evaluate.
+	 * @param Bins			Optional brick bins. If null, every hole is evaluated.
+	 */
+	static FVector4f EvaluateVoxel(TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+		const FIntVector& Resolution, const FIntVector& VoxelCoord, const FIVSmokeHoleBrickBins* Bins = nullptr);
+
+	/**
+	 * Carves and blurs a region and writes it into a texture, like the partial GPU update.
+	 *
+	 * @param Texture		Hole texture values, X fastest. Must hold Resolution voxels.
+	 * @param Holes			GPU hole data.
+	 * @param Presets		Preset table the holes index into.
+	 * @param HoleTime		Time the holes are evaluated at, the texture time base for the lifetime encoding.
+	 * @param VolumeMin		World minimum the hole texture is mapped over.
+	 * @param VolumeMax		World maximum the hole texture is mapped over.
+	 * @param Resolution	Hole texture resolution.
+	 * @param BlurStep		Blur radius in voxels.
+	 * @param Region		Region to update.
+	 * @param Bins			Optional brick bins built for the region. If null, every hole is evaluated.
+	 */
+	static void UpdateRegion(TArray<FVector4f>& Texture, TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+		const FIntVector& Resolution, int32 BlurStep, const FIVSmokeHoleCarveRegion& Region, const FIVSmokeHoleBrickBins* Bins = nullptr);
+
+	/**
+	 * Carves and blurs a region like UpdateRegion, tiled like IVSmokeHoleFusedCarveCS: every tile of the write region
+	 * carves itself plus a BlurStep apron and blurs it in place. The result matches UpdateRegion exactly.
+	 *
+	 * @param Texture		Hole texture values, X fastest. Must hold Resolution voxels.
+	 * @param Holes			GPU hole data.
+	 * @param Presets		Preset table the holes index into.
+	 * @param HoleTime		Time the holes are evaluated at, the texture time base for the lifetime encoding.
+	 * @param VolumeMin		World minimum the hole texture is mapped over.
+	 * @param VolumeMax		World maximum the hole texture is mapped over.
+	 * @param Resolution	Hole texture resolution.
+	 * @param BlurStep		Blur radius in voxels.
+	 * @param Region		Region to update.
+	 * @param Bins			Optional brick bins built for the region. If null, every hole is evaluated.
+	 */
+	static void UpdateRegionFused(TArray<FVector4f>& Texture, TConstArrayView<FIVSmokeHoleGPU> Holes, TConstArrayView<FIVSmokeHolePresetGPU> Presets, const float HoleTime, const FVector3f& VolumeMin, const FVector3f& VolumeMax,
+		const FIntVector& Resolution, int32 BlurStep, const FIVSmokeHoleCarveRegion& Region, const FIVSmokeHoleBrickBins* Bins = nullptr);
+
+	/** Returns the number of voxel carves of a fused update, aprons included. */
+	static int64 CalculateFusedCarveVoxels(const FIVSmokeHoleCarveRegion& Region, int32 BlurStep);
+};
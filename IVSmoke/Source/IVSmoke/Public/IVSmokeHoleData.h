@@ -3,7 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
 #include "Net/Serialization/FastArraySerializer.h"
+#include "IVSmokeHoleGPUList.h"
 #include "IVSmokeHoleShaders.h"
 #include "IVSmokeHoleData.generated.h"
 
@@ -38,37 +40,145 @@ struct IVSMOKE_API FIVSmokeHoleNoiseSettings
 };
 
 /**
- * @struct FIVSmokeHoleDynamicSubject
- * @brief Dynamic hole generated type data structure
+ * @struct FIVSmokeHoleDynamicBinding
+ * @brief Hole generator a dynamic subject carves holes into, with the trail state of that generator.
  */
 USTRUCT()
-struct IVSMOKE_API FIVSmokeHoleDynamicSubject
+struct IVSMOKE_API FIVSmokeHoleDynamicBinding
 {
 	GENERATED_BODY()
 
-	/** Dynamic actors to create holes */
+	/** Generator the subject was registered with. */
 	UPROPERTY(Transient)
-	TWeakObjectPtr<AActor> TargetActor;
+	TWeakObjectPtr<UIVSmokeHoleGeneratorComponent> Generator;
 
-	/** Preset ID. */
+	/** Dynamic preset, resolved once at registration. */
 	UPROPERTY(Transient)
-	uint8 PresetID = 0;
+	TObjectPtr<UIVSmokeHolePreset> Preset;
 
-	/** Target last world position. */
+	/** Target world position at the end of the last hole created in this generator. */
 	UPROPERTY(Transient)
 	FVector3f LastWorldPosition = FVector3f::ZeroVector;
+};
+
+/**
+ * @struct FIVSmokeHoleDynamicSubject
+ * @brief Dynamic hole generated type data structure. Each actor is tracked once, for every generator it is registered with.
+ */
+USTRUCT()
+struct IVSMOKE_API FIVSmokeHoleDynamicSubject
+{
+	GENERATED_BODY()
 
-	/** Target last world rotation. */
+	/** Dynamic actors to create holes */
 	UPROPERTY(Transient)
-	FQuat LastWorldRotation = FQuat::Identity;
+	TWeakObjectPtr<AActor> TargetActor;
+
+	/** Generators the actor is registered with. The first NumActiveBindings overlap the actor. */
+	UPROPERTY(Transient)
+	TArray<FIVSmokeHoleDynamicBinding> Bindings;
+
+	/** Number of bindings whose generator currently overlaps the actor. */
+	int32 NumActiveBindings = 0;
 
 	/** Check valid. */
 	FORCEINLINE bool IsValid() const { return TargetActor.IsValid(); }
 };
 
+/**
+ * @struct FIVSmokeHoleShot
+ * @brief Quantized penetration shot sent in batched hole requests.
+ */
+USTRUCT()
+struct IVSMOKE_API FIVSmokeHoleShot
+{
+	GENERATED_BODY()
+
+	FIVSmokeHoleShot() = default;
+	FIVSmokeHoleShot(const FVector3f& InOrigin, const FVector3f& InDirection, const uint16 InPredictionKey = 0)
+		: Origin(FVector(InOrigin))
+		, Direction(FVector(InDirection.GetSafeNormal()))
+		, PredictionKey(InPredictionKey)
+	{
+	}
+
+	/** Shot origin, rounded to whole units on the wire. */
+	UPROPERTY()
+	FVector_NetQuantize Origin = FVector::ZeroVector;
+
+	/** Normalized shot direction, 16 bits per component on the wire. */
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction = FVector::ForwardVector;
+
+	/** Key of the hole the shooter predicted for this shot. 0 if not predicted. */
+	UPROPERTY()
+	uint16 PredictionKey = 0;
+};
+
+/**
+ * @struct FIVSmokeHoleNetFrame
+ * @brief Quantization frame of replicated hole positions, chosen once by the server around the owning volume.
+ */
+USTRUCT()
+struct IVSMOKE_API FIVSmokeHoleNetFrame
+{
+	GENERATED_BODY()
+
+	/** World center of the quantization cube. */
+	UPROPERTY()
+	FVector3f Origin = FVector3f::ZeroVector;
+
+	/** Half edge length of the quantization cube. Zero disables quantization. */
+	UPROPERTY()
+	float HalfExtent = 0.0f;
+
+	/** Returns true if positions can be quantized against this frame. */
+	FORCEINLINE bool IsValid() const { return HalfExtent > 0.0f; }
+};
+
+/**
+ * @struct FIVSmokeHoleNetContext
+ * @brief State FIVSmokeHoleData::NetSerialize needs besides the item, provided by FIVSmokeHoleArray::NetDeltaSerialize.
+ */
+struct IVSMOKE_API FIVSmokeHoleNetContext
+{
+	/** Quantization frame of the owning generator. */
+	FIVSmokeHoleNetFrame Frame;
+
+	/** Synced server time of the serialization. Expirations are sent relative to it. */
+	float ServerTime = 0.0f;
+
+	/** View location of the connection being written. Only valid if bCullByDistance. */
+	FVector3f ViewerLocation = FVector3f::ZeroVector;
+
+	/** Squared distance beyond which items are not sent to the connection. */
+	float CullDistanceSquared = 0.0f;
+
+	/** Whether items are culled by distance for the connection being written. */
+	bool bCullByDistance = false;
+};
+
+/**
+ * @brief Makes a context visible to FIVSmokeHoleData::NetSerialize on this thread for the scope's lifetime.
+ */
+struct IVSMOKE_API FIVSmokeHoleNetContextScope
+{
+	explicit FIVSmokeHoleNetContextScope(const FIVSmokeHoleNetContext& Context);
+	~FIVSmokeHoleNetContextScope();
+
+	UE_NONCOPYABLE(FIVSmokeHoleNetContextScope);
+
+private:
+	const FIVSmokeHoleNetContext* PreviousContext;
+};
+
 /**
  * @struct FIVSmokeHoleData
  * @brief Network-optimized hole data structure.
+ *
+ * NetSerialize sends positions as 16-bit offsets inside the generator's FIVSmokeHoleNetFrame and the expiration
+ * as the remaining lifetime in centiseconds. Holes outside the frame, or serialized without a context,
+ * fall back to full precision.
  */
 USTRUCT()
 struct IVSMOKE_API FIVSmokeHoleData : public FFastArraySerializerItem
@@ -104,13 +214,49 @@ public:
 	UPROPERTY(Transient)
 	uint8 PresetID = 0;
 
+	/** Key of the shooter's predicted hole this hole confirms. 0 if the hole was not predicted. */
+	UPROPERTY(Transient)
+	uint16 PredictionKey = 0;
+
+	/** Player id of the shooter that predicted this hole. Keys are only unique per shooter. Unused if PredictionKey is 0. */
+	UPROPERTY(Transient)
+	int32 PredictionOwnerID = INDEX_NONE;
+
+	/**
+	 * Entry of the hole in the GPU list of its array. Local only, never replicated.
+	 * INDEX_NONE while waiting for the preset, FIVSmokeHoleGPUList::DroppedIndex without an entry to remove.
+	 */
+	mutable int32 GPUListIndex = INDEX_NONE;
+
 	/** Check if this hole has expired. */
 	FORCEINLINE bool IsExpired(const float CurrentServerTime) const { return CurrentServerTime >= ExpirationServerTime; }
+
+	/** Quantized replication of the hole, see FIVSmokeHoleNetFrame. */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FIVSmokeHoleData> : public TStructOpsTypeTraitsBase2<FIVSmokeHoleData>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
 };
 
 /**
  * @struct FIVSmokeHoleArray
  * @brief Fast TArray container for delta replication of hole data.
+ *
+ * Beside the items, the array keeps an indexed min-heap of item indices ordered by ExpirationServerTime,
+ * so the earliest expiring hole is found in O(1) and adding, replacing or removing a hole costs O(log n).
+ * The heap is maintained only by AddHole, ReplaceHole, RemoveAtSwap and Empty. Items changed by replication
+ * on clients bypass it, so it is meaningful only on the authority.
+ *
+ * The array also mirrors its items into a FIVSmokeHoleGPUList. AddHole, ReplaceHole, RemoveAtSwap and the
+ * replication callbacks add or remove a single list entry, so the GPU buffer of the list is updated
+ * incrementally instead of being rebuilt. Items modified through operator[] are not seen by the list.
+ * Dedicated servers never render holes, so they skip the list entirely.
  */
 USTRUCT()
 struct IVSMOKE_API FIVSmokeHoleArray : public FFastArraySerializer
@@ -124,35 +270,73 @@ private:
 	UPROPERTY(Transient, VisibleAnywhere, Category = "IVSmoke | Hole")
 	TArray<FIVSmokeHoleData> Items;
 
+	/** Item indices as a binary min-heap on ExpirationServerTime. */
+	TArray<int32> ExpiryHeap;
+
+	/** Position of each item in ExpiryHeap. */
+	TArray<int32> ExpiryHeapPositions;
+
+	/** Returns true if the heap entry at A expires before the one at B. */
+	FORCEINLINE bool ExpiresBefore(const int32 HeapA, const int32 HeapB) const
+	{
+		return Items[ExpiryHeap[HeapA]].ExpirationServerTime < Items[ExpiryHeap[HeapB]].ExpirationServerTime;
+	}
+
+	/** Swaps two heap entries and keeps their positions in sync. */
+	void SwapHeapEntries(const int32 HeapA, const int32 HeapB);
+
+	/** Restores the heap order for the entry at HeapIndex after its expiration changed. */
+	void FixHeapEntry(int32 HeapIndex);
+
+	/** GPU layout of the items. Mutable since the replication callbacks only get a const array. */
+	mutable FIVSmokeHoleGPUList GPUList;
+
+	/** Items without a GPU list entry because their preset was not registered yet. Retried on every ConsumeGPUListUpdate. */
+	mutable int32 NumUnlistedItems = 0;
+
+	/** Updates the GPU list index of every item after a compaction of the list. */
+	void RemapGPUListIndices(TConstArrayView<int32> Remap) const;
+
+	/** Returns false on dedicated servers, which never carve holes and so never consume the GPU list. */
+	bool ShouldMaintainGPUList() const;
+
 public:
 	/** Owner component reference for replication callbacks. */
 	UPROPERTY(Transient, NotReplicated)
 	TObjectPtr<UIVSmokeHoleGeneratorComponent> OwnerComponent;
 
-	/** FastArray delta replication entry point. */
-	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	/** FastArray delta replication entry point. Provides the owner's FIVSmokeHoleNetContext to the items. */
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms);
+
+	/**
+	 * FastArray hook deciding per connection whether an item is written.
+	 * Items beyond the owner's HoleNetCullDistance from the connection's view target are left out of its delta state,
+	 * so the client removes them and receives them again once the array is re-evaluated in range.
+	 */
+	template<typename Type, typename SerializerType>
+	FORCEINLINE bool ShouldWriteFastArrayItem(const Type& Item, const bool bIsWritingOnClient)
 	{
-		return FFastArraySerializer::FastArrayDeltaSerialize<FIVSmokeHoleData, FIVSmokeHoleArray>(
-			Items, DeltaParms, *this
-		);
+		if (bIsWritingOnClient)
+		{
+			return Item.ReplicationID != INDEX_NONE;
+		}
+		return IsRelevantToCurrentConnection(Item);
 	}
 
+	/** Returns false if the item is beyond the cull distance of the connection currently being written. */
+	static bool IsRelevantToCurrentConnection(const FIVSmokeHoleData& Item);
+
 	/** Add new hole and mark dirty. */
-	void AddHole(const FIVSmokeHoleData& NewHole)
-	{
-		Items.Add(NewHole);
-		MarkItemDirty(Items.Last());
-	}
+	void AddHole(const FIVSmokeHoleData& NewHole);
+
+	/** Overwrite the hole at index, keeping its replication identity, and mark dirty. */
+	void ReplaceHole(const int32 Index, const FIVSmokeHoleData& NewHole);
 
 	/** Remove hole by swap and mark dirty. */
-	void RemoveAtSwap(const int32 Index)
-	{
-		if (Items.IsValidIndex(Index))
-		{
-			Items.RemoveAtSwap(Index);
-			MarkArrayDirty();
-		}
-	}
+	void RemoveAtSwap(const int32 Index);
+
+	/** Returns the index of the hole that expires first, or INDEX_NONE if there is none. Authority only. */
+	FORCEINLINE int32 GetEarliestExpiringIndex() const { return ExpiryHeap.Num() > 0 ? ExpiryHeap[0] : INDEX_NONE; }
 
 	/** Returns the hole num */
 	FORCEINLINE int32 Num() const { return Items.Num(); }
@@ -167,13 +351,32 @@ public:
 	FORCEINLINE const FIVSmokeHoleData& operator[](const int32 Index) const { return Items[Index]; }
 
 	/** Reserve size items array */
-	FORCEINLINE void Reserve(const int32 Number) { Items.Reserve(Number); }
+	FORCEINLINE void Reserve(const int32 Number)
+	{
+		Items.Reserve(Number);
+		ExpiryHeap.Reserve(Number);
+		ExpiryHeapPositions.Reserve(Number);
+	}
 
 	/** Empty items array and mark dirty. */
 	void Empty();
 
-	/** Converts items array into an array of GPU-compatible hole data structures. */
-	TArray<FIVSmokeHoleGPU> GetHoleGPUData(const float CurrentServerTime) const;
+	/** Adds the GPU list entry of an item. Leaves the item unlisted if its preset is not registered. No-op on dedicated servers. */
+	void AddGPUEntry(const FIVSmokeHoleData& Item) const;
+
+	/** Removes the GPU list entry of an item. No-op on dedicated servers. */
+	void RemoveGPUEntry(const FIVSmokeHoleData& Item) const;
+
+	/** Returns the GPU list mirroring the items. */
+	FORCEINLINE const FIVSmokeHoleGPUList& GetGPUList() const { return GPUList; }
+
+	/**
+	 * Moves the GPU list changes since the last call into OutUpdate, listing items whose preset was missing first.
+	 * The list is compacted once enough of it is removed, and the items follow their entries.
+	 * @param CurrentServerTime		The CurrentServerTime is obtained through the GetSyncedTime function. Compactions drop entries expired at it.
+	 * @param OutUpdate				Receives the changes, to be applied by FIVSmokeHoleGPUListBuffer::Update.
+	 */
+	void ConsumeGPUListUpdate(const float CurrentServerTime, FIVSmokeHoleGPUListUpdate& OutUpdate);
 };
 
 // Enable delta serialization for FIVSmokeHoleArray
@@ -0,0 +1,163 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IVSmokeHoleShaders.h"
+#include "RenderGraphFwd.h"
+
+class FRDGBuilder;
+class FRDGPooledBuffer;
+
+/**
+ * Changes of a FIVSmokeHoleGPUList since its last update, applied to the GPU buffer by FIVSmokeHoleGPUListBuffer.
+ */
+struct FIVSmokeHoleGPUListUpdate
+{
+	/** Entries written by list index, before the compaction. Every entry if bFullUpload. */
+	TArray<FIVSmokeHoleGPU> Writes;
+
+	/** List index of each write. Empty if bFullUpload. */
+	TArray<uint32> WriteIndices;
+
+	/** Whether Writes replaces the whole buffer instead of being scattered into it. */
+	bool bFullUpload = false;
+
+	/** Whether the GPU drops removed and expired entries after the writes. */
+	bool bCompact = false;
+
+	/** Entries expiring at or before this synced time are dropped by the compaction. */
+	float CompactTime = 0.0f;
+
+	/** Entries after the writes. */
+	int32 NumWrittenEntries = 0;
+
+	/** Entries after the compaction. Equal to NumWrittenEntries without one. */
+	int32 NumEntries = 0;
+
+	/** Returns the bytes uploaded by the update. */
+	FORCEINLINE int64 GetUploadBytes() const
+	{
+		return Writes.Num() * static_cast<int64>(sizeof(FIVSmokeHoleGPU)) + WriteIndices.Num() * static_cast<int64>(sizeof(uint32));
+	}
+};
+
+/**
+ * Game thread mirror of a persistent GPU hole buffer.
+ *
+ * ## Overview
+ * Entries are appended in insertion order and never change while their hole lives, since the hole carve derives
+ * the age of a hole from its expiration time. A removed hole is overwritten in place by an entry expiring far in
+ * the past, so adding or removing a hole uploads a single entry.
+ *
+ * Once enough entries are removed, ConsumeUpdate compacts the list: IVSmokeHoleListCompactCS.usf drops removed
+ * and expired entries on the GPU, and the mirror drops the same entries in the same order so the hole indices
+ * of the brick bins keep matching the GPU buffer. Expired holes are dropped even before their removal replicates.
+ *
+ * @note Game thread only.
+ */
+class IVSMOKE_API FIVSmokeHoleGPUList
+{
+public:
+	/** Largest number of entries, live or removed. Must stay within 16 entries per thread of IVSmokeHoleListCompactCS.usf. */
+	static constexpr int32 MaxEntries = 16384;
+
+	/** Expiration time of removed entries. Every compaction drops them. */
+	static constexpr float RemovedExpirationTime = -1.0e9f;
+
+	/** Index of holes whose entry a compaction dropped. Their removal needs no upload. */
+	static constexpr int32 DroppedIndex = -2;
+
+	/** Removed entries, as a share of the list, that trigger a compaction. */
+	static constexpr int32 CompactRatio = 4;
+
+	/** Removed entries below which the list is never compacted. */
+	static constexpr int32 MinCompactEntries = 64;
+
+	/**
+	 * Appends an entry.
+	 * @return		Index of the entry, or INDEX_NONE if the list is full of live entries.
+	 */
+	int32 Add(const FIVSmokeHoleGPU& Hole);
+
+	/** Marks the entry at Index removed. Ignores INDEX_NONE and DroppedIndex. */
+	void Remove(const int32 Index);
+
+	/** Removes every entry. The next update uploads the list again. */
+	void Reset();
+
+	/** Returns true if Add would fail without dropping the removed entries first. */
+	FORCEINLINE bool IsFull() const { return Entries.Num() >= MaxEntries; }
+
+	/** Returns the entries, in GPU buffer order. */
+	FORCEINLINE TConstArrayView<FIVSmokeHoleGPU> GetEntries() const { return Entries; }
+
+	/** Returns the number of entries, live or removed. */
+	FORCEINLINE int32 Num() const { return Entries.Num(); }
+
+	/** Returns the number of removed entries. */
+	FORCEINLINE int32 NumRemoved() const { return NumRemovedEntries; }
+
+	/**
+	 * Moves the changes since the last call into OutUpdate, and compacts the list once CompactRatio of it is removed.
+	 *
+	 * @param CompactTime	Synced time. Entries expiring at or before it are dropped by a compaction.
+	 * @param OutUpdate		Receives the changes.
+	 * @param OutRemap		Receives the new index of every previous entry if the list was compacted, DroppedIndex for dropped ones.
+	 * @return				True if the list was compacted.
+	 */
+	bool ConsumeUpdate(const float CompactTime, FIVSmokeHoleGPUListUpdate& OutUpdate, TArray<int32>& OutRemap);
+
+	/**
+	 * Drops the removed entries on the game thread only. The next update uploads the list again.
+	 *
+	 * @param OutRemap		Receives the new index of every previous entry, DroppedIndex for dropped ones.
+	 * @return				True if any entry was dropped.
+	 */
+	bool CompactRemoved(TArray<int32>& OutRemap);
+
+private:
+	/** Drops the entries expiring at or before CompactTime, keeping the order. Must match IVSmokeHoleListCompactCS.usf. */
+	void Compact(const float CompactTime, TArray<int32>& OutRemap);
+
+	/** Entries in GPU buffer order. */
+	TArray<FIVSmokeHoleGPU> Entries;
+
+	/** Entries written since the last update. */
+	TArray<int32> DirtyIndices;
+
+	/** Whether each entry is in DirtyIndices. */
+	TBitArray<> DirtyEntries;
+
+	/** Entries marked removed and not yet compacted. */
+	int32 NumRemovedEntries = 0;
+
+	/** Whether the next update uploads every entry. Set until the first update and after game thread only compactions. */
+	bool bFullUpload = true;
+};
+
+/**
+ * GPU buffer of a FIVSmokeHoleGPUList, kept on the render thread between hole carves.
+ *
+ * @note Render thread only. Owners hold it in a thread safe shared pointer and release it on the render thread.
+ */
+class IVSMOKE_API FIVSmokeHoleGPUListBuffer
+{
+public:
+	/**
+	 * Applies an update and returns the buffer holding the list. The buffer always holds at least one entry.
+	 *
+	 * @param GraphBuilder	RDG builder
+	 * @param Update		Changes of the list since the previous update.
+	 */
+	FRDGBufferRef Update(FRDGBuilder& GraphBuilder, const FIVSmokeHoleGPUListUpdate& Update);
+
+private:
+	/** Creates an empty list buffer of Capacity entries. */
+	static FRDGBufferRef CreateListBuffer(FRDGBuilder& GraphBuilder, const int32 Capacity);
+
+	/** List buffer, Capacity entries of which the first NumEntries are in use. */
+	TRefCountPtr<FRDGPooledBuffer> Buffer;
+	int32 Capacity = 0;
+	int32 NumEntries = 0;
+};
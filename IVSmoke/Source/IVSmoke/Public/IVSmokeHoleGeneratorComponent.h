@@ -7,9 +7,24 @@
 #include "IVSmokeHoleGeneratorComponent.generated.h"
 
 class UTexture2D;
-class UTextureRenderTargetVolume;
 class UIVSmokeHolePreset;
 
+/**
+ * Storage format of the hole texture. Must match IVSMOKE_HOLE_FORMAT_* in IVSmokeCommon.ush.
+ */
+UENUM(BlueprintType)
+enum class EIVSmokeHoleTextureFormat : uint8
+{
+	/** 8 bytes per voxel. Distortion and density at full precision, lifetime fades evaluated in the ray march. */
+	HalfFloat,
+
+	/** 4 bytes per voxel. Distortion clamped to CompactDistortionRange. Re-carved on hole changes and expirations. */
+	RGBA8,
+
+	/** 1 byte per voxel. Density only, no explosion distortion. Re-carved on hole changes and expirations. */
+	R8
+};
+
 /**
  * @brief Component that generates hole texture for volumetric smoke.
  *        Provides public API for penetration and explosion holes.
@@ -40,11 +55,39 @@ public:
 	/** Create penetration hole. Called on server via UIVSmokeHoleRequestComponent. */
 	void CreatePenetrationHole(const FVector3f& Origin, const FVector3f& Direction, const uint8 PresetID);
 
+	/**
+	 * Create penetration holes for a batch of shots sharing one preset. Called on server via UIVSmokeHoleRequestComponent.
+	 * @param Shots				Shots to create holes for.
+	 * @param PresetID			Penetration preset shared by all shots.
+	 * @param PredictionOwnerID	Player id of the shooter, see UIVSmokeHoleRequestComponent::GetPredictionOwnerID. Prediction keys are dropped if INDEX_NONE.
+	 * @param OutRejectedKeys	Optional. Receives the prediction keys of shots that did not create a hole.
+	 */
+	void CreatePenetrationHoles(TConstArrayView<FIVSmokeHoleShot> Shots, const uint8 PresetID, const int32 PredictionOwnerID = INDEX_NONE, TArray<uint16>* OutRejectedKeys = nullptr);
+
 	/** Create explosion hole. Called on server via UIVSmokeHoleRequestComponent. */
 	void CreateExplosionHole(const FVector3f& Origin, const uint8 PresetID);
 
-	/** Register dynamic object. Called on server via UIVSmokeHoleRequestComponent. */
+	/** Register dynamic object with UIVSmokeDynamicHoleSubsystem. Called on server via UIVSmokeHoleRequestComponent. */
 	void RegisterTrackDynamicHole(AActor* TargetActor, const uint8 PresetID);
+
+	/** Create a dynamic hole along the path a subject moved. Called on server by UIVSmokeDynamicHoleSubsystem. */
+	void CreateDynamicHole(const FVector3f& LastPosition, const FVector3f& CurrentPosition, const UIVSmokeHolePreset& Preset);
+
+	/**
+	 * Insert a provisional penetration hole that the shooting client sees until the authoritative hole replicates.
+	 * Called on the owning client via UIVSmokeHoleRequestComponent.
+	 * @param Shot				Shot with a non-zero prediction key.
+	 * @param PresetID			Penetration preset of the shot.
+	 * @param PredictionOwnerID	Player id of the local shooter. Only authoritative holes of the same shooter confirm the prediction.
+	 * @return True if the shot penetrates the smoke and a hole was predicted.
+	 */
+	bool PredictPenetrationHole(const FIVSmokeHoleShot& Shot, const uint8 PresetID, const int32 PredictionOwnerID);
+
+	/** Drop predicted holes the server rejected. Called on the owning client via UIVSmokeHoleRequestComponent. */
+	void DropPredictedHoles(TConstArrayView<uint16> PredictionKeys);
+
+	/** Drop the predicted hole an authoritative hole of the same shooter confirms. Called from the ActiveHoles replication callbacks. */
+	void ReconcilePredictedHole(const FIVSmokeHoleData& Hole);
 #pragma endregion
 
 	//~============================================================================
@@ -52,37 +95,111 @@ public:
 #pragma region Authority Only
 private:
 
-	UPROPERTY(Transient)
-	TArray<FIVSmokeHoleDynamicSubject> DynamicSubjectList;
-
 	/** Create hole data to be rendered by GPU. (todo: must be refactored) */
 	void Authority_CreateHole(const FIVSmokeHoleData& HoleData);
 
 	/** Clean up expired hole data and notify GPU to be updated. */
 	void Authority_CleanupExpiredHoles();
 
-	/** Calculate penetration entry & exit points via raycast. */
-	bool Authority_CalculatePenetrationPoints(const FVector3f& Origin, const FVector3f& Direction, const float BulletThickness, FVector3f& OutEntry, FVector3f& OutExit);
+	/** Activate the dynamic hole subject binding of an actor entering the generator box. */
+	UFUNCTION()
+	void Authority_OnSubjectBeginOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	/** Deactivate the dynamic hole subject binding of an actor leaving the generator box. */
+	UFUNCTION()
+	void Authority_OnSubjectEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
-	/** Manage the dynamic object's life cycle and update dynamic hole. */
-	void Authority_UpdateDynamicSubjectList();
+	/** Choose the quantization frame of replicated hole positions around the owning volume. */
+	void Authority_InitializeHoleNetFrame();
+
+	/** Periodically re-evaluate which holes each connection receives, so culled holes catch up once in range. */
+	void Authority_RefreshHoleRelevancy();
+
+	/** World time of the last hole relevancy refresh. */
+	float LastHoleRelevancyRefreshTime = 0.0f;
 #pragma endregion
 
 	//~============================================================================
 	// Local Only (Client & Standalone)
 #pragma region Local Only
 private:
-	UPROPERTY(Transient)
-	TObjectPtr<UTextureRenderTargetVolume> HoleTexture = nullptr;
-
-	/** Initialize 3D texture for hole data. */
+	/** Allocate the hole atlas slot at the current resolution and format. */
 	void Local_InitializeHoleTexture();
 
-	/** Clear hole texture to white. Called when all holes have expired. */
+	/** Clear hole texture to no holes. Called when all holes have expired. */
 	void Local_ClearHoleTexture();
 
-	/** Rebuild entire hole texture from ActiveHoles. (todo: must be refactored) */
-	void Local_RebuildHoleTexture();
+	/**
+	 * Carve the hole texture from ActiveHoles, either entirely or only over the pending dirty region.
+	 * @return True if the texture is up to date.
+	 */
+	bool Local_RebuildHoleTexture();
+
+	/** Returns true if any live hole changes its shape over time and must be re-carved every frame. */
+	bool Local_HasAnimatedHoles() const;
+
+	/**
+	 * Switch between carving the hole texture and evaluating the holes in the ray march.
+	 * Analytic mode needs at most AnalyticHoleThreshold live holes, no explosion and room in the ray march hole budget.
+	 * @param bHasHoles		Whether any hole is active or predicted.
+	 */
+	void Local_UpdateAnalyticHoleMode(const bool bHasHoles);
+
+	/** Leave analytic mode and return its share of the ray march hole budget to UIVSmokeAnalyticHoleSubsystem. */
+	void Local_ReleaseAnalyticHoleBudget();
+
+	/** Holes reserved in the ray march hole budget while in analytic mode. */
+	int32 ReservedAnalyticHoles = 0;
+
+	/** Return the hole atlas slot and remove it from the hole texture memory stats. */
+	void Local_ReleaseHoleTexture();
+
+	/** Slot in the FIVSmokeHoleAtlas of HoleAtlasFormat. INDEX_NONE if none is allocated. */
+	int32 HoleAtlasSlot = INDEX_NONE;
+
+	/** Format and resolution the slot was allocated for. */
+	EIVSmokeHoleTextureFormat HoleAtlasFormat = EIVSmokeHoleTextureFormat::HalfFloat;
+	FIntVector HoleAtlasResolution = FIntVector::ZeroValue;
+
+	/** Atlas layout generation the slot content was carved at. A different generation means the slot moved. */
+	uint32 CarvedAtlasGeneration = 0;
+
+	/** GPU memory of a half float texture at VoxelResolution, which this volume used to allocate, for comparison. */
+	int64 HoleTextureBaselineBytes = 0;
+
+	/** Layout of the current HoleTexture content. */
+	EIVSmokeHoleTextureEncoding HoleTextureEncoding = EIVSmokeHoleTextureEncoding::Baked;
+
+	/** Synced time the current HoleTexture was carved at. Lifetime encoded times are relative to it. */
+	float HoleTimeBase = 0.0f;
+
+	/** Synced time the first hole carved into a compact format texture expires at, which requires a re-carve. */
+	float BakedHolesExpirationTime = TNumericLimits<float>::Max();
+
+	/** Returns the earliest expiration time of the live active and predicted holes. */
+	float Local_GetNextHoleExpiration(const float CurrentServerTime) const;
+
+	/** Render thread buffer of the GPU list of ActiveHoles, updated incrementally by every carve. Released on the render thread. */
+	TSharedPtr<FIVSmokeHoleGPUListBuffer, ESPMode::ThreadSafe> HoleListBuffer;
+
+	/** Voxel world AABB the current HoleTexture was carved over. */
+	FVector3f CarvedVolumeMin = FVector3f::ZeroVector;
+	FVector3f CarvedVolumeMax = FVector3f::ZeroVector;
+
+	/** World bounds of every hole added or removed since the last carve. */
+	FBox3f PendingDirtyBounds = FBox3f(ForceInit);
+
+	/** Provisional holes of the shooting client, merged into the hole texture until reconciled. Never replicated. */
+	TArray<FIVSmokeHoleData> PredictedHoles;
+
+	/** World time each predicted hole is dropped at unless confirmed. Parallel to PredictedHoles. */
+	TArray<float> PredictedHoleDeadlines;
+
+	/** Drop predicted holes the server did not confirm within PredictedHoleTimeout. */
+	void Local_ExpirePredictedHoles();
+
+	/** Remove a predicted hole and mark its region for update. */
+	void Local_RemovePredictedHoleAt(const int32 Index);
 #pragma endregion
 
 	//~============================================================================
@@ -91,23 +208,74 @@ private:
 public:
 
 	/** Maximum number of holes that can be activated. */
-	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "1", ClampMax = "512"))
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "1", ClampMax = "8192"))
 	int32 MaxHoles = 128;
 
-	/** Hole voxel volume resolution. */
-	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "64", ClampMax = "128"))
+	/** Hole voxel volume resolution. Ignored if bAutoVoxelResolution is set. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "64", ClampMax = "128", EditCondition = "!bAutoVoxelResolution"))
 	FIntVector VoxelResolution = FIntVector(64, 64, 64);
 
+	/** Derive the hole texture resolution from the voxel grid extent and VoxelSize of the owning volume instead. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration")
+	bool bAutoVoxelResolution = false;
+
+	/** Hole texels per smoke voxel along each axis when bAutoVoxelResolution is set. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "0.5", ClampMax = "4.0", EditCondition = "bAutoVoxelResolution"))
+	float AutoResolutionScale = 2.0f;
+
+	/**
+	 * Storage format of the hole texture.
+	 * Compact formats use a half or an eighth of the memory but only store holes evaluated at the carve time.
+	 * They skip the region updates of HalfFloat: every hole change re-carves the whole texture, and so does
+	 * the expiration of each hole. Lifetime fades therefore step at those carves instead of animating smoothly.
+	 * While explosion holes are animating, every format re-carves the whole texture every frame.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration")
+	EIVSmokeHoleTextureFormat HoleTextureFormat = EIVSmokeHoleTextureFormat::HalfFloat;
+
+	/** Largest explosion distortion offset in world units stored by the RGBA8 format. Larger offsets are clamped. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "1.0", EditCondition = "HoleTextureFormat == EIVSmokeHoleTextureFormat::RGBA8"))
+	float CompactDistortionRange = 100.0f;
+
 	/** Maximum number of holes that can be activated. */
 	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration",
 		meta = (ToolTip = "Select the type of obstacle that will block the penetration hole in the smoke"))
 	TArray<TEnumAsByte<EObjectTypeQuery>> ObstacleObjectTypes;
 
+	/**
+	 * Volumes with at most this many live penetration and dynamic holes evaluate them per ray march sample
+	 * instead of carving and sampling the hole texture. Explosions always use the texture. 0 disables analytic holes.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "0", ClampMax = "32"))
+	int32 AnalyticHoleThreshold = 8;
+
 	/** Blur radius in voxels. */
 	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration", meta = (ClampMin = "0", ClampMax = "4",
 		Tooltip = "samples the surrounding pixels to reduce the aliasing. Recommended value is 2."))
 	int32 BlurStep = 2;
 
+	/**
+	 * Carve and blur the hole texture in a single pass while BlurStep is at most 2, instead of a carve and three blur passes.
+	 * Saves the intermediate texture sweeps, but every 8^3 brick also carves its blur apron, (8 + 2 * BlurStep)^3 voxels.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Configuration")
+	bool bFusedHoleBlur = true;
+
+	/**
+	 * Holes farther than this from a connection's view target are not replicated to it. 0 replicates every hole.
+	 * Holes are re-evaluated every HoleRelevancyRefreshInterval, so a client coming in range receives them then.
+	 */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Network", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "50000.0"))
+	float HoleNetCullDistance = 15000.0f;
+
+	/** Seconds between re-evaluations of the culled holes of every connection. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Network", meta = (ClampMin = "0.1", ClampMax = "10.0"))
+	float HoleRelevancyRefreshInterval = 1.0f;
+
+	/** Seconds a predicted hole stays visible without a matching replicated hole before it is dropped. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Prediction", meta = (ClampMin = "0.1", ClampMax = "5.0"))
+	float PredictedHoleTimeout = 1.0f;
+
 	/** Noise settings for penetration holes. */
 	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Noise")
 	FIVSmokeHoleNoiseSettings PenetrationNoise;
@@ -123,14 +291,53 @@ public:
 	/** Get synchronized server time. */
 	float GetSyncedTime() const;
 
-	/** Get Texture as a UTextureRenderTargetVolume to write by. */
-	FTextureRHIRef GetHoleTextureRHI() const;
-
-	/** Set BoxExtent and Component Position to VoxelAABB Center. */
+	/**
+	 * Returns where the hole texture lives in its FIVSmokeHoleAtlas.
+	 *
+	 * @param OutUVMin		Atlas UVW of the first texel of the hole texture.
+	 * @param OutUVMax		Atlas UVW past the last texel of the hole texture.
+	 * @param OutFormat		EIVSmokeHoleTextureFormat of the atlas, or FIVSmokeHoleAtlas::NoSlotFormat without a slot.
+	 */
+	void GetHoleAtlasSlot(FVector3f& OutUVMin, FVector3f& OutUVMax, uint32& OutFormat) const;
+
+	/**
+	 * Appends the holes the ray march evaluates analytically, with their conservative world bounds.
+	 *
+	 * @param OutHoles		Receives the live holes, with expiration times relative to the hole time base (see GetHoleTime).
+	 * @param OutBounds		Receives the world bounds minimum and maximum of each hole, interleaved.
+	 * @return				False if the holes are carved into the hole texture instead.
+	 */
+	bool GetAnalyticHoles(TArray<FIVSmokeHoleGPU>& OutHoles, TArray<FVector4f>& OutBounds) const;
+
+	/** Returns true if the holes are evaluated in the ray march and the hole texture is kept empty. */
+	FORCEINLINE bool IsAnalyticHoleMode() const { return bAnalyticHoleMode; }
+
+	/** Returns the layout of the hole texture content. Compact formats always hold the baked layout. */
+	FORCEINLINE EIVSmokeHoleTextureEncoding GetHoleTextureEncoding() const
+	{
+		return HoleTextureFormat == EIVSmokeHoleTextureFormat::HalfFloat ? HoleTextureEncoding : EIVSmokeHoleTextureEncoding::Baked;
+	}
+
+	/** Returns the resolution the hole texture is created at, derived from the owning volume if bAutoVoxelResolution is set. */
+	FIntVector GetHoleTextureResolution() const;
+
+	/** Returns the synced time relative to the time base of the hole texture, used to evaluate lifetime fades. */
+	FORCEINLINE float GetHoleTime() const { return GetSyncedTime() - HoleTimeBase; }
+
+	/** Set BoxExtent and Component Position to VoxelAABB Center. Does nothing while the VoxelAABB is unchanged. */
 	void SetBoxToVoxelAABB();
 
-	/** Set Dirty flag whether GPU updates the texure. */
-	FORCEINLINE void MarkHoleTextureDirty(const bool bIsDirty = true) { bHoleTextureDirty = bIsDirty; }
+	/** Returns the replicated holes currently active in this smoke volume. */
+	FORCEINLINE const FIVSmokeHoleArray& GetActiveHoles() const { return ActiveHoles; }
+
+	/** Returns the quantization frame of replicated hole positions. */
+	FORCEINLINE const FIVSmokeHoleNetFrame& GetHoleNetFrame() const { return HoleNetFrame; }
+
+	/** Set Dirty flag whether GPU rebuilds the whole texture. False also discards pending region updates. */
+	void MarkHoleTextureDirty(const bool bIsDirty = true);
+
+	/** Mark only the texture region the hole covers for update. Called when a single hole is added or removed. */
+	void MarkHoleRegionDirty(const FIVSmokeHoleData& Hole);
 
 private:
 
@@ -138,7 +345,23 @@ private:
 	UPROPERTY(Transient, Replicated, VisibleAnywhere, Category = "IVSmoke | Hole | Debug")
 	FIVSmokeHoleArray ActiveHoles;
 
+	/** Quantization frame of ActiveHoles positions. Replicated once, before any hole. */
+	UPROPERTY(Transient, Replicated)
+	FIVSmokeHoleNetFrame HoleNetFrame;
+
+	/** Calculate penetration entry & exit points via raycast. Used by the server and by client prediction. */
+	bool CalculatePenetrationPoints(const FVector3f& Origin, const FVector3f& Direction, const float BulletThickness, FVector3f& OutEntry, FVector3f& OutExit);
+
+	/** Voxel world AABB last applied to the box by SetBoxToVoxelAABB. Invalid until the first update. */
+	FBox AppliedVoxelAABB = FBox(ForceInit);
+
 	/** HoleTexture dirty flag. */
 	uint8 bHoleTextureDirty : 1;
+
+	/** Whether the dirty HoleTexture needs a full rebuild instead of a region update. */
+	uint8 bHoleTextureFullRebuild : 1;
+
+	/** Whether the holes are evaluated in the ray march instead of the HoleTexture. */
+	uint8 bAnalyticHoleMode : 1;
 #pragma endregion
 };
@@ -0,0 +1,190 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/VectorRegister.h"
+#include "IVSmokeHolePreset.h"
+
+struct FIVSmokeHoleArray;
+
+/**
+ * World space description of a single hole, independent of its preset.
+ */
+struct FIVSmokeHoleShape
+{
+	/** Geometry used to evaluate this hole. */
+	EIVSmokeHoleType HoleType = EIVSmokeHoleType::Penetration;
+
+	/** Hole start position. Explosion center. */
+	FVector3f Position = FVector3f::ZeroVector;
+
+	/** Hole end position. Ignored by explosions. */
+	FVector3f EndPosition = FVector3f::ZeroVector;
+
+	/** Radius at Position (Penetration, Explosion). */
+	float Radius = 0.0f;
+
+	/** Radius at EndPosition (Penetration). */
+	float EndRadius = 0.0f;
+
+	/** Full size of the hole body (Dynamic). */
+	FVector3f Extent = FVector3f::ZeroVector;
+};
+
+/**
+ * CPU evaluation of the carved region of a hole set.
+ *
+ * ## Overview
+ * Mirrors the shapes of `IVSmokeHoleCarveCS.usf` without noise, softness or fades:
+ * - Penetration: cone segment between Position and EndPosition without caps.
+ * - Explosion: ellipsoid with the Z offset scaled by 0.7.
+ * - Dynamic: box body plus two sphere caps in the movement frame.
+ *
+ * A point is carved when it lies strictly inside any shape.
+ *
+ * ## Layout
+ * Holes are binned into a uniform grid over their combined bounds. Every bin stores the overlapping
+ * holes as SoA packets of four lanes per hole type, so a point query evaluates four holes per
+ * instruction and only touches the holes of a single bin.
+ *
+ * Used by `UIVSmokeSightQuerySubsystem` and `UIVSmokeCollisionComponent` to subtract holes from `VoxelBits`.
+ * `IVSmoke.Holes.VerifyOccupancy` compares the packed evaluation against a scalar reference on known configurations.
+ */
+struct IVSMOKE_API FIVSmokeHoleOccupancy
+{
+	/**
+	 * Rebuilds the occupancy from replicated hole data.
+	 * Expired holes and holes with an unknown preset are skipped.
+	 *
+	 * @param Holes					Active holes of a hole generator.
+	 * @param CurrentServerTime		Synced server time, used to skip expired holes.
+	 */
+	void Build(const FIVSmokeHoleArray& Holes, float CurrentServerTime);
+
+	/**
+	 * Rebuilds the occupancy from explicit shapes.
+	 *
+	 * @param InShapes		World space hole shapes.
+	 */
+	void Build(TConstArrayView<FIVSmokeHoleShape> InShapes);
+
+	/** Removes all holes. Keeps allocations. */
+	void Reset();
+
+	/** Returns true if no hole is registered. */
+	FORCEINLINE bool IsEmpty() const { return NumShapes == 0; }
+
+	/** Returns the number of registered holes. */
+	FORCEINLINE int32 GetNumShapes() const { return NumShapes; }
+
+	/** Returns the world bounds covering every hole. */
+	FORCEINLINE const FBox3f& GetBounds() const { return Bounds; }
+
+	/**
+	 * Returns true if the world position lies inside any hole.
+	 *
+	 * @param WorldPos		Position to test.
+	 */
+	bool IsPointCarved(const FVector3f& WorldPos) const;
+
+	/**
+	 * Clears the bit of every active voxel whose center lies inside a hole.
+	 *
+	 * @param VoxelBits			Bit-packed voxel occupancy (uint64 per YZ row) to mask in place.
+	 * @param GridResolution	The resolution of the voxel grid (X must not exceed 64).
+	 * @param VoxelSize			World space size of a single voxel.
+	 * @param LocalToWorld		Transform of the grid space origin (grid center).
+	 * @return					Number of cleared voxels.
+	 */
+	int32 MaskVoxelBits(TArray<uint64>& VoxelBits, const FIntVector& GridResolution, float VoxelSize, const FTransform& LocalToWorld) const;
+
+	/**
+	 * Scalar reference evaluation of a single shape. Matches the packed evaluation and is used for verification.
+	 *
+	 * @param Shape			Hole shape.
+	 * @param WorldPos		Position to test.
+	 */
+	static bool IsPointInsideShape(const FIVSmokeHoleShape& Shape, const FVector3f& WorldPos);
+
+	/**
+	 * Returns the conservative world bounds of a shape.
+	 *
+	 * @param Shape			Hole shape.
+	 */
+	static FBox3f CalculateShapeBounds(const FIVSmokeHoleShape& Shape);
+
+private:
+	/** Four explosion ellipsoids. */
+	struct FSpherePacket
+	{
+		VectorRegister4Float CenterX, CenterY, CenterZ;
+		VectorRegister4Float RadiusSquared;
+	};
+
+	/** Four penetration cone segments. */
+	struct FConePacket
+	{
+		VectorRegister4Float StartX, StartY, StartZ;
+		VectorRegister4Float DirX, DirY, DirZ;
+		VectorRegister4Float InvLength;
+		VectorRegister4Float Radius, RadiusDelta;
+		VectorRegister4Float LaneMask;
+	};
+
+	/** Four dynamic capsules in their movement frame. */
+	struct FDynamicPacket
+	{
+		VectorRegister4Float CenterX, CenterY, CenterZ;
+		VectorRegister4Float RightX, RightY, RightZ;
+		VectorRegister4Float ForwardX, ForwardY, ForwardZ;
+		VectorRegister4Float UpX, UpY, UpZ;
+		VectorRegister4Float HalfX, HalfY, BodyHalfHeight;
+		VectorRegister4Float CapRadiusSquared;
+		VectorRegister4Float LaneMask;
+	};
+
+	/** Packet range of a single bin per hole type. */
+	struct FBin
+	{
+		int32 SphereBegin = 0;
+		int32 SphereNum = 0;
+		int32 ConeBegin = 0;
+		int32 ConeNum = 0;
+		int32 DynamicBegin = 0;
+		int32 DynamicNum = 0;
+	};
+
+	/** Bins `Shapes` and packs every bin into SoA packets. */
+	void BuildPackets();
+
+	/** Returns the bin containing the position, or nullptr if outside the bounds. */
+	const FBin* FindBin(const FVector3f& WorldPos) const;
+
+	/** Evaluates every packet of a bin. */
+	bool IsPointCarvedInBin(const FBin& Bin, const FVector3f& WorldPos) const;
+
+	/** Source shapes of the current build. */
+	TArray<FIVSmokeHoleShape> Shapes;
+
+	/** Scratch data of the binning pass, kept to avoid reallocation on rebuild. */
+	TArray<FBox3f> ShapeBounds;
+	TArray<int32> BinShapeOffsets;
+	TArray<int32> BinShapeIndices;
+
+	TArray<FSpherePacket> SpherePackets;
+	TArray<FConePacket> ConePackets;
+	TArray<FDynamicPacket> DynamicPackets;
+	TArray<FBin> Bins;
+
+	/** Combined bounds of every hole. */
+	FBox3f Bounds = FBox3f(ForceInit);
+
+	/** Number of bins along each axis. */
+	FIntVector BinCount = FIntVector::ZeroValue;
+
+	/** Reciprocal of the bin edge length. */
+	float InvBinSize = 0.0f;
+
+	int32 NumShapes = 0;
+};
@@ -25,6 +25,7 @@ enum class EIVSmokeHoleType : uint8
 /**
  * Data asset containing hole configuration preset.
  * Automatically registered to global registry on load.
+ * List it in UIVSmokeSettings::HolePresets so its id matches between server and clients.
  */
 UCLASS(BlueprintType)
 class IVSMOKE_API UIVSmokeHolePreset : public UPrimaryDataAsset
@@ -34,6 +35,9 @@ class IVSMOKE_API UIVSmokeHolePreset : public UPrimaryDataAsset
 protected:
 	virtual void PostLoad() override;
 	virtual void BeginDestroy() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 public:
 	//~============================================================================
@@ -146,14 +150,24 @@ public:
 
 	// ============================================================================
 
-	/** Returns the this preset id. */
+	/** Number of preset ids. ID 0 is never assigned. */
+	static constexpr int32 MaxPresetIDs = 256;
+
+	/** Returns the this preset id, or 0 if not registered. */
 	FORCEINLINE uint8 GetPresetID() const { return CachedID; }
 
+	/** Returns the index of this preset in FIVSmokeHolePresetTable, or INDEX_NONE if not registered. */
+	FORCEINLINE int32 GetGPUIndex() const { return GPUIndex; }
+
 	/**
 	 * Find and return the preset with the key id.
 	 * If not, return nullptr.
 	 */
-	static TObjectPtr<UIVSmokeHolePreset> FindByID(const uint8 InPresetID);
+	static FORCEINLINE TObjectPtr<UIVSmokeHolePreset> FindByID(const uint8 InPresetID)
+	{
+		static_assert(MaxPresetIDs > TNumericLimits<uint8>::Max(), "Every uint8 id must index the registry.");
+		return Registry[InPresetID];
+	}
 
 	/**
 	 * Returns the y value corresponding to the x value of the curve.
@@ -165,6 +179,22 @@ private:
 	/** Cached preset id. */
 	uint8 CachedID = 0;
 
+	/** Index in FIVSmokeHolePresetTable. */
+	int32 GPUIndex = INDEX_NONE;
+
+	/**
+	 * Registered presets indexed by id. Ids come from UIVSmokeSettings::HolePresets, see AssignPresetID.
+	 * Entries are cleared in BeginDestroy, so they never point to a destroyed preset.
+	 */
+	static UIVSmokeHolePreset* Registry[MaxPresetIDs];
+
+	/**
+	 * Returns the id of this preset, assigning one on first registration. 0 if every id is taken.
+	 * Listed presets use their position in UIVSmokeSettings::HolePresets, others an id above the listed range
+	 * hashed from their path and probed upwards while taken.
+	 */
+	uint8 AssignPresetID() const;
+
 	/** Register this preset to global registry. */
 	void RegisterToGlobalRegistry();
 
@@ -0,0 +1,80 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IVSmokeHoleShaders.h"
+#include "RenderGraphFwd.h"
+
+class FRDGBuilder;
+class UIVSmokeHolePreset;
+
+/**
+ * Immutable copy of FIVSmokeHolePresetTable handed to the render thread.
+ */
+struct FIVSmokeHolePresetSnapshot
+{
+	/** Preset parameters, indexed by UIVSmokeHolePreset::GetGPUIndex(). */
+	TArray<FIVSmokeHolePresetGPU> Entries;
+
+	/** Table version the snapshot was taken at. */
+	uint32 Version = 0;
+};
+
+/**
+ * GPU parameters of every registered UIVSmokeHolePreset, indexed by a dense preset index.
+ *
+ * ## Overview
+ * Presets write their parameters into the table when they register and whenever they are edited, so
+ * FIVSmokeHoleGPU only carries the preset index and IVSmokeHoleCarveCS.usf reads the shared parameters
+ * from HolePresetBuffer. The render thread keeps the uploaded buffer across carves and uploads it again
+ * only when the table version changed.
+ *
+ * Index 0 is a zeroed entry, so zero-initialized dummy holes carve nothing.
+ *
+ * @note Game thread only, except RegisterBuffer.
+ */
+class IVSMOKE_API FIVSmokeHolePresetTable
+{
+public:
+	using FSnapshotRef = TSharedRef<const FIVSmokeHolePresetSnapshot, ESPMode::ThreadSafe>;
+
+	/** Returns the global table. */
+	static FIVSmokeHolePresetTable& Get();
+
+	/** Allocates an entry for the preset and returns its index. */
+	int32 Register(const UIVSmokeHolePreset& Preset);
+
+	/** Rewrites the entry from the preset, e.g. after it was edited. */
+	void Update(const int32 Index, const UIVSmokeHolePreset& Preset);
+
+	/** Frees the entry. */
+	void Unregister(const int32 Index);
+
+	/** Returns the entry at index, or the zeroed entry if the index is invalid. */
+	const FIVSmokeHolePresetGPU& GetEntry(const int32 Index) const;
+
+	/** Returns an immutable copy of the table. The same copy is shared until the table changes. */
+	FSnapshotRef GetSnapshot();
+
+	/**
+	 * Returns the preset buffer of a snapshot. Render thread only.
+	 * The buffer persists across graphs and is uploaded only if the snapshot is newer than the last upload.
+	 */
+	static FRDGBufferRef RegisterBuffer(FRDGBuilder& GraphBuilder, const FIVSmokeHolePresetSnapshot& Snapshot);
+
+private:
+	FIVSmokeHolePresetTable();
+
+	/** Preset parameters. Entry 0 stays zeroed. */
+	TArray<FIVSmokeHolePresetGPU> Entries;
+
+	/** Freed entries, reused before the table grows. */
+	TArray<int32> FreeIndices;
+
+	/** Incremented on every change. */
+	uint32 Version = 1;
+
+	/** Copy of the current version, created on demand. */
+	TSharedPtr<const FIVSmokeHolePresetSnapshot, ESPMode::ThreadSafe> Snapshot;
+};
@@ -3,11 +3,20 @@
 #pragma once
 
 #include "Components/ActorComponent.h"
+#include "IVSmokeHoleData.h"
 #include "IVSmokeHoleRequestComponent.generated.h"
 
 class UIVSmokeHoleGeneratorComponent;
 class UIVSmokeHolePreset;
 
+/** Shots queued on the client for one generator and preset, waiting for the next batch flush. */
+struct FIVSmokePendingHoleShots
+{
+	TWeakObjectPtr<UIVSmokeHoleGeneratorComponent> Generator;
+	TWeakObjectPtr<UIVSmokeHolePreset> Preset;
+	TArray<FIVSmokeHoleShot> Shots;
+};
+
 /**
  * @brief Handles network routing for hole requests.
  *        This component enables clients to request holes on VoxelVolumes
@@ -21,6 +30,13 @@ class IVSMOKE_API UIVSmokeHoleRequestComponent : public UActorComponent
 public:
 	UIVSmokeHoleRequestComponent();
 
+protected:
+	virtual void BeginPlay() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+
 	/** Find RequestComponent on Instigator's Pawn or PlayerController. */
 	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Hole | API")
 	static UIVSmokeHoleRequestComponent* GetHoleRequester(const APawn* Instigator);
@@ -36,4 +52,64 @@ public:
 	/** Request a dynamic hole. Always executed on server. */
 	UFUNCTION(BlueprintCallable, Server, Reliable, Category = "IVSmoke | Hole | API")
 	void RequestDynamicHole(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, AActor* TargetActor, UIVSmokeHolePreset* Preset);
+
+	//~============================================================================
+	// Batched Requests
+#pragma region Batching
+public:
+	/**
+	 * Queue a penetration hole for the next batched request. Intended for automatic weapons.
+	 * Shots are grouped per generator and preset and sent with one RPC per group every MaxBatchInterval,
+	 * or as soon as a group reaches MaxBatchShots. On the authority the hole is created immediately.
+	 * With bPredictPenetrationHoles, the client shows a predicted hole right away until the server confirms or rejects it.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Hole | API")
+	void QueuePenetrationHole(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, const FVector3f& Origin, const FVector3f& Direction, UIVSmokeHolePreset* Preset);
+
+	/** Send all queued shots now. */
+	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Hole | API")
+	void FlushHoleRequests();
+
+	/** Request penetration holes for a batch of quantized shots sharing one preset. Always executed on server. */
+	UFUNCTION(Server, Reliable)
+	void RequestPenetrationHoleBatch(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, UIVSmokeHolePreset* Preset, const TArray<FIVSmokeHoleShot>& Shots);
+
+	/** Drop the predicted holes of shots the server rejected. Always executed on the owning client. */
+	UFUNCTION(Client, Reliable)
+	void ClientRejectPredictedHoles(UIVSmokeHoleGeneratorComponent* IVSmokeHoleGeneratorComponent, const TArray<uint16>& PredictionKeys);
+
+	/** Whether queued shots insert a predicted hole on the shooting client before the server replicates the real one. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Prediction")
+	bool bPredictPenetrationHoles = true;
+
+	/** Maximum time in seconds a queued shot waits before its batch is sent. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Batching", meta = (ClampMin = "0.0", ClampMax = "0.5"))
+	float MaxBatchInterval = 0.1f;
+
+	/** Maximum number of shots per batched request. The server ignores shots beyond it. */
+	UPROPERTY(EditAnywhere, Category = "IVSmoke | Hole | Batching", meta = (ClampMin = "1", ClampMax = "64"))
+	int32 MaxBatchShots = 32;
+
+private:
+	/** Sends one group and empties it. */
+	void FlushPendingShots(FIVSmokePendingHoleShots& Pending);
+
+	/** Returns the next non-zero prediction key. */
+	uint16 AllocatePredictionKey();
+
+	/**
+	 * Returns the player id that scopes this component's prediction keys, or INDEX_NONE without a PlayerState.
+	 * Read from the owning Pawn or PlayerController, so server and owning client agree on it.
+	 */
+	int32 GetPredictionOwnerID() const;
+
+	/** Last prediction key handed out. Keys are scoped to GetPredictionOwnerID; the random start keeps a respawned component from reusing keys still in flight. */
+	uint16 LastPredictionKey = 0;
+
+	/** Shots waiting for the next flush, one entry per generator and preset. */
+	TArray<FIVSmokePendingHoleShots> PendingShots;
+
+	/** World time the oldest pending shot was queued at. */
+	float PendingSinceTime = 0.0f;
+#pragma endregion
 };
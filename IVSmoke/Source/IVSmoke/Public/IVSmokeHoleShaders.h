@@ -13,80 +13,119 @@ struct FIVSmokeHoleData;
 // GPU Data Structure
 
 /**
- * @struct FIVSmokeHoleGPU
- * @brief Built from FIVSmokeHoleData + UIVSmokeHolePreset at render time.
+ * Layout of the hole texture. Must match IVSMOKE_HOLE_ENCODING_* in IVSmokeCommon.ush.
  */
-struct alignas(16) FIVSmokeHoleGPU
+enum class EIVSmokeHoleTextureEncoding : uint32
 {
-	FIVSmokeHoleGPU() = default;
+	/** rgb = distortion offset, a = density multiplier. Must be re-carved every frame while holes animate. */
+	Baked = 0,
 
-	/**
-	 * You can Constructs a FIVSmokeHoleGPU using DynamicHoleData, Preset, and server time.
-	 * @param DynamicHoleData		Dynamic hole data.
-	 * @param Preset				HolePreset defined as DataAsset.
-	 * @param CurrentServerTime		The CurrentServerTime is obtained through the GetSyncedTime function.
-	 */
-	FIVSmokeHoleGPU(const FIVSmokeHoleData& DynamicHoleData, const UIVSmokeHolePreset& Preset, const float CurrentServerTime);
+	/** r = carve strength, gba = strength * (remaining lifetime, duration, fade exponent). Fades are evaluated in the ray march. */
+	Lifetime = 1,
+};
 
-	//~============================================================================
-	// Common
+/**
+ * @struct FIVSmokeHolePresetGPU
+ * @brief Parameters of a UIVSmokeHolePreset shared by every hole using it. See FIVSmokeHolePresetTable.
+ */
+struct alignas(16) FIVSmokeHolePresetGPU
+{
+	FIVSmokeHolePresetGPU() = default;
 
-	/** The central point of hole creation. */
-	FVector3f Position;
+	/** Copies the shader parameters of the preset. */
+	explicit FIVSmokeHolePresetGPU(const UIVSmokeHolePreset& Preset);
 
-	/** Time after hole is called creation. */
-	float CurLifeTime;
+	//~============================================================================
+	// Common
 
 	/** 0 = Penetration, 1 = Explosion, 2 = Dynamic */
-	int HoleType;
+	int HoleType = 0;
 
 	/** Radius value used to calculate values related to the range. */
-	float Radius;
+	float Radius = 0.0f;
 
 	/** Total duration. */
-	float Duration;
+	float Duration = 0.0f;
 
 	/** Edge smooth range. */
-	float Softness;
+	float Softness = 0.0f;
 
 	//~============================================================================
-	// Dynamic
+	// Dynamic / Penetration
 
 	/** the size of a hole. */
-	FVector3f Extent;
+	FVector3f Extent = FVector3f::ZeroVector;
 
-	float DynamicPadding;
+	/** Radius at the end position. */
+	float EndRadius = 0.0f;
 
 	//~============================================================================
 	// Explosion
 
 	/** Expansion time used only for Explosion. */
-	float ExpansionDuration;
-
-	/** Current fadeRange extracted from ExpansionFadeRangeCurveOverTime with values normalized to expansion time. */
-	float CurExpansionFadeRangeOverTime;
-
-	/** Current fadeRange extracted from ShrinkFadeRangeCurveOverTime with values normalized to shrink time. */
-	float CurShrinkFadeRangeOverTime;
+	float ExpansionDuration = 0.0f;
 
 	/** Exponential value of the calculation of the distortion value over expansion time. */
-	float DistortionExpOverTime;
+	float DistortionExpOverTime = 0.0f;
 
 	/** Distortion degree max value. */
-	float DistortionDistance;
+	float DistortionDistance = 0.0f;
+
+	/** FIVSmokeCurveAtlas row of ExpansionFadeRangeCurveOverTime. */
+	uint32 ExpansionCurveRow = 0;
+
+	/** FIVSmokeCurveAtlas row of ShrinkFadeRangeCurveOverTime. */
+	uint32 ShrinkCurveRow = 0;
 
-	FVector3f PresetExplosionPadding;
+	FVector3f Padding = FVector3f::ZeroVector;
+};
+
+static_assert(sizeof(FIVSmokeHolePresetGPU) == 64, "FIVSmokeHolePresetGPU must match FHolePresetGPU in IVSmokeHoleSdf.ush");
+
+/**
+ * @struct FIVSmokeHoleGPU
+ * @brief Built once from FIVSmokeHoleData + UIVSmokeHolePreset when the hole enters its FIVSmokeHoleGPUList.
+ *
+ * Only the per-hole state is stored. Preset parameters are read from HolePresetBuffer at PresetIndex.
+ * The age of the hole is derived from ExpirationTime at the evaluated time (see GetLifeTime), so the entry
+ * never changes while the hole lives, and explosion fade ranges are sampled from the preset curves in
+ * CurveAtlas at that age.
+ */
+struct alignas(16) FIVSmokeHoleGPU
+{
+	FIVSmokeHoleGPU() = default;
+
+	/**
+	 * You can Constructs a FIVSmokeHoleGPU using DynamicHoleData and Preset.
+	 * @param DynamicHoleData		Dynamic hole data.
+	 * @param Preset				HolePreset defined as DataAsset.
+	 */
+	FIVSmokeHoleGPU(const FIVSmokeHoleData& DynamicHoleData, const UIVSmokeHolePreset& Preset);
+
+	/** Returns the time since the hole was created, at Time. Must match GetHoleLifeTime in IVSmokeHoleSdf.ush. */
+	FORCEINLINE float GetLifeTime(const FIVSmokeHolePresetGPU& Preset, const float Time) const
+	{
+		return Preset.Duration - (ExpirationTime - Time);
+	}
 
 	//~============================================================================
-	// Penetration
+	// Common
+
+	/** The central point of hole creation. */
+	FVector3f Position;
+
+	/** Synced server time the hole expires at. */
+	float ExpirationTime;
 
-	/** The point at which the trajectory of the penetration ends. */
+	/** The point at which the trajectory of the penetration or dynamic hole ends. */
 	FVector3f EndPosition;
 
-	/** Radius at the end position. */
-	float EndRadius;
+	/** Index of the preset in FIVSmokeHolePresetTable. */
+	uint32 PresetIndex;
 };
 
+static_assert(sizeof(FIVSmokeHoleGPU) == 32, "FIVSmokeHoleGPU must match FHoleGPU in IVSmokeHoleSdf.ush");
+
 /**
  * @brief Compute shader that carves holes into 3D volume texture.
  */
@@ -106,8 +145,20 @@ public:
 		// Output: 3D Volume Texture (Read and Write) - R16G16B16A16_UNORM channel
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture3D<float4>, VolumeTexture)
 
-		// Input: Hole data buffer (unified structure)
+		// Input: Hole data buffer (persistent FIVSmokeHoleGPUList), followed by the local-only overlay holes
 		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHoleGPU>, HoleBuffer)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHoleGPU>, OverlayHoleBuffer)
+
+		// Input: Preset parameters indexed by FIVSmokeHoleGPU::PresetIndex (see FIVSmokeHolePresetTable)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHolePresetGPU>, HolePresetBuffer)
+
+		// Input: Baked fade range curves of the presets (see FIVSmokeCurveAtlas)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float>, CurveAtlas)
+
+		// Input: Per-brick hole lists (see FIVSmokeHoleBrickBins)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FUintVector2>, BrickRanges)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint32>, BrickHoleIndices)
+		SHADER_PARAMETER(FIntVector, BrickCount)
 
 		// Volume bounds (local space)
 		SHADER_PARAMETER(FVector3f, VolumeMin)
@@ -116,8 +167,23 @@ public:
 		// Volume resolution
 		SHADER_PARAMETER(FIntVector, Resolution)
 
-		// Hole parameters
-		SHADER_PARAMETER(int32, NumHoles)
+		// Carved region
+		SHADER_PARAMETER(FIntVector, RegionMin)
+		SHADER_PARAMETER(FIntVector, RegionSize)
+
+		// Texel of VolumeTexture the first region voxel is written to (hole atlas slot or transient texture)
+		SHADER_PARAMETER(FIntVector, OutputOffset)
+
+		// Hole parameters: entries of HoleBuffer (later hole indices read OverlayHoleBuffer), and the synced time holes are evaluated at
+		SHADER_PARAMETER(int32, NumListHoles)
+		SHADER_PARAMETER(float, HoleTime)
+
+		// EIVSmokeHoleTextureEncoding of the output
+		SHADER_PARAMETER(int32, HoleEncoding)
+
+		// EIVSmokeHoleTextureFormat of the output, and the distortion offset stored as 1 by RGBA8
+		SHADER_PARAMETER(int32, HoleFormat)
+		SHADER_PARAMETER(float, DistortionRange)
 
 		// Noise textures (per HoleType)
 		SHADER_PARAMETER_TEXTURE(Texture2D, PenetrationNoiseTexture)
@@ -151,6 +217,57 @@ public:
 	}
 };
 
+/**
+ * @brief Compute shader that carves holes and blurs them in one pass.
+ *        Each group carves a brick of the write region plus a BlurStep apron into groupshared memory,
+ *        blurs it there and writes the brick once, instead of a carve and three FIVSmokeHoleBlurCS passes.
+ *        The apron is carved by every neighbouring group, so bricks cost (8 + 2 * BlurStep)^3 voxel carves.
+ */
+class IVSMOKE_API FIVSmokeHoleFusedCarveCS : public FGlobalShader
+{
+public:
+	static constexpr uint32 ThreadGroupSizeX = 8;
+	static constexpr uint32 ThreadGroupSizeY = 8;
+	static constexpr uint32 ThreadGroupSizeZ = 8;
+	static constexpr const TCHAR* EventName = TEXT("IVSmokeHoleFusedCarveCS");
+	DECLARE_GLOBAL_SHADER(FIVSmokeHoleFusedCarveCS);
+	SHADER_USE_PARAMETER_STRUCT(FIVSmokeHoleFusedCarveCS, FGlobalShader);
+
+	/** Largest blur radius the groupshared apron holds: (8 + 2 * 2)^3 float4 texels take 27 KB. */
+	static constexpr int32 MaxBlurStep = 2;
+
+public:
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		// Carve parameters. RegionMin and RegionSize are the carved region, OutputOffset is where the write region goes
+		SHADER_PARAMETER_STRUCT_INCLUDE(FIVSmokeHoleCarveCS::FParameters, Carve)
+
+		// Blur radius in voxels, at most MaxBlurStep
+		SHADER_PARAMETER(int32, BlurStep)
+
+		// Written voxels: WriteSize voxels from WriteOffset of the carved region
+		SHADER_PARAMETER(FIntVector, WriteOffset)
+		SHADER_PARAMETER(FIntVector, WriteSize)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(
+		const FGlobalShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment
+	)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), ThreadGroupSizeZ);
+		OutEnvironment.SetDefine(TEXT("IVSMOKE_HOLE_FUSED_BLUR"), 1);
+		OutEnvironment.SetDefine(TEXT("IVSMOKE_HOLE_FUSED_MAX_BLUR_STEP"), MaxBlurStep);
+	}
+};
+
 /**
  * @brief Compute shader for 1D separable blur on 3D volume texture.
  *        Run 3 times (X, Y, Z axis) for full 3D Gaussian blur.
@@ -177,6 +294,11 @@ public:
 		// Volume resolution
 		SHADER_PARAMETER(FIntVector, Resolution)
 
+		// Blurred texels: DispatchSize texels from DispatchOffset of the input, written from OutputOffset of the output
+		SHADER_PARAMETER(FIntVector, DispatchOffset)
+		SHADER_PARAMETER(FIntVector, DispatchSize)
+		SHADER_PARAMETER(FIntVector, OutputOffset)
+
 		// Blur direction: (1,0,0) for X, (0,1,0) for Y, (0,0,1) for Z
 		SHADER_PARAMETER(FIntVector, BlurDirection)
 
@@ -200,3 +322,132 @@ public:
 		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), ThreadGroupSizeZ);
 	}
 };
+
+/**
+ * @brief Compute shader clearing one slot of a hole atlas to "no hole".
+ *        See FIVSmokeHoleAtlas.
+ */
+class IVSMOKE_API FIVSmokeHoleAtlasClearCS : public FGlobalShader
+{
+public:
+	static constexpr uint32 ThreadGroupSizeX = 8;
+	static constexpr uint32 ThreadGroupSizeY = 8;
+	static constexpr uint32 ThreadGroupSizeZ = 8;
+	static constexpr const TCHAR* EventName = TEXT("IVSmokeHoleAtlasClearCS");
+	DECLARE_GLOBAL_SHADER(FIVSmokeHoleAtlasClearCS);
+	SHADER_USE_PARAMETER_STRUCT(FIVSmokeHoleAtlasClearCS, FGlobalShader);
+
+public:
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		// Output: Hole atlas
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture3D<float4>, HoleAtlas)
+
+		// Cleared box
+		SHADER_PARAMETER(FIntVector, ClearMin)
+		SHADER_PARAMETER(FIntVector, ClearSize)
+
+		// See FIVSmokeHoleAtlas::GetClearValue
+		SHADER_PARAMETER(FVector4f, ClearValue)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(
+		const FGlobalShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment
+	)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), ThreadGroupSizeZ);
+	}
+};
+
+/**
+ * @brief Compute shader writing added and removed entries into the GPU buffer of a FIVSmokeHoleGPUList.
+ */
+class IVSMOKE_API FIVSmokeHoleListScatterCS : public FGlobalShader
+{
+public:
+	static constexpr uint32 ThreadGroupSizeX = 64;
+	static constexpr uint32 ThreadGroupSizeY = 1;
+	static constexpr uint32 ThreadGroupSizeZ = 1;
+	static constexpr const TCHAR* EventName = TEXT("IVSmokeHoleListScatterCS");
+	DECLARE_GLOBAL_SHADER(FIVSmokeHoleListScatterCS);
+	SHADER_USE_PARAMETER_STRUCT(FIVSmokeHoleListScatterCS, FGlobalShader);
+
+public:
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		// Output: GPU hole list
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<FIVSmokeHoleGPU>, HoleList)
+
+		// Input: Written entries and their list indices
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHoleGPU>, Writes)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint32>, WriteIndices)
+		SHADER_PARAMETER(uint32, NumWrites)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(
+		const FGlobalShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment
+	)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), ThreadGroupSizeZ);
+	}
+};
+
+/**
+ * @brief Compute shader dropping removed and expired entries from the GPU buffer of a FIVSmokeHoleGPUList.
+ *        Runs as a single group and keeps the order of the surviving entries, like FIVSmokeHoleGPUList::Compact.
+ */
+class IVSMOKE_API FIVSmokeHoleListCompactCS : public FGlobalShader
+{
+public:
+	static constexpr uint32 ThreadGroupSizeX = 1024;
+	static constexpr uint32 ThreadGroupSizeY = 1;
+	static constexpr uint32 ThreadGroupSizeZ = 1;
+	static constexpr const TCHAR* EventName = TEXT("IVSmokeHoleListCompactCS");
+	DECLARE_GLOBAL_SHADER(FIVSmokeHoleListCompactCS);
+	SHADER_USE_PARAMETER_STRUCT(FIVSmokeHoleListCompactCS, FGlobalShader);
+
+public:
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		// Input: GPU hole list before the compaction
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHoleGPU>, HoleList)
+
+		// Output: Surviving entries, in list order
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<FIVSmokeHoleGPU>, CompactedHoleList)
+
+		// Entries of HoleList, and the synced time entries expiring at or before it are dropped at
+		SHADER_PARAMETER(uint32, NumEntries)
+		SHADER_PARAMETER(float, CompactTime)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+	}
+
+	static void ModifyCompilationEnvironment(
+		const FGlobalShaderPermutationParameters& Parameters,
+		FShaderCompilerEnvironment& OutEnvironment
+	)
+	{
+		FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEX"), ThreadGroupSizeX);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEY"), ThreadGroupSizeY);
+		OutEnvironment.SetDefine(TEXT("THREADGROUP_SIZEZ"), ThreadGroupSizeZ);
+	}
+};
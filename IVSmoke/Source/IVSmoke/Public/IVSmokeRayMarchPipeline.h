@@ -40,6 +40,9 @@ struct FIVSmokeOccupancyConfig
 	/** Maximum supported volumes (128 = uint4 bitmask). */
 	static constexpr uint32 MaxVolumes = 128;
 
+	/** Maximum analytic holes of all volumes together (128 = uint4 tile hole mask). */
+	static constexpr uint32 MaxAnalyticHoles = 128;
+
 	/** Thread group size for tile setup (64×1 threads for parallel Bitonic Sort). */
 	static constexpr uint32 TileSetupThreadsX = 64;
 	static constexpr uint32 TileSetupThreadsY = 1;
@@ -55,7 +58,7 @@ struct FIVSmokeOccupancyConfig
 
 /**
  * Per-tile metadata computed in Pass 0.
- * Contains depth range and 128-bit volume mask for sparse iteration.
+ * Contains depth range and 128-bit volume and analytic hole masks for sparse iteration.
  *
  * Memory: 48 bytes (16-byte aligned, cache-friendly)
  */
@@ -85,13 +88,10 @@ struct FIVSmokeTileData
 	uint32 VolumeMask128[4];
 
 	/**
-	 * Maximum distance for light marching from this tile.
-	 * Currently unused - light march uses GlobalAABB per-pixel instead.
+	 * 128-bit mask of the analytic holes whose bounds intersect this tile.
+	 * View samples evaluate only these holes; light samples leave the tile and evaluate all holes of the volume.
 	 */
-	float MaxLightMarchDistance;
-
-	/** Padding for 48-byte alignment. */
-	float Padding[3];
+	uint32 HoleMask128[4];
 };
 
 static_assert(sizeof(FIVSmokeTileData) == 48, "FIVSmokeTileData must be 48 bytes");
@@ -128,6 +128,10 @@ public:
 		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeVolumeGPUData>, VolumeDataBuffer)
 		SHADER_PARAMETER(uint32, NumActiveVolumes)
 
+		// Analytic hole bounds for the tile hole mask (min and max of each hole, interleaved)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float4>, AnalyticHoleBounds)
+		SHADER_PARAMETER(uint32, NumAnalyticHoles)
+
 		// Tile configuration
 		SHADER_PARAMETER(FIntPoint, TileCount)
 		SHADER_PARAMETER(uint32, StepSliceCount)
@@ -163,6 +167,7 @@ public:
 		OutEnvironment.SetDefine(TEXT("TILE_SIZE_Y"), FIVSmokeOccupancyConfig::TileSizeY);
 		OutEnvironment.SetDefine(TEXT("MAX_VOLUMES"), FIVSmokeOccupancyConfig::MaxVolumes);
 		OutEnvironment.SetDefine(TEXT("STEP_DIVISOR"), FIVSmokeOccupancyConfig::StepDivisor);
+		OutEnvironment.SetDefine(TEXT("MAX_ANALYTIC_HOLES"), FIVSmokeOccupancyConfig::MaxAnalyticHoles);
 		// Enable wave intrinsics (supported on SM5 with DX11.3+)
 		OutEnvironment.CompilerFlags.Add(CFLAG_WaveOperations);
 	}
@@ -313,13 +318,21 @@ public:
 		// Packed Voxel Data
 		SHADER_PARAMETER(int, PackedInterval)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture3D, PackedVoxelAtlas)
-		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture3D, PackedHoleAtlas)
 		SHADER_PARAMETER(FIntVector, VoxelTexSize)
 		SHADER_PARAMETER(FIntVector, PackedVoxelTexSize)
 		SHADER_PARAMETER(FIntVector, VoxelAtlasCount)
-		SHADER_PARAMETER(FIntVector, HoleTexSize)
-		SHADER_PARAMETER(FIntVector, PackedHoleTexSize)
-		SHADER_PARAMETER(FIntVector, HoleAtlasCount)
+
+		// Hole Atlases, one per EIVSmokeHoleTextureFormat (see FIVSmokeHoleAtlas)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture3D, PackedHoleAtlas)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture3D, PackedHoleAtlasRGBA8)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture3D<float>, PackedHoleAtlasR8)
+		SHADER_PARAMETER(FVector3f, HoleAtlasTexelSize)
+		SHADER_PARAMETER(FVector3f, HoleAtlasRGBA8TexelSize)
+		SHADER_PARAMETER(FVector3f, HoleAtlasR8TexelSize)
+
+		// Analytic holes (see UIVSmokeHoleGeneratorComponent::AnalyticHoleThreshold) and the preset table they index
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHoleGPU>, AnalyticHoleBuffer)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeHolePresetGPU>, HolePresetBuffer)
 
 		// Scene Textures
 		SHADER_PARAMETER_RDG_UNIFORM_BUFFER(FSceneTextureUniformParameters, SceneTexturesStruct)
@@ -454,13 +467,15 @@ namespace IVSmokeOccupancy
 
 	/**
 	 * Add Pass 0: Tile Setup.
-	 * Computes per-tile depth range and quick volume mask.
+	 * Computes per-tile depth range, quick volume mask and analytic hole mask.
 	 */
 	void AddTileSetupPass(
 		FRDGBuilder& GraphBuilder,
 		const FSceneView& View,
 		FRDGBufferRef VolumeDataBuffer,
 		uint32 NumActiveVolumes,
+		FRDGBufferRef AnalyticHoleBoundsBuffer,
+		uint32 NumAnalyticHoles,
 		FRDGBufferRef OutTileDataBuffer,
 		const FIntPoint& TileCount,
 		uint32 StepSliceCount,
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "IVSmokeCurveAtlas.h"
+#include "IVSmokeHoleAtlas.h"
+#include "IVSmokeHolePresetTable.h"
 #include "ScreenPass.h"
 #include "SceneTexturesConfig.h"
 #include "IVSmokeShaders.h"
@@ -60,13 +63,8 @@ struct IVSMOKE_API FIVSmokePackedRenderData
 	/** Per-volume GPU metadata */
 	TArray<FIVSmokeVolumeGPUData> VolumeDataArray;
 
-	/** Hole Texture references (RHI resources are thread-safe) */
-	TArray<FTextureRHIRef> HoleTextures;
-	TArray<FIntVector> HoleTextureSizes;
-
 	/** Common resolution info */
 	FIntVector VoxelResolution = FIntVector::ZeroValue;
-	FIntVector HoleResolution = FIntVector::ZeroValue;
 	int32 VolumeCount = 0;
 
 	/** Preset parameters (copied from default preset) */
@@ -122,6 +120,24 @@ struct IVSMOKE_API FIVSmokePackedRenderData
 	/** Game World Time */
 	float GameTime = 0.0f;
 
+	/** Baked fade curves referenced by FIVSmokeVolumeGPUData::FadeInCurveRow / FadeOutCurveRow */
+	TSharedPtr<const FIVSmokeCurveAtlasSnapshot, ESPMode::ThreadSafe> CurveAtlas;
+
+	/** Hole atlas layouts referenced by FIVSmokeVolumeGPUData::HoleUVMin / HoleUVMax / HoleFormat */
+	TSharedPtr<const FIVSmokeHoleAtlasSnapshot, ESPMode::ThreadSafe> HoleAtlas;
+
+	/** Holes evaluated by the ray march, referenced by FIVSmokeVolumeGPUData::AnalyticHoleMask. Holds a zeroed dummy if there are none */
+	TArray<FIVSmokeHoleGPU> AnalyticHoles;
+
+	/** World bounds minimum and maximum of each analytic hole, interleaved, for the tile hole mask */
+	TArray<FVector4f> AnalyticHoleBounds;
+
+	/** Number of analytic holes, excluding the dummy */
+	uint32 NumAnalyticHoles = 0;
+
+	/** Preset table the analytic holes index into */
+	TSharedPtr<const FIVSmokeHolePresetSnapshot, ESPMode::ThreadSafe> HolePresets;
+
 	/** Rendering Info */
 	UMaterialInterface* SmokeVisualMaterial = nullptr;
 
@@ -131,10 +147,14 @@ struct IVSMOKE_API FIVSmokePackedRenderData
 		PackedVoxelBirthTimes.Empty();
 		PackedVoxelDeathTimes.Empty();
 		VolumeDataArray.Empty();
-		HoleTextures.Empty();
-		HoleTextureSizes.Empty();
 		VolumeCount = 0;
 		bIsValid = false;
+		CurveAtlas.Reset();
+		HoleAtlas.Reset();
+		AnalyticHoles.Empty();
+		AnalyticHoleBounds.Empty();
+		NumAnalyticHoles = 0;
+		HolePresets.Reset();
 
 		// CSM
 		NumCascades = 0;
@@ -521,6 +541,7 @@ private:
 	int64 CachedNoiseVolumeSize = 0;
 	int64 CachedCSMSize = 0;
 	int64 CachedPerFrameSize = 0;
+	int64 CachedHoleAtlasSize = 0;
 
 	/** Update stats if 1 second has passed since last update. */
 	void UpdateStatsIfNeeded(const FIVSmokePackedRenderData& RenderData, const FIntPoint& ViewportSize);
@@ -529,8 +550,7 @@ private:
 	int64 CalculatePerFrameTextureSize(
 		const FIntPoint& ViewportSize,
 		int32 VolumeCount,
-		const FIntVector& VoxelResolution,
-		const FIntVector& HoleResolution
+		const FIntVector& VoxelResolution
 	) const;
 
 	/** Update all stat values. */
@@ -92,6 +92,7 @@ enum class EIVSmokeExternalShadowQuality : uint8
 	Custom UMETA(DisplayName = "Custom")
 };
 
+class UIVSmokeHolePreset;
 class UIVSmokeVisualMaterialPreset;
 /**
  * Global settings for IVSmoke plugin.
@@ -389,6 +390,33 @@ public:
 		meta = (ClampMin = "0.0", ClampMax = "100.0", EditCondition = "bShowAdvancedOptions && bEnableDepthWrite", EditConditionHides))
 	float DepthWriteBias = 50.0f;
 
+	//~==============================================================================
+	// Gameplay Queries
+
+	/**
+	 * Distance in centimeters a sight line must travel through active voxels to count as blocked.
+	 * Used by UIVSmokeSightQuerySubsystem::IsSightBlockedBySmoke.
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "IVSmoke | Gameplay", meta = (ClampMin = "0.0", UIMax = "1000.0"))
+	float SightBlockingSmokeDistance = 150.0f;
+
+	/** If true, sight queries ignore voxels carved out by active holes (bullets, explosions, dynamic objects). */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "IVSmoke | Gameplay")
+	bool bSightQueryAccountForHoles = true;
+
+	//~==============================================================================
+	// Holes
+
+	/**
+	 * Hole presets replicated by ID. A preset's ID is its position in this list plus one,
+	 * so server and clients agree on it as long as they share this config.
+	 * Presets missing from the list get an ID above it hashed from their path, which only depends on load order
+	 * if two unlisted presets hash to the same ID.
+	 * Changes apply on the next launch.
+	 */
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "IVSmoke | Holes")
+	TArray<TSoftObjectPtr<UIVSmokeHolePreset>> HolePresets;
+
 	//~==============================================================================
 	// Debug
 
@@ -51,7 +51,26 @@ struct FIVSmokeVolumeGPUData
 	FVector3f VoxelWorldAABBMax;	// 12 bytes
 	float FadeOutDuration;			// 4 bytes
 
-	float Reserved[4];              // 16 bytes (future use / alignment)
+	/** Synced time relative to the hole texture time base. */
+	float HoleTime;					// 4 bytes
+	/** EIVSmokeHoleTextureEncoding of the hole texture. */
+	uint32 HoleEncoding;			// 4 bytes
+
+	/** FIVSmokeCurveAtlas row of the voxel fade-in. */
+	uint32 FadeInCurveRow;			// 4 bytes
+	/** FIVSmokeCurveAtlas row of the voxel fade-out. */
+	uint32 FadeOutCurveRow;			// 4 bytes
+
+	/** Hole atlas UV range of the volume's slot (see FIVSmokeHoleAtlas). */
+	FVector3f HoleUVMin;			// 12 bytes
+	/** EIVSmokeHoleTextureFormat of the slot, or FIVSmokeHoleAtlas::NoSlotFormat. */
+	uint32 HoleFormat;				// 4 bytes
+	FVector3f HoleUVMax;			// 12 bytes
+	/** Distortion offset stored as 1 by the RGBA8 format. */
+	float HoleDistortionRange;		// 4 bytes
+
+	/** Bits of the analytic holes of this volume in the ray march hole buffer (see UIVSmokeHoleGeneratorComponent::GetAnalyticHoles). */
+	uint32 AnalyticHoleMask[4];		// 16 bytes
 };
 
 // Ensure structure is 256 bytes for efficient GPU access
@@ -114,6 +133,8 @@ public:
 		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float>, DeathTimes)
 		/** Per-volume GPU metadata (transform, bounds, etc.). */
 		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FIVSmokeVolumeGPUData>, VolumeDataBuffer)
+		/** Baked fade curves (see FIVSmokeCurveAtlas). */
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<float>, CurveAtlas)
 
 		/** Total atlas texture size. */
 		SHADER_PARAMETER(FIntVector, TexSize)
@@ -0,0 +1,137 @@
+// Copyright (c) 2026, Team SDB. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "IVSmokeHoleOccupancy.h"
+#include "IVSmokeSightQuerySubsystem.generated.h"
+
+/**
+ * A single line-of-sight query segment.
+ */
+USTRUCT(BlueprintType)
+struct IVSMOKE_API FIVSmokeSightQuery
+{
+	GENERATED_BODY()
+
+	/** World position of the observer. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke")
+	FVector Start = FVector::ZeroVector;
+
+	/** World position of the target. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke")
+	FVector End = FVector::ZeroVector;
+};
+
+/**
+ * Result of a line-of-sight query.
+ */
+USTRUCT(BlueprintType)
+struct IVSMOKE_API FIVSmokeSightQueryResult
+{
+	GENERATED_BODY()
+
+	/** True if the segment travels through at least `SightBlockingSmokeDistance` of smoke. */
+	UPROPERTY(BlueprintReadOnly, Category = "IVSmoke")
+	bool bBlocked = false;
+
+	/**
+	 * World distance (cm) the segment travels through active voxels, summed over all volumes.
+	 * When the query stops at the blocking distance, this is a lower bound.
+	 */
+	UPROPERTY(BlueprintReadOnly, Category = "IVSmoke")
+	float OpticalDepth = 0.0f;
+};
+
+/**
+ * Physics-free smoke visibility queries for AI perception and gameplay.
+ *
+ * ## Overview
+ * Answers line-of-sight queries directly against every volume's `VoxelBits` instead of tracing
+ * against the boxes of `UIVSmokeCollisionComponent`. Each query performs a broadphase against the
+ * voxel AABB of every active volume and then walks the grid with a 3D DDA, accumulating the distance
+ * travelled through active voxels.
+ *
+ * Batched queries run in parallel with `ParallelFor`.
+ *
+ * ## Snapshot
+ * Volume data is copied into an internal snapshot at most once per frame, on the first query of that frame.
+ * Queries are therefore stable within a frame and never touch the chaos scene or the collision rebuild.
+ * If `bSightQueryAccountForHoles` is enabled, voxels carved by active holes are cleared from the snapshot
+ * with `FIVSmokeHoleOccupancy`, so the DDA itself never evaluates holes.
+ *
+ * @note Game thread only.
+ */
+UCLASS()
+class IVSMOKE_API UIVSmokeSightQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Returns true if the segment is blocked by smoke.
+	 * Stops walking the grid as soon as the blocking distance is reached.
+	 *
+	 * @param Start		World position of the observer.
+	 * @param End		World position of the target.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Query")
+	bool IsSightBlockedBySmoke(const FVector& Start, const FVector& End);
+
+	/**
+	 * Returns the world distance (cm) the segment travels through smoke.
+	 *
+	 * @param Start		World position of the observer.
+	 * @param End		World position of the target.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Query")
+	float GetOpticalDepth(const FVector& Start, const FVector& End);
+
+	/**
+	 * Evaluates many segments in parallel.
+	 *
+	 * @param Queries			Segments to evaluate.
+	 * @param OutResults		Receives one result per query, in the same order.
+	 * @param bStopAtBlocking	If true, each query stops once the blocking distance is reached (cheaper, `OpticalDepth` becomes a lower bound).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "IVSmoke | Query")
+	void BatchQuerySight(const TArray<FIVSmokeSightQuery>& Queries, TArray<FIVSmokeSightQueryResult>& OutResults, bool bStopAtBlocking = true);
+
+	/** Forces the volume snapshot to be rebuilt on the next query. */
+	void InvalidateSnapshot() { SnapshotFrame = MAX_uint64; }
+
+private:
+	/** Per-frame copy of the data needed to trace a single volume. */
+	struct FVolumeSnapshot
+	{
+		FTransform ActorTransform;
+		FBox WorldBounds;
+		FIntVector GridResolution;
+		FVector GridOrigin;
+		float VoxelSize;
+		TArray<uint64> VoxelBits;
+	};
+
+	/** Rebuilds the snapshot if it is older than the current frame. */
+	void RefreshSnapshot();
+
+	/**
+	 * Accumulates the smoke distance along a segment over all volumes.
+	 *
+	 * @param StopDistance		Returns as soon as the accumulated distance reaches this value.
+	 */
+	float QuerySegment(const FVector& Start, const FVector& End, float StopDistance) const;
+
+	/** 3D DDA through a single volume. Returns the normalized segment parameter length spent inside active voxels. */
+	static float TraceVolume(const FVolumeSnapshot& Volume, const FVector& Start, const FVector& End, float StopParam);
+
+	/** Snapshot of all active volumes. */
+	TArray<FVolumeSnapshot> Volumes;
+
+	/** Scratch hole occupancy reused for every volume while taking the snapshot. */
+	FIVSmokeHoleOccupancy HoleOccupancy;
+
+	/** Frame number the snapshot was taken on. */
+	uint64 SnapshotFrame = MAX_uint64;
+};
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "Curves/CurveFloat.h"
 #include "GameFramework/Actor.h"
+#include "IVSmokeBitGrid.h"
+#include "IVSmokeCurveAtlas.h"
 #include "IVSmokeGridLibrary.h"
 #include "RHI.h"
 #include "RHIResources.h"
@@ -393,6 +395,24 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Simulation")
 	TObjectPtr<UCurveFloat> DissipationCurve;
 
+	/**
+	 * Defines the density of a voxel over `FadeInDuration` after it spawned.
+	 * - X-axis (Time): 0.0 to 1.0 (Normalized Duration)
+	 * - Y-axis (Value): 0.0 to 1.0 (Density)
+	 * If not set, the density follows sqrt(Time).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Simulation")
+	TObjectPtr<UCurveFloat> FadeInCurve;
+
+	/**
+	 * Defines the density of a voxel over `FadeOutDuration` after it was removed.
+	 * - X-axis (Time): 0.0 to 1.0 (Normalized Duration)
+	 * - Y-axis (Value): 1.0 to 0.0 (Density)
+	 * If not set, the density follows 1 - sqrt(Time).
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Simulation")
+	TObjectPtr<UCurveFloat> FadeOutCurve;
+
 	/**
 	 * If true, voxels perform collision checks against the world before spawning.
 	 * Disable this to allow smoke to pass through walls, significantly reducing CPU cost.
@@ -404,6 +424,17 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Simulation", meta = (EditCondition = "bEnableSimulationCollision", AdvancedDisplay))
 	TEnumAsByte<ECollisionChannel> VoxelCollisionChannel = ECC_WorldStatic;
 
+	/**
+	 * While no player is within this distance of the volume bounds, the volume replicates at `DistantNetUpdateFrequency`.
+	 * State transitions are still sent immediately. Set to 0 to always use the actor's net update frequency.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Network", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "50000.0"))
+	float DistantNetUpdateDistance = 10000.0f;
+
+	/** Net update frequency (Hz) used while no player is within `DistantNetUpdateDistance`. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IVSmoke | Network", meta = (ClampMin = "0.1", UIMin = "0.5", UIMax = "10.0"))
+	float DistantNetUpdateFrequency = 2.0f;
+
 private:
 	/** Internal node structure for the Dijkstra-based flood fill algorithm. */
 	struct FIVSmokeVoxelNode
@@ -422,14 +453,14 @@ private:
 	};
 
 	/**
-	 * Helper to sample a curve or return linear alpha if no curve is provided.
+	 * Helper to sample a baked curve row. See BakeCurves().
 	 *
 	 * @param ElapsedTime	Current time elapsed in the phase.
 	 * @param Duration		Total duration of the phase.
-	 * @param Curve			Optional curve to sample. If null, returns linear interpolation (ElapsedTime / Duration).
+	 * @param CurveRow		FIVSmokeCurveAtlas row to sample. The linear row returns ElapsedTime / Duration.
 	 * @return				Clamped float value between 0.0 and 1.0.
 	 */
-	FORCEINLINE static float GetCurveValue(float ElapsedTime, float Duration, const UCurveFloat* Curve)
+	FORCEINLINE static float GetCurveValue(float ElapsedTime, float Duration, int32 CurveRow)
 	{
 		if (Duration <= KINDA_SMALL_NUMBER)
 		{
@@ -438,18 +469,43 @@ private:
 
 		float Alpha = FMath::Clamp(ElapsedTime / Duration, 0.0f, 1.0f);
 
-		if (Curve)
-		{
-			return FMath::Clamp(Curve->GetFloatValue(Alpha), 0.0f, 1.0f);
-		}
-
-		return Alpha;
+		return FMath::Clamp(FIVSmokeCurveAtlas::Get().Evaluate(CurveRow, Alpha), 0.0f, 1.0f);
 	}
 
+	/**
+	 * Bakes the simulation and fade curves into FIVSmokeCurveAtlas and caches their rows.
+	 * Called on BeginPlay, when expansion starts and when a curve is edited.
+	 */
+	void BakeCurves();
+
+	/** FIVSmokeCurveAtlas row of `ExpansionCurve`. */
+	int32 ExpansionCurveRow = FIVSmokeCurveAtlas::LinearRow;
+
+	/** FIVSmokeCurveAtlas row of `DissipationCurve`. */
+	int32 DissipationCurveRow = FIVSmokeCurveAtlas::LinearRow;
+
+	/** FIVSmokeCurveAtlas row of `FadeInCurve`. */
+	int32 FadeInCurveRow = FIVSmokeCurveAtlas::SquareRootRow;
+
+	/** FIVSmokeCurveAtlas row of `FadeOutCurve`. */
+	int32 FadeOutCurveRow = FIVSmokeCurveAtlas::InverseSquareRootRow;
+
 	/** Handles network replication of the simulation state. */
 	UFUNCTION()
 	void OnRep_ServerState();
 
+	/**
+	 * Switches between the configured and the distant net update frequency by the distance of the closest player view.
+	 * Runs on a timer on the server.
+	 */
+	void UpdateNetUpdateFrequency();
+
+	/** Timer driving `UpdateNetUpdateFrequency`. */
+	FTimerHandle NetUpdateFrequencyTimerHandle;
+
+	/** Net update frequency configured on the actor, used while a player is nearby. */
+	float NearNetUpdateFrequency = 0.0f;
+
 	/**
 	 * Main state machine handler.
 	 * Transitions the local simulation logic to the new state (e.g., resets heaps, clears data).
@@ -539,6 +595,12 @@ private:
 	 */
 	void SetVoxelDeathTime(int32 Index, float DeathTime);
 
+	/**
+	 * Grows the world voxel AABB to the grid bounds of `VoxelBits` if voxels were born since the last call.
+	 * Bounds are computed once per update from whole rows instead of per spawned voxel.
+	 */
+	void UpdateVoxelWorldAABB();
+
 	/** Replicated state synchronized from the server. */
 	UPROPERTY(ReplicatedUsing = OnRep_ServerState)
 	FIVSmokeServerState ServerState;
@@ -567,6 +629,9 @@ private:
 	/** World-space bounding box maximum of all active voxels. */
 	FVector VoxelWorldAABBMax = FVector(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 
+	/** True if voxels were born since the last `UpdateVoxelWorldAABB()`. */
+	bool bVoxelBoundsDirty = false;
+
 	/** Timestamp when each voxel was spawned. */
 	TArray<float> VoxelBirthTimes;
 
@@ -659,12 +724,24 @@ public:
 	 */
 	FORCEINLINE void ClearVoxelDataDirty() { DirtyLevel = EIVSmokeDirtyLevel::Clean; }
 
+	/**
+	 * Returns the bit-packed active voxel buffer (uint64 per YZ row, X mapped to the bit index).
+	 * @see VoxelBits for the data layout.
+	 */
+	FORCEINLINE const TArray<uint64>& GetVoxelBits() const { return VoxelBits; }
+
 	/** Returns the current buffer size (for detecting resize). */
 	FORCEINLINE int32 GetVoxelBufferSize() const { return VoxelBirthTimes.Num(); }
 
 	/** Returns the number of active (non-zero density) voxels. */
 	FORCEINLINE int32 GetActiveVoxelNum() const { return ActiveVoxelNum; }
 
+	/** Returns the FIVSmokeCurveAtlas row of the voxel fade-in. */
+	FORCEINLINE int32 GetFadeInCurveRow() const { return FadeInCurveRow; }
+
+	/** Returns the FIVSmokeCurveAtlas row of the voxel fade-out. */
+	FORCEINLINE int32 GetFadeOutCurveRow() const { return FadeOutCurveRow; }
+
 	/** Returns the smoke preset override for this volume, or nullptr to use default. */
 	FORCEINLINE const UIVSmokeSmokePreset* GetSmokePresetOverride() const { return SmokePresetOverride; }
 
@@ -694,12 +771,9 @@ public:
 	 */
 	FORCEINLINE bool IsVoxelActive(FIntVector GridPos) const
 	{
-		return UIVSmokeGridLibrary::IsVoxelBitSet(VoxelBits, GridPos, GetGridResolution());
+		return FIVSmokeBitGrid::IsBitSet(VoxelBits, GridPos, GetGridResolution().Y);
 	}
 
-	/** Returns the RHI texture resource from the HoleGeneratorComponent, if available. */
-	FTextureRHIRef GetHoleTexture() const;
-
 	/**
 	 * Returns the synchronized world time in seconds.
 	 * Handles network time offsets to ensure clients see the simulation at the same progress as the server.
@@ -761,6 +835,12 @@ private:
 	/** Calculates a CRC32 checksum of the current voxel state to verify deterministic sync between Server and Client. */
 	uint32 CalculateSimulationChecksum() const;
 
+#if WITH_EDITOR
+	/** Scratch grids of the wireframe debug view, reused across frames. */
+	mutable TArray<uint64> DebugVisibleBits;
+	mutable TArray<uint64> DebugSurfaceBits;
+#endif
+
 	/** Internal flag to track if the actor is currently running an editor-only preview simulation. */
 	bool bIsEditorPreviewing = false;
 #pragma endregion